@@ -10,6 +10,8 @@
  * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
  **********************************************************************/
 
+#include <algorithm> //For std::sort
+
 #include "ID3EventTimingFrame.hpp" //For the class definition
 #include "../ID3.hpp"              //For EventTimingCode
 #include "../ID3Functions.hpp"     //For intToByteArray() and byteIntVal()
@@ -101,6 +103,31 @@ void EventTimingFrame::writeBody() {
 	}
 }
 
+///@pkg ID3EventTimingFrame.h
+std::vector<std::pair<TimingCodes, ulong>> EventTimingFrame::events() const {
+	std::vector<std::pair<TimingCodes, ulong>> codes;
+	codes.reserve(map.size());
+	for(const auto& eventCodePair : map)
+		codes.emplace_back(static_cast<TimingCodes>(eventCodePair.first), eventCodePair.second);
+	
+	//Sort the codes, as the map isn't sorted
+	std::sort(codes.begin(), codes.end());
+	return codes;
+}
+
+///@pkg ID3EventTimingFrame.h
+void EventTimingFrame::hashContent(ByteHasher& hasher) const noexcept {
+	hasher.update(static_cast<uint64_t>(timeStampFormat));
+	
+	//Add the codes in order, as the map isn't sorted
+	for(ushort code = 0; code <= 0xFF; code++) {
+		const auto eventCodePair = map.find(code);
+		if(eventCodePair == map.end()) continue;
+		hasher.update(static_cast<uint64_t>(eventCodePair->first));
+		hasher.update(static_cast<uint64_t>(eventCodePair->second));
+	}
+}
+
 ///@pkg ID3EventTimingFrame.h
 void EventTimingFrame::read() {
 	const ushort HEADER_SIZE = headerSize();
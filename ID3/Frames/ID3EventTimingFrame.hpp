@@ -14,6 +14,8 @@
 #define ID3_EVENT_TIMING_FRAME_HPP
 
 #include <unordered_map> //For std::unordered_map
+#include <vector>        //For std::vector
+#include <utility>       //For std::pair
 
 #include "ID3Frame.hpp" //For the Frame base class definition
 
@@ -173,6 +175,14 @@ namespace ID3 {
 			 */
 			void value(const TimingCodes timingCode, const ulong time);
 			
+			/**
+			 * Get every event timing code that is set, including the ones with
+			 * a time of 0, which value() can't tell apart from unset codes.
+			 * 
+			 * @return The timing codes and their times, ordered by timing code.
+			 */
+			std::vector<std::pair<TimingCodes, ulong>> events() const;
+			
 			/**
 			 * Clear the timing codes.
 			 */
@@ -230,6 +240,14 @@ namespace ID3 {
 			 */
 			virtual void writeBody();
 			
+			/**
+			 * The hashContent() method for EventTimingFrame adds the time stamp
+			 * format and the event timing codes.
+			 * 
+			 * @see ID3::Frame::hashContent()
+			 */
+			virtual void hashContent(ByteHasher& hasher) const noexcept;
+			
 			/** @see ID3::Frame::requiredSize() */
 			virtual inline ulong requiredSize() { return headerSize() + 1 + (map.size() * (1 + TIME_BYTE_LENGTH)); }
 			
@@ -13,9 +13,9 @@
 #include <sstream>  //For StringStream
 
 #include "ID3Frame.hpp" //For the class definitions
-#include "../ID3Functions.hpp" //For intToByteArray
+#include "../ID3Functions.hpp" //For intToByteArray, resynchronise, and EncodedSizes
 #include "../ID3Constants.hpp" //For HEADER_BYTE_SIZE, WRITE_VERSION, and MAX_TAG_SIZE
-#include "../ID3Exception.hpp" //For FrameSizeException
+#include "../ID3Exception.hpp" //For FrameSizeException and Exception
 
 using namespace ID3;
 
@@ -30,7 +30,14 @@ Frame::Frame(const FrameID& frameName) noexcept : id(frameName),
                                                   ID3Ver(WRITE_VERSION),
                                                   isNull(id == Frames::FRAME_UNKNOWN_FRAME),
                                                   isEdited(false),
-                                                  isFromFile(false) {}
+                                                  isFromFile(false),
+                                                  isCompacted(false),
+                                                  compactedSize(0),
+                                                  releasedSize(0),
+                                                  filePosition(0),
+                                                  readSize(0),
+                                                  encodingPolicy(EncodingPolicy::UTF8),
+                                                  fileEncoding(ENCODING_UTF8) {}
 
 ///@pkg ID3Frame.h
 Frame::Frame(const FrameID&   frameName,
@@ -40,7 +47,14 @@ Frame::Frame(const FrameID&   frameName,
                                             frameContent(frameBytes),
                                             isNull(frameBytes.size() <= HEADER_BYTE_SIZE),
                                             isEdited(false),
-                                            isFromFile(true) {
+                                            isFromFile(true),
+                                            isCompacted(false),
+                                            compactedSize(0),
+                                            releasedSize(0),
+                                            filePosition(0),
+                                            readSize(frameBytes.size()),
+                                            encodingPolicy(EncodingPolicy::UTF8),
+                                            fileEncoding(ENCODING_UTF8) {
 	if(!isNull && (flag(FrameFlag::COMPRESSED) || flag(FrameFlag::ENCRYPTED)))
 		isNull = true;
 	else
@@ -60,14 +74,14 @@ Frame::operator FrameClass() const noexcept { return type(); }
 bool Frame::operator==(bool boolean) const noexcept { return boolean == isNull; }
 
 ///@pkg ID3Frame.h
-Frame::operator ByteArray() const noexcept { return frameContent; }
+Frame::operator ByteArray() const noexcept { return bytes(); }
 
 ///@pkg ID3Frame.h
 bool Frame::null() const { return isNull; }
 
 ///@pkg ID3Frame.h
 ulong Frame::size(bool header) const {
-	const ulong FRAME_SIZE  = frameContent.size();
+	const ulong FRAME_SIZE  = isCompacted ? compactedSize : frameContent.size() + releasedSize;
 	const ulong HEADER_SIZE = headerSize();
 	
 	if(header)
@@ -81,14 +95,55 @@ FrameID Frame::frame() const { return id; }
 
 ///@pkg ID3Frame.h
 ByteArray Frame::bytes(bool header) const noexcept {
-	if(!header) return frameContent;
-	const ushort HEADER_SIZE = headerSize();
+	const ushort HEADER_SIZE = header ? headerSize() : 0;
 	if(frameContent.size() < HEADER_SIZE) return ByteArray();
-	return ByteArray(frameContent.begin() + HEADER_SIZE, frameContent.end());
+	ByteArray content(frameContent.begin() + HEADER_SIZE, frameContent.end());
+	if(releasedSize > 0) appendReleased(content);
+	return content;
+}
+
+///@pkg ID3Frame.h
+uint64_t Frame::fingerprint() const noexcept {
+	ByteHasher hasher;
+	hasher.update(static_cast<const std::string&>(id));
+	hasher.update(static_cast<uint64_t>(isNull));
+	if(!isNull) hashContent(hasher);
+	return hasher.digest();
+}
+
+///@pkg ID3Frame.h
+void Frame::revert() {
+	//There's nothing to read the frame content from if the Frame is compacted,
+	//and an unedited compacted Frame has nothing to revert
+	if(isCompacted) {
+		if(!isEdited) return;
+		throw Exception("Cannot revert an edited compacted frame, as its bytes have been dropped. Use Tag::revert() instead.");
+	}
+	read();
+	isEdited = false;
+}
+
+///@pkg ID3Frame.h
+void Frame::compact() {
+	if(isCompacted || isNull) return;
+	
+	//Frames without a body have nothing to drop
+	const ushort HEADER_SIZE = headerSize();
+	if(frameContent.size() <= HEADER_SIZE) return;
+	
+	//Only keep the header, as the flags and grouping identity are read from it
+	compactedSize = frameContent.size() + releasedSize;
+	releasedSize = 0;
+	frameContent.resize(HEADER_SIZE);
+	frameContent.shrink_to_fit();
+	isCompacted = true;
 }
 
 ///@pkg ID3Frame.h
-void Frame::revert() { read(); isEdited = false; }
+void Frame::appendReleased(ByteArray&) const noexcept {}
+
+///@pkg ID3Frame.h
+bool Frame::compacted() const { return isCompacted; }
 
 ///@pkg ID3Frame.h
 bool Frame::edited() const { return isEdited; }
@@ -99,7 +154,7 @@ bool Frame::createdFromFile() const { return isFromFile; }
 ///@pkg ID3Frame.h
 bool Frame::flag(const FrameFlag flag) const {
 	//Verify that the frame is valid
-	if(frameContent.size() < HEADER_BYTE_SIZE || ID3Ver <= 3)
+	if(frameContent.size() < HEADER_BYTE_SIZE || ID3Ver < 3)
 		return false;
 	
 	const bool V4 = ID3Ver >= 4;
@@ -119,20 +174,20 @@ bool Frame::flag(const FrameFlag flag) const {
 	             ((frameContent[8] & FLAG1_READ_ONLY_V3) == FLAG1_READ_ONLY_V3);
 	   case FrameFlag::COMPRESSED:
 			return V4 ?
-			       ((frameContent[8] & FLAG2_COMPRESSED_V4) == FLAG2_COMPRESSED_V4) :
-	             ((frameContent[8] & FLAG2_COMPRESSED_V3) == FLAG2_COMPRESSED_V3);
+			       ((frameContent[9] & FLAG2_COMPRESSED_V4) == FLAG2_COMPRESSED_V4) :
+	             ((frameContent[9] & FLAG2_COMPRESSED_V3) == FLAG2_COMPRESSED_V3);
 	   case FrameFlag::ENCRYPTED:
 			return V4 ?
-			       ((frameContent[8] & FLAG2_ENCRYPTED_V4) == FLAG2_ENCRYPTED_V4) :
-	             ((frameContent[8] & FLAG2_ENCRYPTED_V3) == FLAG2_ENCRYPTED_V3);
+			       ((frameContent[9] & FLAG2_ENCRYPTED_V4) == FLAG2_ENCRYPTED_V4) :
+	             ((frameContent[9] & FLAG2_ENCRYPTED_V3) == FLAG2_ENCRYPTED_V3);
 	   case FrameFlag::GROUPING_IDENTITY:
 			return V4 ?
-			       ((frameContent[8] & FLAG2_GROUPING_IDENTITY_V4) == FLAG2_GROUPING_IDENTITY_V4) :
-	             ((frameContent[8] & FLAG2_GROUPING_IDENTITY_V3) == FLAG2_GROUPING_IDENTITY_V3);
+			       ((frameContent[9] & FLAG2_GROUPING_IDENTITY_V4) == FLAG2_GROUPING_IDENTITY_V4) :
+	             ((frameContent[9] & FLAG2_GROUPING_IDENTITY_V3) == FLAG2_GROUPING_IDENTITY_V3);
 	   case FrameFlag::UNSYNCHRONISED:
-			return V4 ? ((frameContent[8] & FLAG2_UNSYNCHRONISED_V4) == FLAG2_UNSYNCHRONISED_V4) : false;
+			return V4 ? ((frameContent[9] & FLAG2_UNSYNCHRONISED_V4) == FLAG2_UNSYNCHRONISED_V4) : false;
 	   case FrameFlag::DATA_LENGTH_INDICATOR:
-			return V4 ? ((frameContent[8] & FLAG2_DATA_LENGTH_INDICATOR_V4) == FLAG2_DATA_LENGTH_INDICATOR_V4) : false;
+			return V4 ? ((frameContent[9] & FLAG2_DATA_LENGTH_INDICATOR_V4) == FLAG2_DATA_LENGTH_INDICATOR_V4) : false;
 		default:
 			return false;
 	}
@@ -198,7 +253,9 @@ std::string Frame::print() const {
 	out << "\nEmpty:          " << std::boolalpha << empty() << '\n';
 	out << "Body size:      " << std::dec << BODY_SIZE << '\n';
 	out << "Body bytes:    ";
-	if(BODY_SIZE <= 100) {
+	if(isCompacted) {
+		out << " (compacted)";
+	} else if(BODY_SIZE <= 100) {
 		for(ulong i = HEADER_SIZE; i < FRAME_SIZE; i++)
 			out << std::hex << ' ' << static_cast<short>(frameContent[i]);
 	} else {
@@ -216,29 +273,8 @@ ByteArray Frame::write() {
 	const bool GROUPING_IDENTITY = flag(FrameFlag::GROUPING_IDENTITY);
 	const uint8_t GROUP_IDENTITY = groupIdentity();
 	
-	//Some frames have the Discard Upon Audio Alter flag set by default
-	bool discardUponAudioAlter;
-	switch(id) {
-		case FRAME_AUDIO_ENCRYPTION:
-		case FRAME_AUDIO_SEEK_POINT_INDEX:
-		case FRAME_EVENT_TIMING_CODES:
-		case FRAME_EQUALISATION:
-		case FRAME_EQUALISATION_2:
-		case FRAME_MPEG_LOCATION_LOOKUP_TABLE:
-		case FRAME_POSITION_SYNCHRONISATION:
-		case FRAME_SEEK:
-		case FRAME_SYNCHRONISED_LYRICS:
-		case FRAME_SYNCHRONISED_TEMPO_CODES:
-		case FRAME_RELATIVE_VOLUME_ADJUSTMENT:
-		case FRAME_RELATIVE_VOLUME_ADJUSTMENT_2:
-		case FRAME_ENCODED_BY:
-		case FRAME_LENGTH:
-		case FRAME_SIZE: {
-			discardUponAudioAlter = true; break;
-		} default: {
-			discardUponAudioAlter = false;
-		}
-	}
+	//Some frames have flags set by default, such as Discard Upon Audio Alter
+	const uint8_t DEFAULT_FLAGS1 = id.metadata().flags1;
 	
 	//The new header size has to fit the grouping identity if necessary
 	const ushort HEADER_SIZE = HEADER_BYTE_SIZE + (GROUPING_IDENTITY ? 1 : 0);
@@ -246,6 +282,10 @@ ByteArray Frame::write() {
 	//Set the ID3 version to ID3::WRITE_VERSION
 	ID3Ver = WRITE_VERSION;
 	
+	//The frame content is rebuilt below, so it's no longer compacted
+	isCompacted = false;
+	releasedSize = 0;
+	
 	if(isNull || empty()) {
 		//If null or empty, clear the frame
 		frameContent = ByteArray();
@@ -261,9 +301,8 @@ ByteArray Frame::write() {
 		for(ushort i = 0; i < 4 && i < id.size(); i++)
 			frameContent[i] = id[i];
 		
-		//Save the discard upon audio alter flag
-		if(discardUponAudioAlter)
-			frameContent[9] = FLAG1_DISCARD_UPON_AUDIO_ALTER_V4;
+		//Save the default status flags
+		frameContent[8] = DEFAULT_FLAGS1;
 		
 		//Save the grouping identity
 		if(GROUPING_IDENTITY) {
@@ -294,27 +333,35 @@ void Frame::unsynchronise() {
 	if(!flag(FrameFlag::UNSYNCHRONISED))
 		return;
 	
-	//The current frame size
-	const ulong FRAME_SIZE = frameContent.size();
+	//Everything after the standard header has been unsynchronised, including
+	//the extra header bytes added by the frame flags
+	resynchronise(frameContent, HEADER_BYTE_SIZE);
 	
-	//The new byte vector
-	ByteArray newFrameContent;
-	
-	//Reserve space in the new vector to prevent internal array re-allocations
-	newFrameContent.reserve(FRAME_SIZE);
+	//The frame is no longer unsynchronised, so clear the flag and save the
+	//decoded frame size
+	frameContent[9] &= ~FLAG2_UNSYNCHRONISED_V4;
+	ByteArray size = intToByteArray(frameContent.size() - HEADER_BYTE_SIZE, 4, true);
+	for(ushort i = 0; i < 4; i++)
+		frameContent[i+4] = size[i];
+}
+
+///@pkg ID3Frame.h
+uint8_t Frame::writeEncoding(const EncodedSizes& sizes) const {
+	//Keep the encoding from file, unless the text no longer fits in LATIN-1
+	if(encodingPolicy == EncodingPolicy::PRESERVE && isFromFile && fileEncoding <= ENCODING_UTF8 &&
+	   (fileEncoding != ENCODING_LATIN1 || sizes.fitsLatin1))
+		return fileEncoding;
 	
-	//Loop through the frame bytes, starting after the standard header
-	for(ulong i = HEADER_BYTE_SIZE; i + 2 < FRAME_SIZE; i++) {
-		newFrameContent.push_back(frameContent[i]);
-		
-		//If the byte pattern 0b11111111 0b00000000 0b111XXXXX is found, then the
-		//0 byte has been inserted to prevent false synchronisations and should
-		//be skipped over.
-		if(frameContent[i] == 0xFF && frameContent[i+1] == '\0' && frameContent[i+2] > 0xE0)
-			i++;
+	//LATIN-1 is never bigger than UTF-8 or UTF-16, and UTF-16 is only smaller
+	//than UTF-8 when most characters are above U+07FF, such as CJK text
+	if(encodingPolicy == EncodingPolicy::SMALLEST) {
+		if(sizes.fitsLatin1)         return ENCODING_LATIN1;
+		if(sizes.utf16 < sizes.utf8) return ENCODING_UTF16;
+		return ENCODING_UTF8;
 	}
 	
-	frameContent = newFrameContent;
+	//Pure ASCII is identical in LATIN-1, which is readable by more software
+	return sizes.ascii ? ENCODING_LATIN1 : ENCODING_UTF8;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -390,8 +437,30 @@ ByteArray UnknownFrame::write() {
 	return frameContent;
 }
 
+///@pkg ID3Frame.h
+const uint8_t* UnknownFrame::bodyData() const noexcept {
+	const ushort HEADER_SIZE = headerSize();
+	return frameContent.size() > HEADER_SIZE ? frameContent.data() + HEADER_SIZE : nullptr;
+}
+
+///@pkg ID3Frame.h
+ulong UnknownFrame::bodySize() const noexcept {
+	const ushort HEADER_SIZE = headerSize();
+	return frameContent.size() > HEADER_SIZE ? frameContent.size() - HEADER_SIZE : 0;
+}
+
+///@pkg ID3Frame.h
+void UnknownFrame::compact() {}
+
 ///@pkg ID3Frame.h
 void UnknownFrame::writeBody() {}
 
+///@pkg ID3Frame.h
+void UnknownFrame::hashContent(ByteHasher& hasher) const noexcept {
+	const ushort HEADER_SIZE = headerSize();
+	if(frameContent.size() > HEADER_SIZE)
+		hasher.update(frameContent.data() + HEADER_SIZE, frameContent.size() - HEADER_SIZE);
+}
+
 ///@pkg ID3Frame.h
 void UnknownFrame::read() {}
@@ -35,29 +35,9 @@ namespace ID3 {
 	typedef std::vector<uint8_t> ByteArray;
 	
 	/**
-	 * An enum that  represents a Frame class.
-	 * 
-	 * Values and their respective class:
-	 *     CLASS_DESCRIPTIVE:   DescriptiveTextFrame
-	 *     CLASS_NUMERICAL:     NumericalTextFrame
-	 *     CLASS_PICTURE:       PictureFrame
-	 *     CLASS_PLAY_COUNT:    PlayCountFrame
-	 *     CLASS_POPULARIMETER: PopularimeterFrame
-	 *     CLASS_TEXT:          TextFrame
-	 *     CLASS_UNKNOWN:       UnknownFrame
-	 *     CLASS_URL:           URLTextFrame
+	 * @see ID3Functions.hpp
 	 */
-	enum FrameClass : short {
-		CLASS_DESCRIPTIVE   = 3, //DescriptiveTextFrame
-		CLASS_NUMERICAL     = 2, //NumericalTextFrame
-		CLASS_TEXT          = 1, //TextFrame
-		CLASS_UNKNOWN       = 0, //UnknownFrame
-		CLASS_URL           = 4, //URLTextFrame
-		CLASS_PICTURE       = 5, //PictureTextFrame
-		CLASS_PLAY_COUNT    = 6, //PlayCountFrame
-		CLASS_POPULARIMETER = 7, //PopularimeterFrame
-		CLASS_EVENT_TIMING  = 8  //EventTimingFrame
-	};
+	class ByteHasher;
 	
 	/**
 	 * An enum of text encodings used in ID3v2 frames.
@@ -69,6 +49,20 @@ namespace ID3 {
 		ENCODING_UTF8     = 3  //ID3v2.4+ only, ID3-Tagging-Library will read in ID3v2.3
 	};
 	
+	/**
+	 * An enum of the ways to choose the text encoding of a frame when it is
+	 * written.
+	 * 
+	 * Used in ID3::Tag::encodingPolicy(EncodingPolicy).
+	 */
+	enum class EncodingPolicy : uint8_t {
+		UTF8,     //UTF-8, or LATIN-1 if the text is pure ASCII (the default)
+		SMALLEST, //Whichever of LATIN-1, UTF-8, and UTF-16 takes up the fewest bytes
+		PRESERVE  //The encoding the frame was read with, if it can hold the text
+	};
+	
+	struct EncodedSizes;
+	
 	/**
 	 * A 10-bit struct that captures the structure of the ID3v2 frame header.
 	 */
@@ -120,6 +114,7 @@ namespace ID3 {
 	 */
 	class Frame {
 		friend class FrameFactory;
+		friend class Tag;
 		
 		public:
 			/**
@@ -297,12 +292,52 @@ namespace ID3 {
 			 */
 			ByteArray bytes(bool header=false) const noexcept;
 			
+			/**
+			 * Get a hash of the frame ID and the content of the frame. Frames
+			 * with the same content have the same fingerprint, no matter which
+			 * ID3v2 version or text encoding they were read or will be written
+			 * with, so comparing fingerprints is a cheap way to tell if a Frame
+			 * changed.
+			 * 
+			 * @return The 64-bit fingerprint.
+			 * @see ID3::Tag::fingerprint()
+			 */
+			uint64_t fingerprint() const noexcept;
+			
 			/**
 			 * Revert any changes made to the frame since it was last
 			 * read, created, or written.
+			 * 
+			 * NOTE: A compacted Frame no longer has the bytes to revert from. Use
+			 *       ID3::Tag::revert() instead, which re-reads compacted frames
+			 *       from file.
+			 * 
+			 * @throws ID3::Exception if the Frame is compacted and has been
+			 *         edited.
 			 */
 			void revert();
 			
+			/**
+			 * Drop the bytes of the frame body now that they have been processed,
+			 * only keeping the frame header. This halves the memory used by the
+			 * Frame, as the frame content would otherwise be stored twice.
+			 * 
+			 * NOTE: After calling this method bytes() will only return the frame
+			 *       header, and revert() will no longer work on the Frame. Calling
+			 *       write() will restore the frame bytes.
+			 * 
+			 * NOTE: Some frames can only be stored as bytes, so this method does
+			 *       nothing for an UnknownFrame.
+			 */
+			virtual void compact();
+			
+			/**
+			 * Check if the frame body bytes have been dropped with compact().
+			 * 
+			 * @return true if the Frame is compacted, false if not.
+			 */
+			bool compacted() const;
+			
 			/**
 			 * Check if the Frame has been edited. Call revert() to undo
 			 * any changes or save() to save them.
@@ -438,6 +473,21 @@ namespace ID3 {
 			 */
 			virtual void writeBody() = 0;
 			
+			/**
+			 * The hashContent() method adds the content of the Frame to a hash
+			 * for fingerprint(). It must add everything that writeBody() would
+			 * write, but not how it's encoded, so that Frames with the same
+			 * content have the same fingerprint.
+			 * 
+			 * This method will not be called if the Frame is null.
+			 * 
+			 * This method is to be implemented in child classes.
+			 * 
+			 * @param hasher The hash to add to.
+			 * @abstract
+			 */
+			virtual void hashContent(ByteHasher& hasher) const noexcept = 0;
+			
 			/**
 			 * Get the amount of bytes that the current content of the Frame will
 			 * require to write the content.
@@ -448,14 +498,40 @@ namespace ID3 {
 			virtual ulong requiredSize() = 0;
 			
 			/**
-			 * Unsynchronise frame byte contents. This checks for the
+			 * Append the bytes that were cut off the end of frameContent, so that
+			 * bytes() returns the whole frame. It is only called if releasedSize
+			 * isn't 0, and does nothing by default.
+			 * 
+			 * @param bytes The frame bytes to append to.
+			 * @see ID3::Frame::releasedSize
+			 */
+			virtual void appendReleased(ByteArray& bytes) const noexcept;
+			
+			/**
+			 * Undo the unsynchronisation of the frame bytes. This checks for the
 			 * unsynchronisation frame flag to be set first, so it only supports
-			 * ID3v2.4+ frames.
+			 * ID3v2.4+ frames. In ID3v2.3 and below unsynchronisation is applied
+			 * to the whole tag instead, and is undone by Tag before reading frames.
+			 * Afterwards the flag is cleared and the header's frame size updated,
+			 * so that the frame bytes are a valid synchronised frame.
 			 * This method is automatically called from Frame(std::string&, ushort,
 			 * ByteArray&), and shouldn't be called elsewhere.
+			 * 
+			 * @see ID3::resynchronise()
 			 */
 			void unsynchronise();
 			
+			/**
+			 * Choose the text encoding to write the frame's strings in, following
+			 * the encoding policy. Frames with more than one string share one
+			 * encoding, so the sizes of all of them should be added together.
+			 * 
+			 * @param sizes The sizes of the strings in each encoding.
+			 * @return A value of the enum ID3::FrameEncoding.
+			 * @see ID3::encodedSizes()
+			 */
+			uint8_t writeEncoding(const EncodedSizes& sizes) const;
+			
 			/**
 			 * The ID3v2 frame ID.
 			 * 
@@ -498,6 +574,56 @@ namespace ID3 {
 			 * @see ID3::Frame::createdFromFile()
 			 */
 			bool isFromFile;
+			
+			/**
+			 * This variable records if the frame body bytes have been dropped.
+			 * 
+			 * @see ID3::Frame::compacted()
+			 */
+			bool isCompacted;
+			
+			/**
+			 * The size of frameContent before the Frame was compacted.
+			 * 
+			 * @see ID3::Frame::size()
+			 */
+			ulong compactedSize;
+			
+			/**
+			 * The number of bytes cut off the end of frameContent because the
+			 * subclass holds them itself, such as the image of a PictureFrame.
+			 * They still count towards size(), and bytes() gets them from
+			 * appendReleased().
+			 */
+			ulong releasedSize;
+			
+			/**
+			 * The position of the frame in the ID3v2 tag on file. It is saved by
+			 * FrameFactory and Tag::write() so that compacted frames can be read
+			 * from file again.
+			 */
+			ulong filePosition;
+			
+			/**
+			 * The number of bytes the frame took up in the tag it was read from,
+			 * before any unsynchronisation was undone. Tag uses it to find the
+			 * next frame.
+			 */
+			ulong readSize;
+			
+			/**
+			 * How the text encoding is chosen when the frame is written. Tag sets
+			 * it before writing.
+			 * 
+			 * @see ID3::Frame::writeEncoding()
+			 */
+			EncodingPolicy encodingPolicy;
+			
+			/**
+			 * The text encoding the frame was read with, for frames with an
+			 * encoding byte. Used by ID3::EncodingPolicy::PRESERVE.
+			 */
+			uint8_t fileEncoding;
 	};
 	
 	/////////////////////////////////////////////////////////////////////////////
@@ -554,6 +680,27 @@ namespace ID3 {
 			 */
 			virtual std::string print() const;
 			
+			/**
+			 * Get the frame body, which is the frame bytes after the header,
+			 * without copying it.
+			 * 
+			 * NOTE: The pointer is invalidated when the frame is written, when
+			 *       it's removed from the Tag, or when the Tag is destroyed.
+			 * 
+			 * @return A pointer to the first byte of the body, or nullptr if the
+			 *         frame has no body.
+			 * @see ID3::UnknownFrame::bodySize()
+			 */
+			const uint8_t* bodyData() const noexcept;
+			
+			/**
+			 * Get the size of the frame body.
+			 * 
+			 * @return The number of bytes after the header.
+			 * @see ID3::UnknownFrame::bodyData()
+			 */
+			ulong bodySize() const noexcept;
+			
 			/**
 			 * The write() method for UnknownFrame overrides the write() method in
 			 * Frame. The only changes that will be made is empting the frame if
@@ -565,6 +712,14 @@ namespace ID3 {
 			 *                                 the file (doesn't fit in 28 bits).
 			 */
 			virtual ByteArray write();
+			
+			/**
+			 * The frame bytes are the only content of an UnknownFrame, so they
+			 * are never dropped.
+			 * 
+			 * @see ID3::Frame::compact()
+			 */
+			virtual void compact();
 		
 		protected:
 			/**
@@ -602,6 +757,14 @@ namespace ID3 {
 			 */
 			virtual void writeBody();
 			
+			/**
+			 * The hashContent() method for UnknownFrame adds the frame body
+			 * bytes.
+			 * 
+			 * @see ID3::Frame::hashContent()
+			 */
+			virtual void hashContent(ByteHasher& hasher) const noexcept;
+			
 			/** @see ID3::Frame::requiredSize() */
 			virtual inline ulong requiredSize() { return frameContent.size(); }
 	};
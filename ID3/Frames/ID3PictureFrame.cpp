@@ -10,22 +10,143 @@
  * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
  **********************************************************************/
 
-#include <algorithm> //For std::all_of
+#include <algorithm>     //For std::all_of
+#include <utility>       //For std::move
+#include <cstring>       //For memcmp()
+#include <mutex>         //For std::mutex and std::lock_guard
+#include <unordered_map> //For std::unordered_multimap
+#include <vector>        //For std::vector
 
 #include "ID3PictureFrame.hpp" //For the class definitions
 #include "../ID3.hpp"          //For the Picture struct
-#include "../ID3Functions.hpp" //For getUTF8String()
+#include "../ID3Functions.hpp" //For getUTF8String(), appendEncodedString(), findNullTerminator(), and hashBytes()
 
 using namespace ID3;
 
+//Private namespace
+namespace {
+	/**
+	 * The buffers of every PictureData, by the hash of their bytes, so that
+	 * identical images share one buffer. Each buffer removes itself from the
+	 * store when it's freed.
+	 */
+	class PictureStore {
+		public:
+			/**
+			 * @return The program's PictureStore. It's never destroyed, as
+			 *         static PictureData objects can be destroyed after it.
+			 */
+			static PictureStore& instance() {
+				static PictureStore* const store = new PictureStore();
+				return *store;
+			}
+			
+			/**
+			 * Get the buffer that holds some bytes, creating it if none does.
+			 * 
+			 * @param bytes     The bytes.
+			 * @param size      The number of bytes.
+			 * @param hash      The hash of the bytes.
+			 * @param makeBytes A function returning the ByteArray for a new buffer.
+			 * @return The buffer.
+			 */
+			template<typename MakeBytes>
+			std::shared_ptr<const ByteArray> share(const uint8_t* const bytes,
+			                                       const size_t         size,
+			                                       const uint64_t       hash,
+			                                       MakeBytes            makeBytes) {
+				//Buffers that didn't match are let go of after unlocking, as the
+				//last one to let go of a buffer frees it, which locks the store
+				std::vector<std::shared_ptr<const ByteArray>> others;
+				std::lock_guard<std::mutex> lock(mutex);
+				
+				const auto range = buffers.equal_range(hash);
+				for(auto itr = range.first; itr != range.second; itr++) {
+					std::shared_ptr<const ByteArray> buffer = itr->second.lock();
+					if(buffer != nullptr && buffer->size() == size && memcmp(buffer->data(), bytes, size) == 0)
+						return buffer;
+					others.push_back(std::move(buffer));
+				}
+				
+				std::shared_ptr<const ByteArray> buffer(new ByteArray(makeBytes()),
+				                                        [hash](const ByteArray* const freed) { instance().release(hash, freed); });
+				buffers.emplace(hash, buffer);
+				return buffer;
+			}
+		
+		private:
+			PictureStore() {}
+			
+			/**
+			 * Free a buffer, and remove it from the store.
+			 */
+			void release(const uint64_t hash, const ByteArray* const freed) {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					const auto range = buffers.equal_range(hash);
+					for(auto itr = range.first; itr != range.second;)
+						itr = itr->second.expired() ? buffers.erase(itr) : std::next(itr);
+				}
+				delete freed;
+			}
+			
+			std::mutex mutex;
+			std::unordered_multimap<uint64_t, std::weak_ptr<const ByteArray>> buffers;
+	};
+}
+
 ///@pkg ID3.h
-Picture::Picture(const ByteArray&   pictureByteArray,
-                 const std::string& mimeType,
-                 const std::string& pictureDescription,
-                 const PictureType  pictureType) : MIME(mimeType),
-			                                          type(pictureType),
-			                                          description(pictureDescription),
-			                                          data(pictureByteArray) {}
+Picture::Picture(PictureData       pictureByteArray,
+                 std::string       mimeType,
+                 std::string       pictureDescription,
+                 const PictureType pictureType) : MIME(std::move(mimeType)),
+			                                         type(pictureType),
+			                                         description(std::move(pictureDescription)),
+			                                         data(std::move(pictureByteArray)) {}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////  P I C T U R E D A T A ////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+///@pkg ID3PictureFrame.h
+PictureData::PictureData() noexcept : contentHash(0) {}
+
+///@pkg ID3PictureFrame.h
+PictureData::PictureData(const ByteArray& bytes) : PictureData(bytes.data(), bytes.size()) {}
+
+///@pkg ID3PictureFrame.h
+PictureData::PictureData(ByteArray&& bytes) : contentHash(bytes.empty() ? 0 : hashBytes(bytes.data(), bytes.size())) {
+	if(!bytes.empty())
+		buffer = PictureStore::instance().share(bytes.data(), bytes.size(), contentHash,
+		                                        [&bytes]() { return std::move(bytes); });
+}
+
+///@pkg ID3PictureFrame.h
+PictureData::PictureData(const uint8_t* const bytes, const size_t size) : contentHash(size == 0 ? 0 : hashBytes(bytes, size)) {
+	if(size > 0)
+		buffer = PictureStore::instance().share(bytes, size, contentHash,
+		                                        [bytes, size]() { return ByteArray(bytes, bytes + size); });
+}
+
+///@pkg ID3PictureFrame.h
+const ByteArray& PictureData::bytes() const noexcept {
+	//Empty pictures don't allocate a buffer, so they all share this one
+	static const ByteArray EMPTY;
+	return buffer == nullptr ? EMPTY : *buffer;
+}
+
+///@pkg ID3PictureFrame.h
+bool PictureData::operator==(const PictureData& pictureData) const noexcept {
+	return buffer == pictureData.buffer ||
+	       (contentHash == pictureData.contentHash && bytes() == pictureData.bytes());
+}
+
+///@pkg ID3PictureFrame.h
+bool PictureData::shares(const PictureData& pictureData) const noexcept {
+	return buffer != nullptr && buffer == pictureData.buffer;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -43,14 +164,14 @@ PictureFrame::PictureFrame(const ushort version,
 }
 
 ///@pkg ID3PictureFrame.h
-PictureFrame::PictureFrame(const ByteArray& pictureBytes,
-			                  const std::string& mimeType,
-			                  const std::string& description,
+PictureFrame::PictureFrame(PictureData       pictureBytes,
+			                  std::string       mimeType,
+			                  std::string       description,
 			                  const PictureType type) : Frame::Frame(FRAME_PICTURE),
-			                                            textMIME(mimeType),
+			                                            textMIME(std::move(mimeType)),
 									                          APICType(type),
-									                          textDescription(description),
-			                                            pictureData(pictureBytes) {}
+									                          textDescription(std::move(description)),
+			                                            pictureData(std::move(pictureBytes)) {}
 
 ///@pkg ID3PictureFrame.h
 PictureFrame::PictureFrame() noexcept : Frame::Frame(FRAME_PICTURE),
@@ -68,6 +189,9 @@ bool PictureFrame::empty() const { return pictureData.size() == 0; }
 ///@pkg ID3PictureFrame.h
 std::string PictureFrame::mimeType() const { return textMIME; }
 
+///@pkg ID3PictureFrame.h
+StringView PictureFrame::mimeTypeView() const { return textMIME; }
+
 ///@pkg ID3PictureFrame.h
 PictureType PictureFrame::pictureType() const { return APICType; }
 
@@ -81,20 +205,24 @@ void PictureFrame::pictureType(PictureType newType) {
 std::string PictureFrame::description() const { return textDescription; }
 
 ///@pkg ID3PictureFrame.h
-void PictureFrame::description(const std::string& newDescription) {
-	textDescription = newDescription;
+StringView PictureFrame::descriptionView() const { return textDescription; }
+
+///@pkg ID3PictureFrame.h
+void PictureFrame::description(std::string newDescription) {
+	textDescription = std::move(newDescription);
 	isEdited = true;
 }
 
 ///@pkg ID3PictureFrame.h
-ByteArray PictureFrame::picture() const { return pictureData; }
+PictureData PictureFrame::picture() const { return pictureData; }
 
 ///@pkg ID3PictureFrame.h
-void PictureFrame::picture(const ByteArray& newPictureData,
-                           const std::string& newMIMEType) {
+void PictureFrame::picture(PictureData newPictureData,
+                           std::string newMIMEType) {
 	isNull = !allowedMIMEType(newMIMEType);
-	pictureData = newPictureData;
-	textMIME = newMIMEType;
+	pictureData = std::move(newPictureData);
+	textMIME = std::move(newMIMEType);
+	isEdited = true;
 }
 
 ///@pkg ID3PictureFrame.h
@@ -106,10 +234,19 @@ std::string PictureFrame::print() const {
 	       "\nFrame class:    PictureFrame\n";
 }
 
-///@pkg ID3TextFrame.h
+///@pkg ID3PictureFrame.h
+ByteArray PictureFrame::write() {
+	ByteArray frameBytes = Frame::write();
+	releasePicture();
+	return frameBytes;
+}
+
+///@pkg ID3PictureFrame.h
 void PictureFrame::writeBody() {	
-	//Set the encoding to UTF-8
-	frameContent.push_back(FrameEncoding::ENCODING_UTF8);
+	//Choose the encoding from the size of the description, as the MIME type is
+	//always LATIN-1
+	const uint8_t encoding = writeEncoding(encodedSizes(textDescription, true));
+	frameContent.push_back(encoding);
 	
 	//Write the MIME type to file and insert a null separating byte
 	frameContent.insert(frameContent.end(), textMIME.begin(), textMIME.end());
@@ -118,14 +255,22 @@ void PictureFrame::writeBody() {
 	//Write the picture type to file
 	frameContent.push_back(static_cast<uint8_t>(APICType));
 	
-	//Write the description to file and insert a null separating byte
-	frameContent.insert(frameContent.end(), textDescription.begin(), textDescription.end());
-	frameContent.push_back('\0');
+	//Write the description to file and insert a null separator
+	appendEncodedString(frameContent, encoding, textDescription, true);
 	
 	//Write the picture data to file
 	frameContent.insert(frameContent.end(), pictureData.begin(), pictureData.end());
 }
 
+///@pkg ID3PictureFrame.h
+void PictureFrame::hashContent(ByteHasher& hasher) const noexcept {
+	hasher.update(textMIME);
+	hasher.update(static_cast<uint64_t>(APICType));
+	hasher.update(textDescription);
+	//The picture data is already hashed
+	hasher.update(pictureData.hash());
+}
+
 ///@pkg ID3PictureFrame.h
 void PictureFrame::read() {
 	const ushort HEADER_SIZE = headerSize();
@@ -136,6 +281,7 @@ void PictureFrame::read() {
 	if(FRAME_SIZE > HEADER_SIZE) {
 		//The encoding
 		const uint8_t encoding = frameContent[HEADER_SIZE];
+		fileEncoding = encoding;
 		//If the encoding uses 16-byte or 8-byte characters
 		const bool wideChars = encoding == ENCODING_UTF16BOM || encoding == ENCODING_UTF16;
 		
@@ -149,19 +295,16 @@ void PictureFrame::read() {
 		                                     //picture data
 		
 		//Get the MIME type
-		for(ulong i = HEADER_SIZE + 1; i < FRAME_SIZE; i++) {
-			if(frameContent[i] == '\0') {
-				mimeEnd = i;
-				//The MIME string is always stored in LATIN-1
-				textMIME = getUTF8String(ENCODING_LATIN1,
-				                         frameContent,
-				                         HEADER_SIZE+1,
-				                         i);
-				break;
-			}
+		mimeEnd = findNullTerminator(frameContent, HEADER_SIZE + 1);
+		if(mimeEnd < FRAME_SIZE) {
+			//The MIME string is always stored in LATIN-1
+			textMIME = getUTF8String(ENCODING_LATIN1,
+			                         frameContent,
+			                         HEADER_SIZE+1,
+			                         mimeEnd);
 		}
 		//If the frame is improperly encoded, or there's an illegal MIME type
-		if(mimeEnd == 0 || !allowedMIMEType(textMIME)) {
+		if(mimeEnd == FRAME_SIZE || !allowedMIMEType(textMIME)) {
 			isNull = true;
 			return;
 		}
@@ -202,36 +345,51 @@ void PictureFrame::read() {
 		
 		//Get the description
 		descStart = mimeEnd + 2;
-		for(ulong i = descStart; i + descGap <= FRAME_SIZE; i += descGap) {
-			//Prevent false positives in UTF-16 encodings
-			if(frameContent[i] == '\0') {
-				if(wideChars && frameContent[i+1] != '\0') continue;
-				descEnd = i;
-				textDescription = getUTF8String(encoding, frameContent, descStart, descEnd);
-				break;
-			}
-		}
+		descEnd = findNullTerminator(frameContent, descStart, wideChars);
 		//If the frame is improperly encoded
-		if(descEnd == 0) {
+		if(descEnd == FRAME_SIZE) {
 			isNull = true;
 			return;
 		}
+		textDescription = getUTF8String(encoding, frameContent, descStart, descEnd);
 		
-		//Get the picture data
-		if(descEnd + descGap < FRAME_SIZE)
-			pictureData = ByteArray(frameContent.begin() + descEnd + descGap,
-			                        frameContent.end());
-		else
-			pictureData = ByteArray();
+		//Get the picture data, which is only copied out of the frame if no
+		//other PictureData holds the same image. The frame bytes then drop it,
+		//so that the image is only held once.
+		if(releasedSize > 0) {
+			pictureData = releasedPicture;
+		} else if(descEnd + descGap < FRAME_SIZE) {
+			pictureData = PictureData(frameContent.data() + descEnd + descGap,
+			                          FRAME_SIZE - (descEnd + descGap));
+			releasePicture();
+		} else {
+			pictureData = PictureData();
+		}
 	} else {
 		isNull = true;
 		textMIME = "";
 		APICType = PictureType::OTHER;
 		textDescription = "";
-		pictureData = ByteArray();
+		pictureData = PictureData();
 	}
 }
 
+///@pkg ID3PictureFrame.h
+void PictureFrame::appendReleased(ByteArray& bytes) const noexcept {
+	bytes.insert(bytes.end(), releasedPicture.begin(), releasedPicture.end());
+}
+
+///@pkg ID3PictureFrame.h
+void PictureFrame::releasePicture() {
+	//The image is always at the end of the frame bytes
+	const ulong PICTURE_SIZE = pictureData.size();
+	if(isNull || PICTURE_SIZE == 0 || frameContent.size() < headerSize() + PICTURE_SIZE) return;
+	releasedPicture = pictureData;
+	releasedSize = PICTURE_SIZE;
+	frameContent.resize(frameContent.size() - PICTURE_SIZE);
+	frameContent.shrink_to_fit();
+}
+
 ///@pkg ID3PictureFrame.h
 bool PictureFrame::operator==(const Frame* const frame) const noexcept {
 	//Check if the frame IDs or "null" statuses match
@@ -13,7 +13,10 @@
 #ifndef ID3_PICTURE_FRAME_HPP
 #define ID3_PICTURE_FRAME_HPP
 
-#include "ID3Frame.hpp" //For the Frame base class definition
+#include <memory> //For std::shared_ptr
+
+#include "ID3Frame.hpp"         //For the Frame base class definition
+#include "../ID3StringView.hpp" //For StringView
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -63,6 +66,136 @@ namespace ID3 {
 		NULL_PICTURE       = 0xFF //NOTE: This value is not used by PictureFrame
 	};
 	
+	/////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+	/////////////////////////// P I C T U R E D A T A ///////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * PictureData holds the bytes of an image in a reference-counted, immutable
+	 * buffer. Copying a PictureData object only copies a pointer, so pictures
+	 * can be read from a Tag, passed around, and set on another Tag without the
+	 * image bytes ever being copied. The bytes are only copied once, when a
+	 * PictureData is created from a ByteArray lvalue.
+	 * 
+	 * The bytes are hashed when a PictureData is created, and identical images
+	 * share one buffer across the whole program: if another PictureData
+	 * already holds the same bytes, its buffer is used and the bytes aren't
+	 * copied at all. The tracks of an album that all embed the same cover
+	 * hold one copy of it between them.
+	 * 
+	 * PictureData can be used in place of a const ByteArray in most cases, as
+	 * it can be implicitly converted to and from one.
+	 * 
+	 * NOTE: A PictureFrame drops the image from the bytes it was read from or
+	 *       written to, so the image is only held in the shared buffer.
+	 */
+	class PictureData {
+		public:
+			/**
+			 * Create an empty PictureData object.
+			 */
+			PictureData() noexcept;
+			
+			/**
+			 * Create a PictureData object with a copy of the given bytes.
+			 * 
+			 * @param bytes The image bytes.
+			 */
+			PictureData(const ByteArray& bytes);
+			
+			/**
+			 * Create a PictureData object that takes the given bytes without
+			 * copying them.
+			 * 
+			 * @param bytes The image bytes.
+			 */
+			PictureData(ByteArray&& bytes);
+			
+			/**
+			 * Create a PictureData object with a copy of the given bytes, unless
+			 * another PictureData already holds the same bytes.
+			 * 
+			 * @param bytes The first byte of the image.
+			 * @param size  The size of the image.
+			 */
+			PictureData(const uint8_t* bytes, const size_t size);
+			
+			/**
+			 * Get the image bytes.
+			 * 
+			 * @return A reference to the shared image bytes, valid for as long as
+			 *         a PictureData object holding them exists.
+			 */
+			const ByteArray& bytes() const noexcept;
+			
+			/** @see ID3::PictureData::bytes() */
+			inline operator const ByteArray&() const noexcept { return bytes(); }
+			
+			/** @return The size of the image, in bytes. */
+			inline size_t size() const noexcept { return bytes().size(); }
+			
+			/** @return Whether there are no image bytes. */
+			inline bool empty() const noexcept { return bytes().empty(); }
+			
+			/**
+			 * @return The XXH64 hash of the image bytes, which is the same on
+			 *         every machine, or 0 if there are no bytes.
+			 * @see ID3::hashBytes()
+			 */
+			inline uint64_t hash() const noexcept { return contentHash; }
+			
+			/** @return A pointer to the first byte of the image. */
+			inline const uint8_t* data() const noexcept { return bytes().data(); }
+			
+			/** @return An iterator to the first byte of the image. */
+			inline ByteArray::const_iterator begin() const noexcept { return bytes().begin(); }
+			
+			/** @return An iterator past the last byte of the image. */
+			inline ByteArray::const_iterator end() const noexcept { return bytes().end(); }
+			
+			/**
+			 * Get a byte of the image. If the requested position is larger than
+			 * the image size, undefined behavior occurs.
+			 * 
+			 * @param pos The byte position in the image.
+			 * @return The byte at that position.
+			 */
+			inline uint8_t operator[](const size_t pos) const { return bytes()[pos]; }
+			
+			/**
+			 * Check if two PictureData objects hold the same image bytes. If both
+			 * share the same buffer the bytes aren't compared.
+			 * 
+			 * @param pictureData The PictureData to compare with.
+			 */
+			bool operator==(const PictureData& pictureData) const noexcept;
+			
+			/** @see ID3::PictureData::operator==(PictureData&) */
+			inline bool operator!=(const PictureData& pictureData) const noexcept { return !(*this == pictureData); }
+			
+			/**
+			 * Check if this object shares its image buffer with another
+			 * PictureData object.
+			 * 
+			 * @param pictureData The PictureData to compare with.
+			 * @return true if both objects hold the same buffer, false otherwise.
+			 */
+			bool shares(const PictureData& pictureData) const noexcept;
+			
+		private:
+			/**
+			 * The shared image bytes, or a null pointer if the image is empty.
+			 */
+			std::shared_ptr<const ByteArray> buffer;
+			
+			/**
+			 * The hash of the image bytes.
+			 */
+			uint64_t contentHash;
+	};
+	
 	/////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////
 	////////////////////////// P I C T U R E F R A M E //////////////////////////
@@ -117,6 +250,14 @@ namespace ID3 {
 			 */
 			std::string mimeType() const;
 			
+			/**
+			 * Get the MIME type without copying it.
+			 * 
+			 * @return A view of the MIME type.
+			 * @see ID3::PictureFrame::mimeType()
+			 */
+			StringView mimeTypeView() const;
+			
 			/**
 			 * Get the picture type.
 			 * 
@@ -138,19 +279,27 @@ namespace ID3 {
 			 */
 			std::string description() const;
 			
+			/**
+			 * Get the description without copying it.
+			 * 
+			 * @return A view of the description.
+			 * @see ID3::PictureFrame::description()
+			 */
+			StringView descriptionView() const;
+			
 			/**
 			 * Set the description. Call write() to finalize changes.
 			 * 
 			 * @param newDescription The new description.
 			 */
-			void description(const std::string& newDescription);
+			void description(std::string newDescription);
 			
 			/**
-			 * Get the picture data.
+			 * Get the picture data. The image bytes are shared, not copied.
 			 * 
-			 * @return The picture data as a uint8_t vector.
+			 * @return The picture data.
 			 */
-			ByteArray picture() const;
+			PictureData picture() const;
 			
 			/**
 			 * Update the picture. Call write() to finalize changes.
@@ -159,23 +308,23 @@ namespace ID3 {
 			 *       ID3::TextFrame::allowedMIMEType(std::string&), then this Frame
 			 *       will become "null".
 			 * 
-			 * @param newPictureData The new PNG or JPG picture, as a uint8_t vector.
+			 * @param newPictureData The new PNG or JPG picture.
 			 * @param newMIMEType The new MIME type.
 			 */
-			void picture(const ByteArray& newPictureData,
-			             const std::string& newMIMEType);
+			void picture(PictureData newPictureData,
+			             std::string newMIMEType);
 			
 			/**
-			 * @see ID3::PictureFrame::picture(ByteArray&, std::string&)
+			 * @see ID3::PictureFrame::picture(PictureData&, std::string&)
 			 * @see ID3::PictureFrame::pictureType(PictureType)
 			 * @see ID3::PictureFrame::description(std::string&)
 			 */
-			inline void picture(const ByteArray& newPictureData,
-			                    const std::string& newMIMEType,
-			                    const std::string& newDescription,
+			inline void picture(PictureData       newPictureData,
+			                    std::string       newMIMEType,
+			                    std::string       newDescription,
 			                    const PictureType newType) {
-				picture(newPictureData, newMIMEType);
-				description(newDescription);
+				picture(std::move(newPictureData), std::move(newMIMEType));
+				description(std::move(newDescription));
 				pictureType(newType);
 			}
 			
@@ -186,6 +335,14 @@ namespace ID3 {
 			 */
 			virtual std::string print() const;
 			
+			/**
+			 * Write the frame, and then drop the image from the frame bytes kept
+			 * by the Frame, as it's held by the PictureData.
+			 * 
+			 * @see ID3::Frame::write()
+			 */
+			virtual ByteArray write();
+			
 			/**
 			 * Check if a given MIME type is allowed for ID3v2 pictures.
 			 * The only allowed MIME types are "png" or "jpeg" with "image/"
@@ -232,7 +389,7 @@ namespace ID3 {
 			 *       valid PNG or JPG image.
 			 * 
 			 * @param version The ID3v2 major version.
-			 * @param pictureBytes A ByteArray of the PNG or JPG image.
+			 * @param pictureBytes The PNG or JPG image.
 			 * @param mimeType The MIME type of the picture. If the MIMe type is
 			 *                 not valid for ID3v2 pictures, then a "null" Frame
 			 *                 object will be created instead.
@@ -240,9 +397,9 @@ namespace ID3 {
 			 * @param type The picture type (optional). Defaults to the front cover.
 			 * 
 			 */
-			PictureFrame(const ByteArray& pictureBytes,
-			             const std::string& mimeType,
-			             const std::string& description="",
+			PictureFrame(PictureData       pictureBytes,
+			             std::string       mimeType,
+			             std::string       description="",
 			             const PictureType type=PictureType::FRONT_COVER);
 			
 			/**
@@ -269,11 +426,34 @@ namespace ID3 {
 			 */
 			virtual void writeBody();
 			
+			/**
+			 * The hashContent() method for PictureFrame adds the MIME type,
+			 * picture type, description, and the hash of the image.
+			 * 
+			 * @see ID3::Frame::hashContent()
+			 */
+			virtual void hashContent(ByteHasher& hasher) const noexcept;
+			
 			/** @see ID3::Frame::requiredSize() */
 			virtual inline ulong requiredSize() { return headerSize() + 4 +
 				                                          textMIME.length() + textDescription.size() +
 				                                          pictureData.size(); }
 			
+			/**
+			 * The appendReleased() method for PictureFrame appends the image that
+			 * was read from file or last written.
+			 * 
+			 * @see ID3::Frame::appendReleased()
+			 */
+			virtual void appendReleased(ByteArray& bytes) const noexcept;
+			
+			/**
+			 * Cut the image off the end of the frame bytes, and keep it in
+			 * releasedPicture instead. The image is shared with pictureData, so
+			 * the frame doesn't hold it twice.
+			 */
+			void releasePicture();
+			
 			/**
 			 * The image MIME type.
 			 * 
@@ -300,7 +480,15 @@ namespace ID3 {
 			 * 
 			 * @see ID3::PictureFrame::picture()
 			 */
-			ByteArray pictureData;
+			PictureData pictureData;
+			
+			/**
+			 * The image that was cut off the end of the frame bytes, which is
+			 * read again by revert().
+			 * 
+			 * @see ID3::PictureFrame::releasePicture()
+			 */
+			PictureData releasedPicture;
 	};
 }
 
@@ -11,7 +11,7 @@
  **********************************************************************/
 
 #include "ID3PlayCountFrame.hpp" //For the class definitions
-#include "../ID3Functions.hpp"   //For intToByteArray(), byteIntVal(), and getUTF8String()
+#include "../ID3Functions.hpp"   //For intToByteArray(), byteIntVal(), getUTF8String(), and findNullTerminator()
 
 using namespace ID3;
 
@@ -72,6 +72,9 @@ void PlayCountFrame::writeBody() {
 	frameContent.insert(frameContent.end(), playCountArr.begin(), playCountArr.end());
 }
 
+///@pkg ID3PlayCountFrame.h
+void PlayCountFrame::hashContent(ByteHasher& hasher) const noexcept { hasher.update(static_cast<uint64_t>(count)); }
+
 ///@pkg ID3PlayCountFrame.h
 void PlayCountFrame::read() {
 	const ushort HEADER_SIZE = headerSize();
@@ -158,6 +161,9 @@ void PopularimeterFrame::rating(const uint8_t newRating) {
 ///@pkg ID3PlayCountFrame.h
 std::string PopularimeterFrame::email() const { return emailAddress; }
 
+///@pkg ID3PlayCountFrame.h
+StringView PopularimeterFrame::emailView() const { return emailAddress; }
+
 ///@pkg ID3PlayCountFrame.h
 void PopularimeterFrame::email(const std::string& newEmail) {
 	emailAddress = newEmail;
@@ -197,6 +203,13 @@ void PopularimeterFrame::writeBody() {
 	frameContent.insert(frameContent.end(), playCountArr.begin(), playCountArr.end());
 }
 
+///@pkg ID3PlayCountFrame.h
+void PopularimeterFrame::hashContent(ByteHasher& hasher) const noexcept {
+	hasher.update(emailAddress);
+	hasher.update(static_cast<uint64_t>(fiveStarRating));
+	hasher.update(static_cast<uint64_t>(count));
+}
+
 ///@pkg ID3PlayCountFrame.h
 void PopularimeterFrame::read() {
 	const ushort HEADER_SIZE = headerSize();
@@ -205,14 +218,9 @@ void PopularimeterFrame::read() {
 	
 	//Make sure that there is enough room for text before reading the frame bytes
 	if(FRAME_SIZE > HEADER_SIZE) {
-		ulong emailEnd = HEADER_SIZE;
-		
-		for(ulong i = HEADER_SIZE; i < FRAME_SIZE - 2; i++) {
-			if(frameContent[i] == '\0') {
-				emailEnd = i;
-				break;
-			}
-		}
+		//The email address must be followed by at least the rating byte
+		ulong emailEnd = findNullTerminator(frameContent, HEADER_SIZE);
+		if(emailEnd >= FRAME_SIZE - 2) emailEnd = HEADER_SIZE;
 		
 		//Read the email address
 		emailAddress = getUTF8String(ENCODING_LATIN1, //Email addresses are in LATIN-1, no encoding byte
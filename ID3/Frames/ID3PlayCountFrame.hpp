@@ -13,7 +13,8 @@
 #ifndef ID3_PLAY_COUNT_FRAME_HPP
 #define ID3_PLAY_COUNT_FRAME_HPP
 
-#include "ID3Frame.hpp" //For the Frame base class definition
+#include "ID3Frame.hpp"          //For the Frame base class definition
+#include "../ID3StringView.hpp" //For StringView
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -136,6 +137,13 @@ namespace ID3 {
 			 */
 			virtual void writeBody();
 			
+			/**
+			 * The hashContent() method for PlayCountFrame adds the play count.
+			 * 
+			 * @see ID3::Frame::hashContent()
+			 */
+			virtual void hashContent(ByteHasher& hasher) const noexcept;
+			
 			/** @see ID3::Frame::requiredSize() */
 			virtual inline ulong requiredSize() { return headerSize() + 4; }
 			
@@ -202,6 +210,14 @@ namespace ID3 {
 			 */
 			std::string email() const;
 			
+			/**
+			 * Get the email address without copying it.
+			 * 
+			 * @return A view of the email address.
+			 * @see ID3::PopularimeterFrame::email()
+			 */
+			StringView emailView() const;
+			
 			/**
 			 * Set the email address. Call write() to finalize changes.
 			 * 
@@ -292,6 +308,14 @@ namespace ID3 {
 			 */
 			virtual void writeBody();
 			
+			/**
+			 * The hashContent() method for PopularimeterFrame adds the email,
+			 * rating, and play count.
+			 * 
+			 * @see ID3::Frame::hashContent()
+			 */
+			virtual void hashContent(ByteHasher& hasher) const noexcept;
+			
 			/** @see ID3::Frame::requiredSize() */
 			virtual inline ulong requiredSize() { return PlayCountFrame::requiredSize() + emailAddress.size() + 2; }
 			
@@ -10,18 +10,20 @@
  * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
  **********************************************************************/
 
+#include <utility> //For std::move
+
 #include "ID3TextFrame.hpp"    //For the class definitions
 #include "../ID3.hpp"          //For the Text struct
-#include "../ID3Functions.hpp" //For getUTF8String() and numericalString()
+#include "../ID3Functions.hpp" //For getUTF8String(), appendEncodedString(), fitEncodedString(), numericalString(), and findNullTerminator()
 #include "../ID3Constants.hpp" //For MAX_TAG_SIZE
 
 using namespace ID3;
 
 ///@pkg ID3.h
-Text::Text(const std::string& textContent,
-		     const std::string& descText,
-		     const std::string& langText) : text(textContent),
-		                                    description(descText),
+Text::Text(std::string textContent,
+		     std::string descText,
+		     std::string langText) : text(std::move(textContent)),
+		                             description(std::move(descText)),
 		                                    language(langText) {}
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -40,9 +42,9 @@ TextFrame::TextFrame(const FrameID&   frameName,
 }
 
 ///@pkg ID3TextFrame.h
-TextFrame::TextFrame(const FrameID&     frameName,
-                     const std::string& value) noexcept : Frame::Frame(frameName),
-                                                          textContent(value) {}
+TextFrame::TextFrame(const FrameID& frameName,
+                     std::string    value) noexcept : Frame::Frame(frameName),
+                                                      textContent(std::move(value)) {}
 
 ///@pkg ID3TextFrame.h
 TextFrame::TextFrame(const FrameID&                  frameName,
@@ -87,37 +89,39 @@ ByteArray TextFrame::write() {
 	if(OLD_SEPARATOR != '\0') //Loop through the text and convert every slash to a null character
 		for(char& curChar : textContent)
 			if(curChar == OLD_SEPARATOR) curChar = '\0';
-	//Cut off the text if it goes over MAX_TAG_SIZE
+	//Cut off the text if it goes over MAX_TAG_SIZE, without cutting a
+	//character in half
 	if(requiredSize() > MAX_TAG_SIZE)
-		textContent = textContent.substr(0, MAX_TAG_SIZE - headerSize() - 1);
+		fitEncodedString(textContent, ENCODING_UTF8, MAX_TAG_SIZE - headerSize() - 1);
 	//Write the content
 	return Frame::write();
 }
 
 ///@pkg ID3TextFrame.h
 void TextFrame::writeBody() {
-	//Check if the text content is pure ASCII or if it has to be encoded in UTF-8
-	bool isASCII = true;
-	for(const char currentChar : textContent) {
-		if(static_cast<uint8_t>(currentChar) >= 0x80) {
-			isASCII = false;
-			break;
-		}
-	}
-	//Set the encoding to LATIN-1 if it's pure ASCII, else UTF-8
-	frameContent.push_back(isASCII ? FrameEncoding::ENCODING_LATIN1 : FrameEncoding::ENCODING_UTF8);
+	//Choose the encoding from the sizes of the text content
+	const uint8_t encoding = writeEncoding(encodedSizes(textContent));
+	frameContent.push_back(encoding);
+	
+	//Make sure the text still fits once it's encoded, as UTF-16 can be
+	//bigger than the UTF-8 that was cut off in write()
+	fitEncodedString(textContent, encoding, MAX_TAG_SIZE - headerSize() - 1);
 	
 	//Write the text content to file
-	frameContent.insert(frameContent.end(), textContent.begin(), textContent.end());
+	appendEncodedString(frameContent, encoding, textContent);
 }
 
+///@pkg ID3TextFrame.h
+void TextFrame::hashContent(ByteHasher& hasher) const noexcept { hasher.update(textContent); }
+
 ///@pkg ID3TextFrame.h
 void TextFrame::read() {
 	const ushort HEADER_SIZE = headerSize();
 	
 	//Make sure that there is enough room for text before reading the frame bytes
 	if(frameContent.size() > HEADER_SIZE) {
-		textContent = getUTF8String(frameContent[HEADER_SIZE], //Get the encoding byte
+		fileEncoding = frameContent[HEADER_SIZE]; //Get the encoding byte
+		textContent = getUTF8String(fileEncoding,
 		                            frameContent,
 		                            HEADER_SIZE+1);
 	} else {
@@ -130,8 +134,11 @@ void TextFrame::read() {
 std::string TextFrame::content() const { return textContent; }
 
 ///@pkg ID3TextFrame.h
-void TextFrame::content(const std::string& newContent) {
-	textContent = newContent;
+StringView TextFrame::contentView() const { return textContent; }
+
+///@pkg ID3TextFrame.h
+void TextFrame::content(std::string newContent) {
+	textContent = std::move(newContent);
 	isEdited = true;
 }
 
@@ -142,24 +149,21 @@ std::vector<std::string> TextFrame::contents() const {
 	if(textContent.empty()) return emptyString; //If the string is empty, no use continuing
 	
 	std::vector<std::string> tokens; //A vector of strings to return
-	const char SEPARATOR = stringSeparator(); //The separating character
-	size_t tokenStart = 0, tokenEnd = textContent.find(SEPARATOR, 0); //Loop variables
-	
-	while((tokenEnd = textContent.find(SEPARATOR, tokenStart)) != textContent.npos) {
-		//If the substring isn't an empty string
-		if(tokenEnd > tokenStart)
-			tokens.push_back(textContent.substr(tokenStart, tokenEnd - tokenStart));
-		tokenStart = tokenEnd + 1;
-	}
 	
-	//Add the last string token, if it isn't an empty string
-	if(tokenStart < textContent.size()) tokens.push_back(textContent.substr(tokenStart));
+	//Copy every non-empty value straight out of the content string
+	for(const StringView& token : contentsView())
+		tokens.emplace_back(token.data(), token.size());
 	
 	//In the edge case that the string contains only divider characters, then
 	//also return the empty string vector. Else, just return tokens.
 	return tokens.size() == 0 ? emptyString : tokens;
 }
 
+///@pkg ID3TextFrame.h
+SeparatedStringView TextFrame::contentsView() const {
+	return SeparatedStringView(textContent, stringSeparator());
+}
+
 ///@pkg ID3TextFrame.h
 void TextFrame::contents(const std::vector<std::string>& newContent) {
 	isEdited = true;
@@ -234,9 +238,9 @@ NumericalTextFrame::NumericalTextFrame(const FrameID&   frameName,
 }
 
 ///@pkg ID3TextFrame.h
-NumericalTextFrame::NumericalTextFrame(const FrameID&     frameName,
-                                       const std::string& value) : TextFrame::TextFrame(frameName,
-                                                                                        numericalString(value)?value:"") {}
+NumericalTextFrame::NumericalTextFrame(const FrameID& frameName,
+                                       std::string    value) : TextFrame::TextFrame(frameName,
+                                                                                    numericalString(value)?std::move(value):"") {}
 
 ///@pkg ID3TextFrame.h
 NumericalTextFrame::NumericalTextFrame(const FrameID&  frameName,
@@ -264,8 +268,8 @@ NumericalTextFrame::~NumericalTextFrame() {}
 FrameClass NumericalTextFrame::type() const noexcept { return FrameClass::CLASS_NUMERICAL; }
 
 ///@pkg ID3TextFrame.h
-void NumericalTextFrame::content(const std::string& newContent) {
-	TextFrame::content(numericalString(newContent) ? newContent : "");
+void NumericalTextFrame::content(std::string newContent) {
+	TextFrame::content(numericalString(newContent) ? std::move(newContent) : "");
 }
 
 ///@pkg ID3TextFrame.h
@@ -371,11 +375,11 @@ DescriptiveTextFrame::DescriptiveTextFrame(const FrameID& frameName,
 
 ///@pkg ID3TextFrame.h
 DescriptiveTextFrame::DescriptiveTextFrame(const FrameID& frameName,
-                                           const std::string& value,
-                                           const std::string& description,
+                                           std::string value,
+                                           std::string description,
                                            const std::string& language,
-                                           const ushort options) noexcept : TextFrame::TextFrame(frameName, value),
-                                                                            textDescription(description),
+                                           const ushort options) noexcept : TextFrame::TextFrame(frameName, std::move(value)),
+                                                                            textDescription(std::move(description)),
                                                                             textLanguage(language.size() == LANGUAGE_SIZE ? language : ""),
                                                                             optionLanguage((options & OPTION_LANGUAGE) == OPTION_LANGUAGE),
                                                                             optionLatin1((options & OPTION_LATIN1_TEXT)==OPTION_LATIN1_TEXT),
@@ -410,22 +414,20 @@ std::string DescriptiveTextFrame::print() const {
 
 ///@pkg ID3TextFrame.h
 void DescriptiveTextFrame::writeBody() {
-	//TODO: If the LATIN-1 Text option is set, don't just automatically assume
-	//      that the text content string is in ASCII.
+	//Choose the encoding from the sizes of the description and text content.
+	//If the LATIN-1 Text option is set, then the encoding only applies to the
+	//description.
+	EncodedSizes sizes = encodedSizes(optionLatin1 ? "" : textContent);
+	if(!optionNoDescription) sizes += encodedSizes(textDescription, true);
+	const uint8_t encoding = writeEncoding(sizes);
+	frameContent.push_back(encoding);
 	
-	//The textContent is already cut off to prevent it from going over the frame
-	//length in TextFrame::write(). DescriptiveTextFrames contain more data, so
-	//it needs to be dealt with individually
-	if(requiredSize() > MAX_TAG_SIZE) {
-		textContent = textContent.substr(0, MAX_TAG_SIZE - headerSize() - (optionLanguage ? LANGUAGE_SIZE : 0) - 2);
-		if(!optionNoDescription && requiredSize() > MAX_TAG_SIZE) //If the description needs to be trimmed
-			textDescription = textDescription.substr(0, MAX_TAG_SIZE - headerSize() -
-			                                         (optionLanguage ? LANGUAGE_SIZE : 0) -
-			                                         2 - textContent.size());
-	}
-	
-	//Set the encoding to UTF-8
-	frameContent.push_back(FrameEncoding::ENCODING_UTF8);
+	//DescriptiveTextFrames contain more data than the TextFrame::write() cut
+	//off allows for, so cut off the text content, and then the description
+	//if it doesn't fit by itself, by their sizes once encoded
+	ulong room = MAX_TAG_SIZE - headerSize() - 1 - (optionLanguage ? LANGUAGE_SIZE : 0);
+	if(!optionNoDescription) room -= fitEncodedString(textDescription, encoding, room, true);
+	fitEncodedString(textContent, optionLatin1 ? static_cast<uint8_t>(ENCODING_LATIN1) : encoding, room);
 	
 	//Write the language to file
 	if(optionLanguage) {
@@ -434,30 +436,38 @@ void DescriptiveTextFrame::writeBody() {
 	}
 		
 	//Write the description and its null separator to file.
-	if(!optionNoDescription) {
-		frameContent.insert(frameContent.end(), textDescription.begin(), textDescription.end());
-		frameContent.push_back('\0');
-	}
+	if(!optionNoDescription)
+		appendEncodedString(frameContent, encoding, textDescription, true);
 	
 	//Write the text content to file
-	frameContent.insert(frameContent.end(), textContent.begin(), textContent.end());
+	appendEncodedString(frameContent, optionLatin1 ? static_cast<uint8_t>(ENCODING_LATIN1) : encoding, textContent);
+}
+
+///@pkg ID3TextFrame.h
+void DescriptiveTextFrame::hashContent(ByteHasher& hasher) const noexcept {
+	//Add the language that writeBody() would write
+	if(optionLanguage)
+		hasher.update(textLanguage.size() == LANGUAGE_SIZE ? textLanguage : std::string("xxx"));
+	if(!optionNoDescription)
+		hasher.update(textDescription);
+	hasher.update(textContent);
 }
 
 ///@pkg ID3TextFrame.h
-void DescriptiveTextFrame::content(const std::string& newContent) { TextFrame::content(newContent); }
+void DescriptiveTextFrame::content(std::string newContent) { TextFrame::content(std::move(newContent)); }
 
 ///@pkg ID3TextFrame.h
-void DescriptiveTextFrame::content(const std::string& newContent,
-                                   const std::string& newDescription) {
-	TextFrame::content(newContent);
-	description(newDescription);
+void DescriptiveTextFrame::content(std::string newContent,
+                                   std::string newDescription) {
+	TextFrame::content(std::move(newContent));
+	description(std::move(newDescription));
 }
 
 ///@pkg ID3TextFrame.h
-void DescriptiveTextFrame::content(const std::string& newContent,
-                                   const std::string& newDescription,
+void DescriptiveTextFrame::content(std::string        newContent,
+                                   std::string        newDescription,
                                    const std::string& newLanguage) {
-	content(newContent, newDescription);
+	content(std::move(newContent), std::move(newDescription));
 	language(newLanguage);
 }
 
@@ -465,9 +475,12 @@ void DescriptiveTextFrame::content(const std::string& newContent,
 std::string DescriptiveTextFrame::description() const { return textDescription; }
 
 ///@pkg ID3TextFrame.h
-void DescriptiveTextFrame::description(const std::string& newDescription) {
+StringView DescriptiveTextFrame::descriptionView() const { return textDescription; }
+
+///@pkg ID3TextFrame.h
+void DescriptiveTextFrame::description(std::string newDescription) {
 	if(!optionNoDescription) {
-		textDescription = newDescription;
+		textDescription = std::move(newDescription);
 		isEdited = true;
 	}
 }
@@ -475,6 +488,9 @@ void DescriptiveTextFrame::description(const std::string& newDescription) {
 ///@pkg ID3TextFrame.h
 std::string DescriptiveTextFrame::language() const { return textLanguage; }
 
+///@pkg ID3TextFrame.h
+StringView DescriptiveTextFrame::languageView() const { return textLanguage; }
+
 ///@pkg ID3TextFrame.h
 void DescriptiveTextFrame::language(const std::string& newLanguage) {
 	if(optionLanguage) {
@@ -502,6 +518,7 @@ void DescriptiveTextFrame::read() {
 		                                          //the text content
 		//The encoding
 		const uint8_t encoding = frameContent[HEADER_SIZE];
+		fileEncoding = encoding;
 		//If the encoding uses 16-byte or 8-byte characters
 		const bool wideChars = encoding == ENCODING_UTF16BOM || encoding == ENCODING_UTF16;
 		//If wide characters are used, then the gap will be 2 bytes long
@@ -516,16 +533,9 @@ void DescriptiveTextFrame::read() {
 			textLanguage = "";
 		}
 		//Find the description end
-		for(ulong i = descriptionStart; i + descriptionGap <= frameContent.size(); i+= descriptionGap) {
-			if(frameContent[i] == '\0') {
-				if(wideChars && frameContent[i+1] != '\0')
-					continue;
-				descriptionEnd = i;
-				break;
-			}
-		}
+		descriptionEnd = findNullTerminator(frameContent, descriptionStart, wideChars);
 		//If no null characters have been found, then treat it as having no description
-		if(descriptionEnd == 0) {
+		if(descriptionEnd == frameContent.size()) {
 			descriptionEnd = descriptionStart;
 			textDescription = "";
 		} else { //Save the description
@@ -572,9 +582,9 @@ URLTextFrame::URLTextFrame(const FrameID&   frameName,
 }
 
 ///@pkg ID3TextFrame.h
-URLTextFrame::URLTextFrame(const FrameID&     frameName,
-                           const std::string& value) noexcept : TextFrame::TextFrame(frameName,
-                                                                                     value) {}
+URLTextFrame::URLTextFrame(const FrameID& frameName,
+                           std::string    value) noexcept : TextFrame::TextFrame(frameName,
+                                                                                 std::move(value)) {}
 
 ///@pkg ID3TextFrame.h
 URLTextFrame::URLTextFrame(const FrameID&                  frameName,
@@ -13,7 +13,8 @@
 #ifndef ID3_TEXT_FRAME_HPP
 #define ID3_TEXT_FRAME_HPP
 
-#include "ID3Frame.hpp" //For the Frame base class definition
+#include "ID3Frame.hpp"         //For the Frame base class definition
+#include "../ID3StringView.hpp" //For StringView and SeparatedStringView
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -104,12 +105,23 @@ namespace ID3 {
 			 */
 			std::string content() const;
 			
+			/**
+			 * Get the text content without copying it.
+			 * 
+			 * NOTE: The view is invalidated when the frame content changes or the
+			 *       frame is destroyed.
+			 * 
+			 * @returns A view of the text content of the frame in UTF-8 encoding.
+			 * @see ID3::TextFrame::content()
+			 */
+			StringView contentView() const;
+			
 			/**
 			 * Set the text content. Call write() to finalize changes.
 			 * 
 			 * @param newContent The new text content.
 			 */
-			virtual void content(const std::string& newContent);
+			virtual void content(std::string newContent);
 			
 			/**
 			 * Get the text content, split by the separating character.
@@ -119,6 +131,18 @@ namespace ID3 {
 			 */
 			std::vector<std::string> contents() const;
 			
+			/**
+			 * Get the text content split by the separating character, without
+			 * copying it or allocating a vector.
+			 * 
+			 * NOTE: The range is invalidated when the frame content changes or the
+			 *       frame is destroyed.
+			 * 
+			 * @return A range of views over the non-empty values.
+			 * @see ID3::TextFrame::contents()
+			 */
+			SeparatedStringView contentsView() const;
+			
 			/**
 			 * Set the text content with a string vector. The vector will be
 			 * contatenated by the frame's separating character.
@@ -182,8 +206,8 @@ namespace ID3 {
 			 * @param frameName The frame ID (optional).
 			 * @param value     The text of the frame (optional).
 			 */
-			TextFrame(const FrameID&     frameName=Frames::FRAME_UNKNOWN_FRAME,
-			          const std::string& value="") noexcept;
+			TextFrame(const FrameID& frameName=Frames::FRAME_UNKNOWN_FRAME,
+			          std::string    value="") noexcept;
 			
 			/**
 			 * @param frameName The frame ID.
@@ -219,6 +243,13 @@ namespace ID3 {
 			 */
 			virtual void writeBody();
 			
+			/**
+			 * The hashContent() method for TextFrame adds the text content.
+			 * 
+			 * @see ID3::Frame::hashContent()
+			 */
+			virtual void hashContent(ByteHasher& hasher) const noexcept;
+			
 			/** @see ID3::Frame::requiredSize() */
 			virtual inline ulong requiredSize() { return headerSize() + 1 + textContent.size(); }
 	};
@@ -317,7 +348,7 @@ namespace ID3 {
 			 * 
 			 * @param newContent The new text content.
 			 */
-			virtual void content(const std::string& newContent);
+			virtual void content(std::string newContent);
 			
 			/**
 			 * Set the text content with a string vector. The vector will be
@@ -387,8 +418,8 @@ namespace ID3 {
 			 * @param value The text of the frame (optional).
 			 * @see ID3::Frame::Frame(FrameID&, ushort, ByteArray&)
 			 */
-			NumericalTextFrame(const FrameID&     frameName=Frames::FRAME_UNKNOWN_FRAME,
-			                   const std::string& value="");
+			NumericalTextFrame(const FrameID& frameName=Frames::FRAME_UNKNOWN_FRAME,
+			                   std::string    value="");
 			
 			/**
 			 * This constructor manually creates a text frame with
@@ -462,19 +493,19 @@ namespace ID3 {
 			 * An option value used when reading USLT, USER, and COMM frames, as
 			 * they have a 3-byte language string after the encoding byte.
 			 */
-			static const ushort OPTION_LANGUAGE = 0b00000001;
+			static const ushort OPTION_LANGUAGE = FRAME_OPTION_LANGUAGE;
 			
 			/**
 			 * An option value used when reading the WXXX frame, as the URL string
 			 * is always encoded in LATIN-1.
 			 */
-			static const ushort OPTION_LATIN1_TEXT = 0b00000010;
+			static const ushort OPTION_LATIN1_TEXT = FRAME_OPTION_LATIN1_TEXT;
 			
 			/**
 			 * An option value used when reading the USER frame, as it doesn't have
 			 * a description.
 			 */
-			static const ushort OPTION_NO_DESCRIPTION = 0b00000100;
+			static const ushort OPTION_NO_DESCRIPTION = FRAME_OPTION_NO_DESCRIPTION;
 			
 			/**
 			 * How long, in bytes, a valid ISO 639-2 code language is.
@@ -503,7 +534,7 @@ namespace ID3 {
 			 * 
 			 * @param newContent The new text content.
 			 */
-			virtual void content(const std::string& newContent);
+			virtual void content(std::string newContent);
 			
 			/**
 			 * Set the text content and the description.
@@ -513,8 +544,8 @@ namespace ID3 {
 			 * @param newDescription The new description.
 			 * @see ID3::DescriptiveTextFrame::description(std::string&)
 			 */
-			virtual void content(const std::string& newContent,
-			                     const std::string& newDescription);
+			virtual void content(std::string newContent,
+			                     std::string newDescription);
 			
 			/**
 			 * Set the text content, description, and language.
@@ -526,8 +557,8 @@ namespace ID3 {
 			 * @see ID3::DescriptiveTextFrame::description(std::string&)
 			 * @see ID3::DescriptiveTextFrame::language(std::string&)
 			 */
-			virtual void content(const std::string& newContent,
-			                     const std::string& newDescription,
+			virtual void content(std::string        newContent,
+			                     std::string        newDescription,
 			                     const std::string& newLanguage);
 			
 			/**
@@ -537,6 +568,14 @@ namespace ID3 {
 			 */
 			std::string description() const;
 			
+			/**
+			 * Get the description without copying it.
+			 * 
+			 * @return A view of the description of the frame in UTF-8 encoding.
+			 * @see ID3::DescriptiveTextFrame::description()
+			 */
+			StringView descriptionView() const;
+			
 			/**
 			 * Set the description. Call write() to finalize changes.
 			 * 
@@ -545,7 +584,7 @@ namespace ID3 {
 			 * 
 			 * @param newDescription The new description.
 			 */
-			virtual void description(const std::string& newDescription);
+			virtual void description(std::string newDescription);
 			
 			/**
 			 * Get the language. If the language option was not passed in the
@@ -555,6 +594,14 @@ namespace ID3 {
 			 */
 			std::string language() const;
 			
+			/**
+			 * Get the language without copying it.
+			 * 
+			 * @return A view of the language of the frame.
+			 * @see ID3::DescriptiveTextFrame::language()
+			 */
+			StringView languageView() const;
+			
 			/**
 			 * Set the language. Call write() to finalize changes.
 			 * 
@@ -622,9 +669,9 @@ namespace ID3 {
 			 *                ID3::DescriptiveTextFrame::OPTION_LATIN1_TEXT (optional).
 			 *                For multiple values, OR (option | option) them together.
 			 */
-			DescriptiveTextFrame(const FrameID&    frameName=Frames::FRAME_UNKNOWN_FRAME,
-			                     const std::string& value="",
-			                     const std::string& description="",
+			DescriptiveTextFrame(const FrameID&     frameName=Frames::FRAME_UNKNOWN_FRAME,
+			                     std::string        value="",
+			                     std::string        description="",
 			                     const std::string& language="",
 			                     const ushort       options=0) noexcept;
 			
@@ -660,6 +707,14 @@ namespace ID3 {
 			 */
 			virtual void writeBody();
 			
+			/**
+			 * The hashContent() method for DescriptiveTextFrame adds the text
+			 * content, description, and language.
+			 * 
+			 * @see ID3::Frame::hashContent()
+			 */
+			virtual void hashContent(ByteHasher& hasher) const noexcept;
+			
 			/** @see ID3::Frame::requiredSize() */
 			virtual inline ulong requiredSize() { return TextFrame::requiredSize() +
 			                                             (optionLanguage ? LANGUAGE_SIZE : 0) +
@@ -798,8 +853,8 @@ namespace ID3 {
 			 * @param frameName The frame ID.
 			 * @param value The text of the frame (optional).
 			 */
-			URLTextFrame(const FrameID&     frameName=Frames::FRAME_UNKNOWN_FRAME,
-			             const std::string& value="") noexcept;
+			URLTextFrame(const FrameID& frameName=Frames::FRAME_UNKNOWN_FRAME,
+			             std::string    value="") noexcept;
 			
 			/**
 			 * @param frameName The frame ID.
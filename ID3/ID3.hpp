@@ -16,14 +16,17 @@
 #include <fstream>       //For std::fstream and std::ostream
 #include <vector>        //For std::vector
 #include <unordered_map> //For std::unordered_map and std::pair
-#include <memory>        //For std::shared_ptr
+#include <memory>        //For std::shared_ptr and std::unique_ptr
 #include <functional>    //For std::function
+#include <utility>       //For std::move
 
 #include "Frames/ID3Frame.hpp"            //For supporting Frames
 #include "Frames/ID3PictureFrame.hpp"     //For PictureType
 #include "Frames/ID3EventTimingFrame.hpp" //For TimingCodes
 #include "ID3FrameID.hpp"                 //For frame IDs
 #include "ID3FrameFactory.hpp"            //For FrameFactory
+#include "ID3StringView.hpp"              //For StringView and SeparatedStringView
+#include "ID3Exception.hpp"               //For ErrorCode
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -146,16 +149,20 @@ namespace ID3 {
 		 * 
 		 * Defined in ID3PictureFrame.cpp.
 		 * 
-		 * @param pictureByteArray The uint8_t vector of the PNG or JPG image.
+		 * NOTE: The parameters are taken by value, so passing temporaries or
+		 *       std::move()-ed values moves them in without a copy.
+		 * 
+		 * @param pictureByteArray The PNG or JPG image. Its bytes are shared
+		 *                         with the PictureData object, not copied.
 		 * @param mimeType The MIME type.
 		 * @param pictureDescription The description.
 		 * @param pictureType The picture type defined in the ID3v2 specification
 		 *                    for the APIC field. Defaults to FRONT_COVER.
 		 */
-		Picture(const ByteArray&   pictureByteArray=ByteArray(),
-			     const std::string& mimeType="",
-			     const std::string& pictureDescription="",
-			     const PictureType  pictureType=PictureType::FRONT_COVER);
+		Picture(PictureData       pictureByteArray=PictureData(),
+			     std::string       mimeType="",
+			     std::string       pictureDescription="",
+			     const PictureType pictureType=PictureType::FRONT_COVER);
 		/** @return Whether the MIME type is valid or not. */
 		inline bool null() const { return !PictureFrame::allowedMIMEType(MIME); }
 		/**
@@ -163,10 +170,16 @@ namespace ID3 {
 		 *         Picture frame, excluding the header.
 		 */
 		inline ulong size() const { return MIME.size() + 3 + description.size() + data.size(); }
+		/**
+		 * @return The hash of the picture data, so that identical pictures can
+		 *         be found without comparing them.
+		 * @see ID3::PictureData::hash()
+		 */
+		inline uint64_t hash() const { return data.hash(); }
 		std::string MIME;
 		PictureType type;
 		std::string description;
-		ByteArray   data;
+		PictureData data;
 	};
 	
 	/**
@@ -204,19 +217,54 @@ namespace ID3 {
 		 * 
 		 * Defined in ID3TextFrame.cpp.
 		 * 
+		 * NOTE: The parameters are taken by value, so passing temporaries or
+		 *       std::move()-ed strings moves them in without a copy.
+		 * 
 		 * @param textContent The content string of the frame.
 		 * @param descText    The description of the frame.
 		 * @param langText    The language of the frame. It should be a ISO 639-2
 		 *                    language code.
 		 */
-		Text(const std::string& textContent="",
-		     const std::string& descText="",
-		     const std::string& langText="");
+		Text(std::string textContent="",
+		     std::string descText="",
+		     std::string langText="");
 		std::string text;
 		std::string description;
 		std::string language;
 	};
 	
+	/**
+	 * An enum of the ways a Tag checks that a file is one it can read and
+	 * write.
+	 */
+	enum class FileCheck : uint8_t {
+		EXTENSION, //The file must have an MP3, MP4, or WAV file extension (the default)
+		CONTENT    //The file may instead start with an ID3v2 tag, an MPEG audio
+		           //frame, a RIFF WAVE header, or an MP4 file type box
+	};
+	
+	/**
+	 * An enum of the ways a Tag reads a file.
+	 */
+	enum class ReadMode : uint8_t {
+		NORMAL,     //The file is read with a std::ifstream (the default)
+		SCAN,       //For scanning many files: readahead is turned off and the
+		            //file's pages are dropped from the page cache after reading,
+		            //so that the scan doesn't evict the cached audio of other files
+		SCAN_DIRECT //Like SCAN, but the tag regions are read with aligned O_DIRECT
+		            //reads that bypass the page cache, where supported
+	};
+	
+	/**
+	 * @see ID3TagCache.hpp
+	 */
+	class TagCache;
+	
+	/**
+	 * @see ID3TagExporter.hpp
+	 */
+	class TagExporter;
+	
 	/////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////// C L A S S E S ///////////////////////////////
@@ -256,6 +304,9 @@ namespace ID3 {
 	 * Defined in ID3Tag.cpp.
 	 */	
 	class Tag {
+		friend class TagCache;
+		friend class TagExporter;
+		
 		public:
 			/**
 			 * Constructor that takes a filename and opens the file.
@@ -276,6 +327,142 @@ namespace ID3 {
 			 */
 			explicit Tag(const std::string& fileLoc);
 			
+			/**
+			 * Constructor that takes a filename and opens the file, choosing how
+			 * the file is checked to be an MP3, MP4, or WAV file. With
+			 * FileCheck::CONTENT, files with a missing or wrong extension are
+			 * accepted if their first bytes look like one, and the same check is
+			 * done when the tags are written.
+			 * 
+			 * @param fileLoc The file path.
+			 * @param check   The ID3::FileCheck enum value.
+			 * @see ID3::Tag::Tag(std::string&)
+			 */
+			Tag(const std::string& fileLoc, const FileCheck check);
+			
+			/**
+			 * Constructor that takes a filename and opens the file, limiting the
+			 * memory and work reading its ID3v2 tags can take. Use it for files
+			 * that may be corrupt or crafted, such as uploads.
+			 * 
+			 * @param fileLoc The file path.
+			 * @param limits  The ID3::ReadLimits to read the tags with.
+			 * @param check   The ID3::FileCheck enum value (optional).
+			 * @see ID3::Tag::Tag(std::string&)
+			 */
+			Tag(const std::string& fileLoc,
+			    const ReadLimits&  limits,
+			    const FileCheck    check=FileCheck::EXTENSION);
+			
+			/**
+			 * Constructor that takes a filename and opens the file, choosing how
+			 * the file is read. Use ReadMode::SCAN when reading the tags of a
+			 * whole library, so that the scan doesn't push other files out of
+			 * the page cache.
+			 * 
+			 * @param fileLoc The file path.
+			 * @param mode    The ID3::ReadMode enum value.
+			 * @param check   The ID3::FileCheck enum value (optional).
+			 * @see ID3::Tag::Tag(std::string&)
+			 */
+			Tag(const std::string& fileLoc,
+			    const ReadMode     mode,
+			    const FileCheck    check=FileCheck::EXTENSION);
+			
+			/**
+			 * Constructor that takes a filename and reads the file's tags through
+			 * a TagCache. If the file hasn't changed since it was cached, the
+			 * tags are read from the cache instead of the file. Otherwise the file
+			 * is read and added to the cache.
+			 * 
+			 * NOTE: If the cache doesn't store the bytes of each file's tags, the
+			 *       tags of a cached file are still read from the file.
+			 * 
+			 * NOTE: The cache keeps a file's ID3v2 tag up to the ReadLimits'
+			 *       totalSize. A Tag read from a cached tag that was cut short
+			 *       is partial().
+			 * 
+			 * @param fileLoc The file path.
+			 * @param cache   The ID3::TagCache to use.
+			 * @param check   The ID3::FileCheck enum value (optional).
+			 * @param limits  The ID3::ReadLimits to read the tags with (optional).
+			 * @param mode    How the file is read if it isn't read from the cache
+			 *                (optional).
+			 * @see ID3::Tag::Tag(std::string&)
+			 */
+			Tag(const std::string& fileLoc,
+			    TagCache&          cache,
+			    const FileCheck    check=FileCheck::EXTENSION,
+			    const ReadLimits&  limits=ReadLimits(),
+			    const ReadMode     mode=ReadMode::NORMAL);
+			
+			/**
+			 * Read the tags from a file without throwing exceptions, for scanning
+			 * many files where some are expected to fail. Files that fail the
+			 * file check or can't be opened are rejected without the cost of
+			 * creating and throwing an exception.
+			 * 
+			 * @param fileLoc The file path.
+			 * @param tag     The Tag to read into. It is only changed on success.
+			 * @param check   The ID3::FileCheck enum value (optional).
+			 * @param limits  The ID3::ReadLimits to read the tags with (optional).
+			 * @param mode    The ID3::ReadMode enum value (optional).
+			 * @return ErrorCode::NONE on success, or the ErrorCode matching the
+			 *         exception that ID3::Tag::Tag(std::string&, FileCheck)
+			 *         would have thrown.
+			 */
+			static ErrorCode open(const std::string& fileLoc,
+			                      Tag&               tag,
+			                      const FileCheck    check=FileCheck::EXTENSION,
+			                      const ReadLimits&  limits=ReadLimits(),
+			                      const ReadMode     mode=ReadMode::NORMAL) noexcept;
+			
+			/**
+			 * Like ID3::Tag::open(), but only read which ID3 versions are on the
+			 * file and their headers, not the frames. This is enough for
+			 * version() and to check if the file has tags.
+			 * 
+			 * @see ID3::Tag::open()
+			 */
+			static ErrorCode probe(const std::string& fileLoc,
+			                       Tag&               tag,
+			                       const FileCheck    check=FileCheck::EXTENSION,
+			                       const ReadLimits&  limits=ReadLimits(),
+			                       const ReadMode     mode=ReadMode::NORMAL) noexcept;
+			
+			/**
+			 * Hash the audio of many files at once on several threads, as with
+			 * ID3::Tag::audioHash(). Only the tag headers of each file are read.
+			 * 
+			 * @param fileLocs The file paths.
+			 * @param hashes   Where to put each file's hash, in the same order.
+			 *                 The hash of a file that failed is 0.
+			 * @param threads  How many threads to use, or 0 to use one per
+			 *                 processor core (optional, defaults to 0).
+			 * @param check    The ID3::FileCheck enum value (optional).
+			 * @return Each file's ErrorCode, in the same order. It is
+			 *         ErrorCode::NONE for files that were hashed.
+			 * @see ID3::Tag::audioHash()
+			 */
+			static std::vector<ErrorCode> audioHashes(const std::vector<std::string>& fileLocs,
+			                                          std::vector<uint64_t>&          hashes,
+			                                          const unsigned                  threads=0,
+			                                          const FileCheck                 check=FileCheck::EXTENSION);
+			
+			/**
+			 * Like ID3::Tag::open(), but reading the file's tags through a
+			 * TagCache.
+			 * 
+			 * @see ID3::Tag::open()
+			 * @see ID3::Tag::Tag(std::string&, TagCache&, FileCheck, ReadLimits&, ReadMode)
+			 */
+			static ErrorCode open(const std::string& fileLoc,
+			                      Tag&               tag,
+			                      TagCache&          cache,
+			                      const FileCheck    check=FileCheck::EXTENSION,
+			                      const ReadLimits&  limits=ReadLimits(),
+			                      const ReadMode     mode=ReadMode::NORMAL) noexcept;
+			
 			/**
 			 * A constructor that creates a blank Tag object without a file.
 			 */
@@ -350,6 +537,8 @@ namespace ID3 {
 			 *         the maximum frame size (28 bits, 256 MiB).
 			 * @throws ID3::TagSizeException if the tag to write is bigger than the
 			 *         maximum tag size (28 bits, 256 MiB).
+			 * @throws ID3::WriteException if the file can't be written, or if
+			 *         frames were skipped when the tags were read (see partial()).
 			 */
 			void write(const std::string& fileLoc,
 			           const float        paddingFactor=0.1,
@@ -370,13 +559,127 @@ namespace ID3 {
 			 */
 			inline void write() { write(fileName()); }
 			
+			/**
+			 * Write the tags to the file location given without throwing
+			 * exceptions. Failing the file check or not being able to open the
+			 * file are reported without the cost of creating and throwing an
+			 * exception.
+			 * 
+			 * @return ErrorCode::NONE on success, or the ErrorCode matching the
+			 *         exception that write() would have thrown.
+			 * @see ID3::Tag::write(std::string&, float, bool, bool, bool, bool)
+			 */
+			ErrorCode tryWrite(const std::string& fileLoc,
+			                   const float        paddingFactor=0.1,
+			                   const bool         setFileNameUponSuccess=true,
+			                   const bool         discardNonCoverPictures=false,
+			                   const bool         discardUnknown=false,
+			                   const bool         addTaggingTime=true) noexcept;
+			
+			/** @see ID3::Tag::tryWrite(std::string&, float, bool, bool, bool, bool) */
+			inline ErrorCode tryWrite() noexcept { return tryWrite(fileName()); }
+			
+			/**
+			 * Check if the last write rewrote the whole file, because the new
+			 * tags didn't fit in the old tags and their padding or ID3v1 tags
+			 * had to be removed, instead of writing the tags over in place.
+			 * 
+			 * NOTE: A write that failed while rewriting the file also counts, as
+			 *       the file was truncated and may have lost its audio.
+			 * 
+			 * @return true if the file was rewritten, false if the tags were
+			 *         written over in place or there was no write.
+			 */
+			bool rewritten() const;
+			
 			/**
 			 * Revert any changes made to the tags since the last call to a
 			 * write() method, or since the creation of the Tag object if a write()
 			 * method has never been called.
+			 * 
+			 * NOTE: Edited frames that have been compacted are read from file
+			 *       again, at the position they were last read from or written to.
+			 * 
+			 * @throws ID3::FileNotFoundException if a compacted frame needs to be
+			 *         read again but the file cannot be opened.
+			 * @throws ID3::FileFormatException if a compacted frame needs to be
+			 *         read again but the tags on file have been changed by another
+			 *         program since they were read or written.
+			 * @see ID3::Tag::compact()
 			 */
 			void revert();
 			
+			/**
+			 * Put the Tag in compact mode, where each Frame only keeps its
+			 * processed content and drops the frame bytes read from file. This
+			 * roughly halves the memory used by the Tag, which is useful when
+			 * keeping a large number of Tag objects in memory.
+			 * 
+			 * Frames are compacted when this method is called, and again after
+			 * every successful write().
+			 * 
+			 * NOTE: In compact mode, binaryData() and binaryDatas() will only
+			 *       return data for unknown frames, and revert() will have to
+			 *       read edited frames from file again.
+			 * 
+			 * @see ID3::Frame::compact()
+			 */
+			void compact();
+			
+			/**
+			 * @returns Whether the Tag is in compact mode.
+			 * @see ID3::Tag::compact()
+			 */
+			bool compacted() const;
+			
+			/**
+			 * Set how the text encoding of each frame is chosen when the tags are
+			 * written. EncodingPolicy::SMALLEST writes text such as CJK in UTF-16
+			 * when that is smaller than UTF-8, which lets more edits fit in the
+			 * existing padding without rewriting the file.
+			 * 
+			 * @param policy The ID3::EncodingPolicy enum value (defaults to
+			 *               EncodingPolicy::UTF8).
+			 * @see ID3::EncodingPolicy
+			 */
+			void encodingPolicy(const EncodingPolicy policy);
+			
+			/**
+			 * @returns How the text encoding of each frame is chosen when the tags
+			 *          are written.
+			 * @see ID3::Tag::encodingPolicy(EncodingPolicy)
+			 */
+			EncodingPolicy encodingPolicy() const;
+			
+			/**
+			 * Set the limits on reading ID3v2 tags from file. They apply when
+			 * frames are read again by revert(), and are otherwise given to the
+			 * constructor or open().
+			 * 
+			 * @param limits The ID3::ReadLimits to use.
+			 * @see ID3::ReadLimits
+			 */
+			void readLimits(const ReadLimits& limits);
+			
+			/**
+			 * @returns The limits on reading ID3v2 tags from file.
+			 * @see ID3::Tag::readLimits(ReadLimits&)
+			 */
+			const ReadLimits& readLimits() const;
+			
+			/**
+			 * Check if frames on file were skipped when the tags were read,
+			 * because they were over the ReadLimits or past the frame limit.
+			 * 
+			 * NOTE: A partially read Tag can't be written, as the skipped frames
+			 *       would be deleted from the file. Read the file again with
+			 *       higher ReadLimits to edit it.
+			 * 
+			 * @returns Whether frames were skipped.
+			 * @see ID3::ReadLimits
+			 */
+			bool partial() const;
+			
 			///////////////////////////////////////////////////////////////////////
 			///////////////////////////////////////////////////////////////////////
 			//////////////// S T A R T   F R A M E   G E T T E R S ////////////////
@@ -442,6 +745,37 @@ namespace ID3 {
 			 */
 			std::vector<std::string> textStrings(const FrameID& frameName) const;
 			
+			/**
+			 * Get the text content of a frame without copying it.
+			 * 
+			 * NOTE: The view refers to the text held by the frame. It stays valid
+			 *       for the lifetime of the Tag, until that frame is edited,
+			 *       removed, or reverted.
+			 * 
+			 * @param frameName An ID3v2 frame ID.
+			 * @return A view of the text content, or an empty view if the frame
+			 *         is not found, "null", or not a text frame.
+			 * @see ID3::Tag::textString(FrameID&)
+			 */
+			StringView textStringView(const FrameID& frameName) const;
+			
+			/**
+			 * Get the text content of a frame split up by its separating character,
+			 * without copying the values or allocating a vector.
+			 * 
+			 * NOTE: Unlike textStrings(), if the frame ID supports multiple
+			 *       instances of the frame only the first instance is viewed, and
+			 *       if the frame does not exist the range is empty. Use
+			 *       textStrings() to get the content of every instance.
+			 * 
+			 * NOTE: The same lifetime rules as textStringView() apply.
+			 * 
+			 * @param frameName An ID3v2 frame ID.
+			 * @return A range of views over the non-empty values.
+			 * @see ID3::Tag::textStrings(FrameID&)
+			 */
+			SeparatedStringView textStringsView(const FrameID& frameName) const;
+			
 			/**
 			 * Return a Text struct with a frame's text content, description, and
 			 * language.
@@ -552,13 +886,17 @@ namespace ID3 {
 			 * NOTE: If there are more than one instance of the frame ID in the
 			 *       tag, only the first frame will be modified.
 			 * 
+			 * NOTE: The text is taken by value and moved into the frame, so
+			 *       passing a temporary or a std::move()-ed value avoids copying
+			 *       large strings such as lyrics.
+			 * 
 			 * @param frameID The ID3v2 frame ID.
 			 * @param text    A Text struct containing new text content.
 			 */
-			void text(const FrameID& frameID, const Text& text);
+			void text(const FrameID& frameID, Text text);
 			
 			/** @see ID3::Tag::text(FrameID&, Text&) */
-			void text(const FrameID& frameID, const std::string& text);
+			void text(const FrameID& frameID, std::string text);
 			
 			/** @see ID3::Tag::text(FrameID&, Text&) */
 			void text(const FrameID& frameID, const std::vector<std::string>& text);
@@ -669,12 +1007,15 @@ namespace ID3 {
 			 * @return The title of the tag, or "" if no title is set.
 			 */
 			inline std::string title() const { return textString(FRAME_TITLE); }
+			/** @see ID3::Tag::title()
+			 *  @see ID3::Tag::textStringView(FrameID&) */
+			inline StringView titleView() const { return textStringView(FRAME_TITLE); }
 			/**
 			 * Set the title tag.
 			 * 
 			 * @param newTitle The new title.
 			 */
-			inline void title(const std::string& newTitle) { text(FRAME_TITLE, newTitle); }
+			inline void title(std::string newTitle) { text(FRAME_TITLE, std::move(newTitle)); }
 			
 			/**
 			 * Get the genre tag.
@@ -698,7 +1039,7 @@ namespace ID3 {
 			 * 
 			 * @param newGenre The new genre.
 			 */
-			inline void genre(const std::string& newGenre) { text(FRAME_GENRE, newGenre); }
+			inline void genre(std::string newGenre) { text(FRAME_GENRE, std::move(newGenre)); }
 			/**
 			 * Set the genre tag.
 			 * 
@@ -717,12 +1058,18 @@ namespace ID3 {
 			/** @see ID3::Tag::artist()
 			 *  @see ID3::Tag::textStrings(Frames) */
 			inline std::vector<std::string> artists() const { return textStrings(FRAME_ARTIST); }
+			/** @see ID3::Tag::artist()
+			 *  @see ID3::Tag::textStringView(FrameID&) */
+			inline StringView artistView() const { return textStringView(FRAME_ARTIST); }
+			/** @see ID3::Tag::artists()
+			 *  @see ID3::Tag::textStringsView(FrameID&) */
+			inline SeparatedStringView artistsView() const { return textStringsView(FRAME_ARTIST); }
 			/**
 			 * Set the artist tag.
 			 * 
 			 * @param newArtist The new artist.
 			 */
-			inline void artist(const std::string& newArtist) { text(FRAME_ARTIST, newArtist); }
+			inline void artist(std::string newArtist) { text(FRAME_ARTIST, std::move(newArtist)); }
 			/** @see ID3::Tag::artist(std::string&) */
 			inline void artist(const std::vector<std::string>& newArtists) { text(FRAME_ARTIST, newArtists); }
 			/** @see ID3::Tag::artist(std::string&) */
@@ -738,12 +1085,15 @@ namespace ID3 {
 			/** @see ID3::Tag::album()
 			 *  @see ID3::Tag::textStrings(FrameID&) */
 			inline std::vector<std::string> albums() const { return textStrings(FRAME_ALBUM); }
+			/** @see ID3::Tag::album()
+			 *  @see ID3::Tag::textStringView(FrameID&) */
+			inline StringView albumView() const { return textStringView(FRAME_ALBUM); }
 			/**
 			 * Set the album tag.
 			 * 
 			 * @param newAlbum The new album.
 			 */
-			inline void album(const std::string& newAlbum) { text(FRAME_ALBUM, newAlbum); }
+			inline void album(std::string newAlbum) { text(FRAME_ALBUM, std::move(newAlbum)); }
 			/** @see ID3::Tag::album(std::string&) */
 			inline void album(const std::vector<std::string>& newAlbums) { text(FRAME_ALBUM, newAlbums); }
 			/** @see ID3::Tag::album(std::string&) */
@@ -758,12 +1108,15 @@ namespace ID3 {
 			/** @see ID3::Tag::albumArtist()
 			 *  @see ID3::Tag::textStrings(FrameID&) */
 			inline std::vector<std::string> albumArtists() const { return textStrings(FRAME_ALBUM_ARTIST); }
+			/** @see ID3::Tag::albumArtist()
+			 *  @see ID3::Tag::textStringView(FrameID&) */
+			inline StringView albumArtistView() const { return textStringView(FRAME_ALBUM_ARTIST); }
 			/**
 			 * Set the album artist/band/orchestra/accompaniment tag.
 			 * 
 			 * @param newAlbumArtist The new album artist.
 			 */
-			inline void albumArtist(const std::string& newAlbumArtist) { text(FRAME_ALBUM_ARTIST, newAlbumArtist); }
+			inline void albumArtist(std::string newAlbumArtist) { text(FRAME_ALBUM_ARTIST, std::move(newAlbumArtist)); }
 			/** @see ID3::Tag::albumArtist(std::string&) */
 			inline void albumArtist(const std::vector<std::string>& newAlbumArtists) { text(FRAME_ALBUM_ARTIST, newAlbumArtists); }
 			/** @see ID3::Tag::albumArtist(std::string&) */
@@ -896,12 +1249,18 @@ namespace ID3 {
 			/** @see ID3::Tag::composer()
 			 *  @see ID3::Tag::textStrings(FrameID&) */
 			inline std::vector<std::string> composers() const { return textStrings(FRAME_COMPOSER); }
+			/** @see ID3::Tag::composer()
+			 *  @see ID3::Tag::textStringView(FrameID&) */
+			inline StringView composerView() const { return textStringView(FRAME_COMPOSER); }
+			/** @see ID3::Tag::composers()
+			 *  @see ID3::Tag::textStringsView(FrameID&) */
+			inline SeparatedStringView composersView() const { return textStringsView(FRAME_COMPOSER); }
 			/**
 			 * Set the composer tag.
 			 * 
 			 * @param newComposer The new composer.
 			 */
-			inline void composer(const std::string& newComposer) { text(FRAME_COMPOSER, newComposer); }
+			inline void composer(std::string newComposer) { text(FRAME_COMPOSER, std::move(newComposer)); }
 			/** @see ID3::Tag::composer(std::string&) */
 			inline void composer(const std::vector<std::string>& newComposers) { text(FRAME_COMPOSER, newComposers); }
 			/** @see ID3::Tag::composer(std::string&) */
@@ -920,7 +1279,7 @@ namespace ID3 {
 			 * 
 			 * @param newBPM The new BPM.
 			 */
-			inline void bpm(const std::string& newBPM) { text(FRAME_BPM, newBPM); }
+			inline void bpm(std::string newBPM) { text(FRAME_BPM, std::move(newBPM)); }
 			/** @see ID3::Tag::bpm(std::string&) */
 			inline void bpm(const ulong newBPM) { text(FRAME_BPM, std::to_string(newBPM)); }
 			
@@ -935,7 +1294,7 @@ namespace ID3 {
 			 * 
 			 * @param newDescription The new description.
 			 */
-			inline void description(const std::string& newDescription) { text(FRAME_DESCRIPTION, newDescription); }
+			inline void description(std::string newDescription) { text(FRAME_DESCRIPTION, std::move(newDescription)); }
 			
 			/**
 			 * Get the conductor tag.
@@ -948,7 +1307,7 @@ namespace ID3 {
 			 * 
 			 * @param newConductor The new conductor.
 			 */
-			inline void conductor(const std::string& newConductor) { text(FRAME_CONDUCTOR, newConductor); }
+			inline void conductor(std::string newConductor) { text(FRAME_CONDUCTOR, std::move(newConductor)); }
 			
 			/**
 			 * Get the publisher tag.
@@ -961,7 +1320,7 @@ namespace ID3 {
 			 * 
 			 * @param newPublisher The new publisher.
 			 */
-			inline void publisher(const std::string& newPublisher) { text(FRAME_PUBLISHER, newPublisher); }
+			inline void publisher(std::string newPublisher) { text(FRAME_PUBLISHER, std::move(newPublisher)); }
 			
 			/**
 			 * Get the language of the tag.
@@ -981,7 +1340,7 @@ namespace ID3 {
 			 * 
 			 * @param newLanguage The new language.
 			 */
-			inline void language(const std::string& newLanguage) { text(FRAME_LANGUAGE, newLanguage); }
+			inline void language(std::string newLanguage) { text(FRAME_LANGUAGE, std::move(newLanguage)); }
 			/** @see ID3::Tag::language(std::string&) */
 			inline void language(const std::vector<std::string>& newLanguage) { text(FRAME_LANGUAGE, newLanguage); }
 			/** @see ID3::Tag::language(std::string&) */
@@ -1016,7 +1375,7 @@ namespace ID3 {
 			 * 
 			 * @see ID3::Tag::text(FrameID&, Text&)
 			 */
-			inline void comment(const Text& newComment) { text(FRAME_COMMENT, newComment); }
+			inline void comment(Text newComment) { text(FRAME_COMMENT, std::move(newComment)); }
 			/**
 			 * Set a specific comment tag.
 			 * 
@@ -1053,7 +1412,7 @@ namespace ID3 {
 			 * 
 			 * @see ID3::Tag::text(FrameID&, Text&)
 			 */
-			inline void lyrics(const Text& newLyrics) { text(FRAME_LYRICS, newLyrics); }
+			inline void lyrics(Text newLyrics) { text(FRAME_LYRICS, std::move(newLyrics)); }
 			/** @see ID3::Tag::lyrics(Text&)
 			 *  @see ID3::Tag::text(FrameID&, Text&, std::function&) */
 			inline void lyrics(const Text& newLyrics,
@@ -1066,7 +1425,7 @@ namespace ID3 {
 			}
 			/** @see ID3::Tag::lyrics(Text&)
 			 *  @see ID3::Tag::text(FrameID&, std::string&) */
-			inline void lyrics(const std::string& newLyrics) { text(FRAME_LYRICS, newLyrics); }
+			inline void lyrics(std::string newLyrics) { text(FRAME_LYRICS, std::move(newLyrics)); }
 			/** @see ID3::Tag::lyrics(Text&)
 			 *  @see ID3::Tag::text(FrameID&, std::string&, std::function&) */
 			inline void lyrics(const std::string& newLyrics,
@@ -1132,11 +1491,14 @@ namespace ID3 {
 			 *       Picture struct is "null", then it won't be written to file
 			 *       when calling a write() method.
 			 * 
+			 * NOTE: The Picture is taken by value, so passing a temporary or a
+			 *       std::move()-ed Picture hands its fields over without a copy.
+			 * 
 			 * @param newPicture The new picture to set.
 			 * @throws ID3::FrameSizeException when the Picture is too big to fit
 			 *         in a frame (at 256MiB).
 			 */
-			void picture(const Picture& newPicture);
+			void picture(Picture newPicture);
 			
 			/**
 			 * Get the play count.
@@ -1301,6 +1663,55 @@ namespace ID3 {
 			 */
 			ulong fileSize() const;
 			
+			/**
+			 * Hash the audio of the file the tags were read from or last written
+			 * to, which is everything after the ID3v2 tag and before the ID3v1
+			 * tags. The hash doesn't change when the tags are edited, so it can
+			 * find duplicate songs that are tagged differently. The file is read
+			 * in large chunks, not all at once.
+			 * 
+			 * NOTE: Other tags at the end of the file, such as APE tags, are
+			 *       hashed as part of the audio.
+			 * 
+			 * @return The XXH64 hash of the audio, the same as ID3::hashBytes()
+			 *         would give.
+			 * @throws ID3::FileNotFoundException if the file can't be opened or
+			 *         read.
+			 * @throws ID3::FileFormatException if the file's size has changed
+			 *         since it was read.
+			 */
+			uint64_t audioHash() const;
+			
+			/**
+			 * Get a hash of the tag's frames, to tell if two Tags have the same
+			 * content without comparing every Frame. Tags with equal frames have
+			 * the same fingerprint no matter the order of the frames, the ID3v2
+			 * version, the text encodings, or the padding. The tagging time
+			 * (TDTG) frame is ignored, since it changes on every write.
+			 * 
+			 * @return The 64-bit fingerprint.
+			 * @see ID3::Frame::fingerprint()
+			 */
+			uint64_t fingerprint() const;
+			
+			/**
+			 * Get a hash of the ID3v2 tag on the file as it is, without reading
+			 * the frames, so it works on a Tag from ID3::Tag::probe(). The
+			 * padding, the tag size, and the ID3v2.4 footer are left out of the
+			 * hash, so adding or removing padding doesn't change it.
+			 * 
+			 * NOTE: The hash is of the tag's bytes, so unlike fingerprint() it
+			 *       changes if the tag is written with another ID3v2 version or
+			 *       text encoding, or with a new tagging time.
+			 * 
+			 * @return The 64-bit hash, or 0 if the file has no ID3v2 tag.
+			 * @throws ID3::FileNotFoundException if the file can't be opened or
+			 *         read.
+			 * @throws ID3::FileFormatException if the file's size has changed
+			 *         since it was read.
+			 */
+			uint64_t rawFingerprint() const;
+			
 			/**
 			 * Print all the tag information.
 			 * 
@@ -1366,8 +1777,9 @@ namespace ID3 {
 			 * 
 			 * @param fileLoc    The file location.
 			 * @param readFrames Whether to read frames or not.
+			 * @param check      How to check the file is an MP3, MP4, or WAV file.
 			 */
-			Tag(const std::string& fileLoc, const bool readFrames);
+			Tag(const std::string& fileLoc, const bool readFrames, const FileCheck check);
 			
 			/**
 			 * Add a frame to the FrameMap. If there already exists a frame with
@@ -1449,16 +1861,57 @@ namespace ID3 {
 			 */
 			inline Text getTextStruct(const Frame* const frame) const;
 			
+			/**
+			 * Check, open, and read a file. Used by the constructors and the
+			 * methods that don't throw. The file location is only saved once the
+			 * file has been opened.
+			 * 
+			 * @param fileLoc    The file location.
+			 * @param readFrames Whether to read frames or not.
+			 * @param cache      The TagCache to read through (optional).
+			 * @return The ErrorCode of the exception to throw, if any. Exceptions
+			 *         such as std::bad_alloc may still be thrown.
+			 */
+			ErrorCode load(const std::string& fileLoc, const bool readFrames, TagCache* const cache=nullptr);
+			
+			/**
+			 * Open a file to read its tags from.
+			 * 
+			 * @param fileLoc The file location.
+			 * @param mode    How the file is read.
+			 * @return The file stream, whose fail bit is set if the file can't
+			 *         be opened.
+			 */
+			static std::unique_ptr<std::istream> openFile(const std::string& fileLoc, const ReadMode mode);
+			
+			/**
+			 * The body of write() and tryWrite().
+			 * 
+			 * @return The ErrorCode if the file can't be checked, opened, or read.
+			 *         Exceptions are still thrown for errors while writing.
+			 * @see ID3::Tag::write(std::string&, float, bool, bool, bool, bool)
+			 */
+			ErrorCode writeFile(const std::string& fileLoc,
+			                    const float        paddingFactor,
+			                    const bool         setFileNameUponSuccess,
+			                    const bool         discardNonCoverPictures,
+			                    const bool         discardUnknown,
+			                    const bool         addTaggingTime);
+			
 			/**
 			 * A constructor helper method that reads the ID3 tags from the file.
 			 * 
 			 * @param file       The file stream object.
 			 * @param readFrames Whether to read frames or not.
+			 * @return ErrorCode::FILE_FORMAT if the ID3v2 tags on file are
+			 *         supposedly bigger than the file itself.
 			 */
-			void readFile(std::istream& file, const bool readFrames=true);
+			ErrorCode readFile(std::istream& file, const bool readFrames=true);
 			
 			/**
 			 * A constructor helper method that reads the ID3v1 tags from the file.
+			 * The end of the file is read once for both ID3v1 and ID3v1 Extended
+			 * tags.
 			 * 
 			 * @param file The file stream object.
 			 * @param readFrames Whether to read frames or not.
@@ -1467,13 +1920,15 @@ namespace ID3 {
 			
 			/**
 			 * A constructor helper method that reads the ID3v2 tags from the file.
+			 * The start of the file is read once, which usually holds the whole
+			 * tag, and the rest of the tag is read with one more read if not.
 			 * 
 			 * @param file       The file stream object.
 			 * @param readFrames Whether to read frames or not.
-			 * @throws ID3::FileFormatException if the ID3v2 tags on file are
+			 * @return ErrorCode::FILE_FORMAT if the ID3v2 tags on file are
 			 *         supposedly bigger than the file itself.
 			 */
-			void readFileV2(std::istream& file, const bool readFrames=true);
+			ErrorCode readFileV2(std::istream& file, const bool readFrames=true);
 			
 			/**
 			 * A constructor helper method that gets a v1 tag struct and sets the class'
@@ -1539,6 +1994,55 @@ namespace ID3 {
 			 * @see ID3::Tag::filesize()
 			 */
 			ulong filesize;
+			
+			/**
+			 * Whether the Tag is in compact mode.
+			 * 
+			 * @see ID3::Tag::compact()
+			 */
+			bool compactFrames;
+			
+			/**
+			 * Whether frames were skipped when the tags were read.
+			 * 
+			 * @see ID3::Tag::partial()
+			 */
+			bool framesSkipped;
+			
+			/**
+			 * Whether the last write rewrote the whole file.
+			 * 
+			 * @see ID3::Tag::rewritten()
+			 */
+			bool fileRewritten;
+			
+			/**
+			 * How the text encoding of each frame is chosen when written.
+			 * 
+			 * @see ID3::Tag::encodingPolicy(EncodingPolicy)
+			 */
+			EncodingPolicy textEncodingPolicy;
+			
+			/**
+			 * How files are checked to be MP3, MP4, or WAV files.
+			 * 
+			 * @see ID3::Tag::Tag(std::string&, FileCheck)
+			 */
+			FileCheck fileCheck;
+			
+			/**
+			 * The limits on reading ID3v2 tags from file.
+			 * 
+			 * @see ID3::Tag::readLimits(ReadLimits&)
+			 */
+			ReadLimits frameLimits;
+			
+			/**
+			 * How the file is read when the Tag is created.
+			 * 
+			 * @see ID3::Tag::Tag(std::string&, ReadMode, FileCheck)
+			 */
+			ReadMode fileReadMode;
 	};
 }
 
@@ -0,0 +1,532 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <fstream>   //For std::ifstream
+#include <thread>    //For std::thread
+#include <atomic>    //For std::atomic
+#include <chrono>    //For std::chrono::steady_clock
+#include <algorithm> //For std::min and std::max
+#include <utility>   //For std::pair
+
+#include "ID3BatchEditor.hpp" //For the class definition
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * A field of a manifest line: its name, its value, whether it's null, and
+	 * whether it's a number.
+	 */
+	struct ManifestField {
+		std::string name;
+		std::string value;
+		bool        null;
+		bool        number;
+	};
+	
+	/**
+	 * Throw an exception for a malformed manifest line.
+	 */
+	[[noreturn]] void manifestError(const size_t line, const std::string& problem) {
+		throw FileFormatException("Line " + std::to_string(line) + " of the manifest: " + problem + '.');
+	}
+	
+	/**
+	 * Make an ASCII string lowercase.
+	 */
+	std::string lowercase(std::string str) {
+		for(char& c : str)
+			if(c >= 'A' && c <= 'Z') c += 'a' - 'A';
+		return str;
+	}
+	
+	/**
+	 * Read a CSV record, which is one line unless a quoted value has line
+	 * breaks in it. Quoted values may have "" for a quote.
+	 * 
+	 * @param manifest The manifest.
+	 * @param record   Where to put the values.
+	 * @param line     The current line number, which is updated.
+	 * @return false if there are no more records, true otherwise.
+	 * @throws ID3::FileFormatException if a quoted value isn't closed.
+	 */
+	bool readCSVRecord(std::istream& manifest, std::vector<std::string>& record, size_t& line) {
+		record.clear();
+		std::string text;
+		if(!std::getline(manifest, text)) return false;
+		line++;
+		const size_t START_LINE = line;
+		
+		std::string value;
+		size_t pos = 0;
+		while(true) {
+			if(pos < text.size() && text[pos] == '"') {
+				//A quoted value, which may go on for several lines
+				pos++;
+				while(true) {
+					const size_t QUOTE = text.find('"', pos);
+					if(QUOTE == std::string::npos) {
+						value.append(text, pos, std::string::npos);
+						if(!std::getline(manifest, text)) manifestError(START_LINE, "a quoted value isn't closed");
+						line++;
+						value += '\n';
+						pos = 0;
+						continue;
+					}
+					value.append(text, pos, QUOTE - pos);
+					pos = QUOTE + 1;
+					if(pos < text.size() && text[pos] == '"') {
+						value += '"';
+						pos++;
+					} else { break; }
+				}
+			}
+			
+			//The rest of an unquoted value, or anything after a closing quote
+			const size_t END = std::min(text.find(',', pos), text.size());
+			value.append(text, pos, END - pos);
+			if(END == text.size() && !value.empty() && value.back() == '\r') value.pop_back();
+			record.push_back(std::move(value));
+			value.clear();
+			if(END == text.size()) return true;
+			pos = END + 1;
+		}
+	}
+	
+	/**
+	 * Append a Unicode code point to a string as UTF-8.
+	 */
+	void appendUTF8(std::string& str, const uint32_t codePoint) {
+		if(codePoint < 0x80) {
+			str += static_cast<char>(codePoint);
+		} else if(codePoint < 0x800) {
+			str += static_cast<char>(0xC0 | codePoint >> 6);
+			str += static_cast<char>(0x80 | (codePoint & 0x3F));
+		} else if(codePoint < 0x10000) {
+			str += static_cast<char>(0xE0 | codePoint >> 12);
+			str += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+			str += static_cast<char>(0x80 | (codePoint & 0x3F));
+		} else {
+			str += static_cast<char>(0xF0 | codePoint >> 18);
+			str += static_cast<char>(0x80 | (codePoint >> 12 & 0x3F));
+			str += static_cast<char>(0x80 | (codePoint >> 6 & 0x3F));
+			str += static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+	}
+	
+	/**
+	 * A parser for one NDJSON manifest line, which must be a flat JSON object
+	 * whose values are strings, numbers, or null.
+	 */
+	class ManifestLineParser {
+		public:
+			ManifestLineParser(const std::string& lineText, const size_t lineNumber) : text(lineText),
+			                                                                         pos(0),
+			                                                                         line(lineNumber) {}
+			
+			/**
+			 * Parse the line.
+			 * 
+			 * @param fields Where to put the fields.
+			 * @throws ID3::FileFormatException if the line is malformed.
+			 */
+			void parse(std::vector<ManifestField>& fields) {
+				fields.clear();
+				expect('{');
+				if(peek() == '}') {
+					pos++;
+				} else {
+					while(true) {
+						ManifestField field;
+						field.name = readString();
+						expect(':');
+						readValue(field);
+						fields.push_back(std::move(field));
+						const char NEXT = peek();
+						pos++;
+						if(NEXT == '}') break;
+						if(NEXT != ',') fail("expected ',' or '}'");
+					}
+				}
+				if(peek() != '\0') fail("unexpected text after the object");
+			}
+		
+		private:
+			[[noreturn]] void fail(const char* const problem) { manifestError(line, problem); }
+			
+			/**
+			 * @return The next character that isn't whitespace, or '\0' at the
+			 *         end of the line.
+			 */
+			char peek() {
+				while(pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r')) pos++;
+				return pos < text.size() ? text[pos] : '\0';
+			}
+			
+			void expect(const char c) {
+				if(peek() != c) fail(c == '{' ? "expected a JSON object" : "expected ':'");
+				pos++;
+			}
+			
+			/**
+			 * Read four hexadecimal digits of a \u escape.
+			 */
+			uint32_t readHex() {
+				if(pos + 4 > text.size()) fail("incomplete \\u escape");
+				uint32_t value = 0;
+				for(size_t end = pos + 4; pos < end; pos++) {
+					const char c = text[pos];
+					value <<= 4;
+					if(c >= '0' && c <= '9')      value |= c - '0';
+					else if(c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+					else if(c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+					else fail("invalid \\u escape");
+				}
+				return value;
+			}
+			
+			std::string readString() {
+				if(peek() != '"') fail("expected a string");
+				pos++;
+				std::string str;
+				while(true) {
+					//Copy the run of characters that aren't escaped at once
+					const size_t END = text.find_first_of("\"\\", pos);
+					if(END == std::string::npos) fail("a string isn't closed");
+					str.append(text, pos, END - pos);
+					pos = END + 1;
+					if(text[END] == '"') return str;
+					
+					if(pos >= text.size()) fail("a string isn't closed");
+					const char ESCAPE = text[pos++];
+					switch(ESCAPE) {
+						case '"':  str += '"';  break;
+						case '\\': str += '\\'; break;
+						case '/':  str += '/';  break;
+						case 'b':  str += '\b'; break;
+						case 'f':  str += '\f'; break;
+						case 'n':  str += '\n'; break;
+						case 'r':  str += '\r'; break;
+						case 't':  str += '\t'; break;
+						case 'u': {
+							uint32_t codePoint = readHex();
+							//A UTF-16 surrogate pair is two escapes
+							if(codePoint >= 0xD800 && codePoint < 0xDC00 &&
+							   text.compare(pos, 2, "\\u") == 0) {
+								pos += 2;
+								const uint32_t LOW = readHex();
+								if(LOW < 0xDC00 || LOW >= 0xE000) fail("invalid UTF-16 surrogate pair");
+								codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (LOW - 0xDC00);
+							} else if(codePoint >= 0xD800 && codePoint < 0xE000) {
+								fail("invalid UTF-16 surrogate pair");
+							}
+							appendUTF8(str, codePoint);
+							break;
+						}
+						default: fail("invalid escape in a string");
+					}
+				}
+			}
+			
+			/**
+			 * Read a number, which must follow the JSON number grammar. It's
+			 * kept as it's written.
+			 */
+			std::string readNumber() {
+				const size_t START = pos;
+				if(text[pos] == '-') pos++;
+				//The integer part has no leading zeros
+				if(pos < text.size() && text[pos] == '0') pos++;
+				else if(readDigits() == 0) fail("invalid number");
+				if(pos < text.size() && text[pos] == '.') {
+					pos++;
+					if(readDigits() == 0) fail("invalid number");
+				}
+				if(pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+					pos++;
+					if(pos < text.size() && (text[pos] == '+' || text[pos] == '-')) pos++;
+					if(readDigits() == 0) fail("invalid number");
+				}
+				return text.substr(START, pos - START);
+			}
+			
+			/**
+			 * @return The number of decimal digits read.
+			 */
+			size_t readDigits() {
+				const size_t START = pos;
+				while(pos < text.size() && text[pos] >= '0' && text[pos] <= '9') pos++;
+				return pos - START;
+			}
+			
+			void readValue(ManifestField& field) {
+				field.null = false;
+				field.number = false;
+				const char FIRST = peek();
+				if(FIRST == '"') {
+					field.value = readString();
+				} else if(FIRST == '-' || (FIRST >= '0' && FIRST <= '9')) {
+					field.value = readNumber();
+					field.number = true;
+				} else if(text.compare(pos, 4, "null") == 0) {
+					field.null = true;
+					pos += 4;
+				} else {
+					fail("values must be strings, numbers, or null");
+				}
+			}
+			
+			const std::string& text;
+			size_t pos;
+			size_t line;
+	};
+}
+
+///@pkg ID3BatchEditor.h
+double BatchReport::filesPerSecond() const {
+	return seconds > 0 ? files.size() / seconds : 0;
+}
+
+///@pkg ID3BatchEditor.h
+void BatchEditor::add(const std::string& fileLoc, const std::string& field, std::string value) {
+	Edit edit;
+	edit.value = std::move(value);
+	if(!parseField(field, edit)) throw FileFormatException("\"" + field + "\" isn't a field that can be edited.");
+	addEdit(fileLoc, std::move(edit));
+}
+
+///@pkg ID3BatchEditor.h
+bool BatchEditor::parseField(const std::string& field, Edit& edit) {
+	static const std::pair<const char*, FrameID> TEXT_FIELDS[] = {{"title",       FRAME_TITLE},
+	                                                              {"artist",      FRAME_ARTIST},
+	                                                              {"album",       FRAME_ALBUM},
+	                                                              {"albumartist", FRAME_ALBUM_ARTIST},
+	                                                              {"genre",       FRAME_GENRE},
+	                                                              {"composer",    FRAME_COMPOSER},
+	                                                              {"bpm",         FRAME_BPM},
+	                                                              {"comment",     FRAME_COMMENT}};
+	static const std::pair<const char*, EditKind> NUMBER_FIELDS[] = {{"year",       EditKind::YEAR},
+	                                                                 {"track",      EditKind::TRACK},
+	                                                                 {"tracktotal", EditKind::TRACK_TOTAL},
+	                                                                 {"disc",       EditKind::DISC},
+	                                                                 {"disctotal",  EditKind::DISC_TOTAL}};
+	
+	edit.kind = EditKind::TEXT;
+	edit.description.clear();
+	const std::string NAME = lowercase(field);
+	bool found = false;
+	for(const auto& textField : TEXT_FIELDS) {
+		if(NAME != textField.first) continue;
+		edit.frameID = textField.second;
+		found = true;
+		break;
+	}
+	for(const auto& numberField : NUMBER_FIELDS) {
+		if(found || NAME != numberField.first) continue;
+		edit.kind = numberField.second;
+		found = true;
+	}
+	if(!found && NAME.compare(0, 5, "txxx:") == 0) {
+		edit.kind = EditKind::USER_TEXT;
+		edit.frameID = FRAME_USER_DEFINED_TEXT;
+		edit.description = field.substr(5);
+		found = true;
+	} else if(!found && NAME.size() == 4) {
+		std::string frameName = field;
+		for(char& c : frameName)
+			if(c >= 'a' && c <= 'z') c -= 'a' - 'A';
+		edit.frameID = FrameID(frameName);
+		switch(edit.frameID.unknown() ? FrameClass::CLASS_UNKNOWN : edit.frameID.metadata().frameClass) {
+			case FrameClass::CLASS_TEXT:
+			case FrameClass::CLASS_NUMERICAL:
+			case FrameClass::CLASS_DESCRIPTIVE:
+			case FrameClass::CLASS_URL:
+				found = true;
+				break;
+			default:
+				break;
+		}
+	}
+	return found;
+}
+
+///@pkg ID3BatchEditor.h
+void BatchEditor::addEdit(const std::string& fileLoc, Edit edit) {
+	const auto inserted = fileIndex.emplace(fileLoc, files.size());
+	if(inserted.second) files.push_back(FileEdits{fileLoc, {}});
+	files[inserted.first->second].edits.push_back(std::move(edit));
+}
+
+///@pkg ID3BatchEditor.h
+size_t BatchEditor::loadCSV(std::istream& manifest) {
+	size_t line = 0, added = 0;
+	std::vector<std::string> header, record;
+	if(!readCSVRecord(manifest, header, line)) return 0;
+	if(!header.empty() && header[0].compare(0, 3, "\xEF\xBB\xBF") == 0) header[0].erase(0, 3);
+	if(header.empty() || lowercase(header[0]) != "path")
+		manifestError(1, "the header must start with \"path\"");
+	const bool LONG_FORMAT = header.size() == 3 && lowercase(header[1]) == "field" && lowercase(header[2]) == "value";
+	
+	while(true) {
+		const size_t RECORD_LINE = line + 1;
+		if(!readCSVRecord(manifest, record, line)) return added;
+		if(record.size() == 1 && record[0].empty()) continue;
+		if(record.size() != header.size()) manifestError(RECORD_LINE, "the row has the wrong number of values");
+		if(record[0].empty()) manifestError(RECORD_LINE, "the path is empty");
+		
+		for(size_t i = LONG_FORMAT ? 2 : 1; i < record.size(); i++) {
+			if(!LONG_FORMAT && record[i].empty()) continue;
+			const std::string& field = LONG_FORMAT ? record[1] : header[i];
+			Edit edit;
+			edit.value = std::move(record[i]);
+			if(!parseField(field, edit))
+				manifestError(RECORD_LINE, "\"" + field + "\" isn't a field that can be edited");
+			addEdit(record[0], std::move(edit));
+			added++;
+		}
+	}
+}
+
+///@pkg ID3BatchEditor.h
+size_t BatchEditor::loadNDJSON(std::istream& manifest) {
+	size_t line = 0, added = 0;
+	std::string text;
+	std::vector<ManifestField> fields;
+	while(std::getline(manifest, text)) {
+		line++;
+		if(text.find_first_not_of(" \t\r") == std::string::npos) continue;
+		ManifestLineParser(text, line).parse(fields);
+		
+		std::string path;
+		for(const ManifestField& field : fields)
+			if(field.name == "path" && !field.null) path = field.value;
+		if(path.empty()) manifestError(line, "the object has no \"path\"");
+		
+		for(ManifestField& field : fields) {
+			if(field.name == "path") continue;
+			Edit edit;
+			edit.value = std::move(field.value);
+			if(!parseField(field.name, edit))
+				manifestError(line, "\"" + field.name + "\" isn't a field that can be edited");
+			
+			//A number for a numeric field has to be a whole number, as the
+			//setters would remove the field for any other number
+			const bool NUMERIC_FIELD = edit.kind != EditKind::USER_TEXT &&
+			                           (edit.kind != EditKind::TEXT ||
+			                            edit.frameID.metadata().frameClass == FrameClass::CLASS_NUMERICAL);
+			if(field.number && NUMERIC_FIELD && edit.value.find_first_not_of("0123456789") != std::string::npos)
+				manifestError(line, "\"" + field.name + "\" must be a non-negative integer");
+			addEdit(path, std::move(edit));
+			added++;
+		}
+	}
+	return added;
+}
+
+///@pkg ID3BatchEditor.h
+size_t BatchEditor::load(const std::string& manifestLoc) {
+	std::ifstream manifest(manifestLoc, std::ios::binary);
+	if(!manifest.is_open())
+		throw FileNotFoundException("Cannot open the manifest \"" + manifestLoc + "\".");
+	
+	const size_t DOT = manifestLoc.find_last_of("./");
+	const std::string EXTENSION = DOT != std::string::npos && manifestLoc[DOT] == '.' ?
+	                              lowercase(manifestLoc.substr(DOT + 1)) : "";
+	if(EXTENSION == "ndjson" || EXTENSION == "jsonl" || EXTENSION == "json")
+		return loadNDJSON(manifest);
+	return loadCSV(manifest);
+}
+
+///@pkg ID3BatchEditor.h
+BatchReport BatchEditor::run(const BatchOptions& options) const {
+	BatchReport report;
+	report.files.resize(files.size());
+	const auto START = std::chrono::steady_clock::now();
+	
+	//Each thread takes the next file until there are none left
+	std::atomic<size_t> next(0);
+	const auto editFiles = [&]() {
+		for(size_t i = next++; i < files.size(); i = next++)
+			editFile(files[i], options, report.files[i]);
+	};
+	
+	size_t threadCount = options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+	threadCount = std::max<size_t>(1, std::min(threadCount, files.size()));
+	std::vector<std::thread> workers;
+	for(size_t i = 1; i < threadCount; i++)
+		workers.emplace_back(editFiles);
+	editFiles();
+	for(std::thread& worker : workers)
+		worker.join();
+	
+	report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+	for(const BatchResult& result : report.files) {
+		if(result.error != ErrorCode::NONE) report.failed++;
+		else if(!result.written)            report.unchanged++;
+		else                                report.written++;
+		if(result.rewritten) report.rewritten++;
+	}
+	return report;
+}
+
+///@pkg ID3BatchEditor.h
+size_t BatchEditor::size() const { return files.size(); }
+
+///@pkg ID3BatchEditor.h
+void BatchEditor::clear() {
+	files.clear();
+	fileIndex.clear();
+}
+
+///@pkg ID3BatchEditor.h
+void BatchEditor::editFile(const FileEdits& file, const BatchOptions& options, BatchResult& result) noexcept {
+	result.path = file.path;
+	result.edits = file.edits.size();
+	
+	Tag tag;
+	result.error = Tag::open(file.path, tag, options.check);
+	if(result.error != ErrorCode::NONE) return;
+	const uint64_t OLD_FINGERPRINT = tag.fingerprint();
+	
+	try {
+		for(const Edit& edit : file.edits) {
+			switch(edit.kind) {
+				case EditKind::TEXT:        tag.text(edit.frameID, edit.value); break;
+				case EditKind::YEAR:        tag.year(edit.value);               break;
+				case EditKind::TRACK:       tag.track(edit.value);              break;
+				case EditKind::TRACK_TOTAL: tag.trackTotal(edit.value);         break;
+				case EditKind::DISC:        tag.disc(edit.value);               break;
+				case EditKind::DISC_TOTAL:  tag.discTotal(edit.value);          break;
+				case EditKind::USER_TEXT: {
+					const std::string& description = edit.description;
+					tag.text(edit.frameID,
+					         Text(edit.value, description),
+					         [&description](const Text& userText) { return userText.description == description; });
+				}
+			}
+		}
+		
+		//Edits that set the values they already had don't need a write
+		if(tag.fingerprint() == OLD_FINGERPRINT) return;
+	} catch(...) {
+		result.error = ErrorCode::OTHER;
+		return;
+	}
+	
+	if(options.session != nullptr)
+		result.error = options.session->write(tag, file.path, options.paddingFactor, false, false, options.addTaggingTime);
+	else
+		result.error = tag.tryWrite(file.path, options.paddingFactor, true, false, false, options.addTaggingTime);
+	result.written = result.error == ErrorCode::NONE;
+	result.rewritten = result.written && tag.rewritten();
+}
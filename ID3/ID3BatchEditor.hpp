@@ -0,0 +1,306 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_BATCH_EDITOR_HPP
+#define ID3_BATCH_EDITOR_HPP
+
+#include <string>        //For std::string
+#include <vector>        //For std::vector
+#include <unordered_map> //For std::unordered_map
+#include <istream>       //For std::istream
+#include <cstdint>       //For uint8_t
+
+#include "ID3.hpp"             //For Tag and FileCheck
+#include "ID3Exception.hpp"    //For ErrorCode
+#include "ID3FrameID.hpp"      //For FrameID
+#include "ID3WriteSession.hpp" //For WriteSession
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * BatchOptions chooses how a BatchEditor writes the files.
+	 * 
+	 * @see ID3::BatchEditor::run()
+	 */
+	struct BatchOptions {
+		/**
+		 * How many files are edited at once, or 0 for one per processor core.
+		 */
+		unsigned threads = 0;
+		
+		/**
+		 * The padding factor of files whose tags have to be rewritten.
+		 * 
+		 * @see ID3::Tag::write(std::string&, float, bool, bool, bool, bool)
+		 */
+		float paddingFactor = 0.1;
+		
+		/**
+		 * How the files are checked before they are read.
+		 */
+		FileCheck check = FileCheck::EXTENSION;
+		
+		/**
+		 * Whether to set the tagging time frame of the files written.
+		 */
+		bool addTaggingTime = true;
+		
+		/**
+		 * The WriteSession to add the files written to, so that they can be
+		 * made durable together with WriteSession::commit() after the run, or
+		 * nullptr to not sync them.
+		 */
+		WriteSession* session = nullptr;
+	};
+	
+	/**
+	 * The result of editing one file.
+	 */
+	struct BatchResult {
+		/**
+		 * The file path.
+		 */
+		std::string path;
+		
+		/**
+		 * ErrorCode::NONE if the file was edited, or why it couldn't be read
+		 * or written.
+		 */
+		ErrorCode error = ErrorCode::NONE;
+		
+		/**
+		 * The number of edits to the file in the manifest.
+		 */
+		size_t edits = 0;
+		
+		/**
+		 * Whether the file was written. It isn't if it failed or if the edits
+		 * didn't change its tags.
+		 */
+		bool written = false;
+		
+		/**
+		 * Whether the whole file had to be rewritten because the new tags
+		 * didn't fit in the old tags' padding, instead of only the tags being
+		 * written over in place.
+		 */
+		bool rewritten = false;
+	};
+	
+	/**
+	 * The results of a BatchEditor run.
+	 */
+	struct BatchReport {
+		/**
+		 * The result of each file, in the order the files were first added.
+		 */
+		std::vector<BatchResult> files;
+		
+		/**
+		 * The number of files written, how many of those were rewritten, how
+		 * many didn't need to be written, and how many failed.
+		 */
+		size_t written   = 0;
+		size_t rewritten = 0;
+		size_t unchanged = 0;
+		size_t failed    = 0;
+		
+		/**
+		 * How long the run took, in seconds.
+		 */
+		double seconds = 0;
+		
+		/**
+		 * @return The number of files handled per second.
+		 */
+		double filesPerSecond() const;
+	};
+	
+	/**
+	 * BatchEditor applies a manifest of tag edits to many files at once.
+	 * 
+	 * The edits are grouped by file, so each file is read and written once
+	 * however many of its fields are edited, and the files are edited on a
+	 * fixed number of threads. A file whose tags don't change isn't written.
+	 * A file whose new tags fit in its padding has only its tags written over
+	 * in place, and the rest are rewritten with new padding so that later
+	 * edits can be done in place.
+	 * 
+	 * A field is one of "title", "artist", "album", "albumartist", "genre",
+	 * "composer", "bpm", "comment", "year", "track", "tracktotal", "disc",
+	 * and "disctotal", an ID3v2 text frame ID such as "TPE3", or "TXXX:"
+	 * followed by the description of a user-defined text frame. Fields are
+	 * case-insensitive, except for the TXXX description. An empty value
+	 * removes the field.
+	 * 
+	 * A manifest is either CSV or NDJSON. A CSV manifest starts with a header
+	 * row. If the header is "path,field,value", each row is one edit.
+	 * Otherwise, the first column is the path and every other column is a
+	 * field, and empty cells are left alone:
+	 * 
+	 *     path,field,value             path,title,year
+	 *     a.mp3,title,Intro            a.mp3,Intro,2016
+	 *     a.mp3,year,2016              b.mp3,,2015
+	 * 
+	 * An NDJSON manifest has one object per line, with a "path" and the
+	 * fields to edit. Values are strings or numbers, and null removes the
+	 * field. Numbers for numeric fields, such as "track", "year", and "bpm",
+	 * must be non-negative integers:
+	 * 
+	 *     {"path":"a.mp3","title":"Intro","year":2016,"TXXX:Mood":null}
+	 */
+	class BatchEditor {
+		public:
+			/**
+			 * Add an edit.
+			 * 
+			 * @param fileLoc The file path.
+			 * @param field   The field to edit (see above).
+			 * @param value   The new value, or an empty string to remove the
+			 *                field.
+			 * @throws ID3::FileFormatException if the field isn't one that can
+			 *         be edited.
+			 */
+			void add(const std::string& fileLoc, const std::string& field, std::string value);
+			
+			/**
+			 * Add the edits of a CSV manifest.
+			 * 
+			 * @param manifest The manifest.
+			 * @return The number of edits added.
+			 * @throws ID3::FileFormatException if the manifest is malformed, with
+			 *         the line number. The edits before the line are kept.
+			 */
+			size_t loadCSV(std::istream& manifest);
+			
+			/**
+			 * Add the edits of an NDJSON manifest.
+			 * 
+			 * @param manifest The manifest.
+			 * @return The number of edits added.
+			 * @throws ID3::FileFormatException if the manifest is malformed, with
+			 *         the line number. The edits before the line are kept.
+			 */
+			size_t loadNDJSON(std::istream& manifest);
+			
+			/**
+			 * Add the edits of a manifest file, which is read as NDJSON if its
+			 * extension is ".ndjson", ".jsonl", or ".json", and as CSV
+			 * otherwise.
+			 * 
+			 * @param manifestLoc The manifest file location.
+			 * @return The number of edits added.
+			 * @throws ID3::FileNotFoundException if the file can't be opened.
+			 * @throws ID3::FileFormatException if the manifest is malformed.
+			 */
+			size_t load(const std::string& manifestLoc);
+			
+			/**
+			 * Edit and write every file.
+			 * 
+			 * NOTE: The files are written while other threads are reading and
+			 *       writing other files, so the same file shouldn't be added
+			 *       under two different paths.
+			 * 
+			 * @param options How to write the files (optional).
+			 * @return The result of each file and the totals.
+			 */
+			BatchReport run(const BatchOptions& options=BatchOptions()) const;
+			
+			/**
+			 * @return The number of files to edit.
+			 */
+			size_t size() const;
+			
+			/**
+			 * Remove every edit.
+			 */
+			void clear();
+		
+		private:
+			/**
+			 * An enum of the ways an edit sets a field.
+			 */
+			enum class EditKind : uint8_t {
+				TEXT,        //Set the first frame with the frame ID
+				USER_TEXT,   //Set the user-defined text frame with the description
+				YEAR,        //ID3::Tag::year()
+				TRACK,       //ID3::Tag::track()
+				TRACK_TOTAL, //ID3::Tag::trackTotal()
+				DISC,        //ID3::Tag::disc()
+				DISC_TOTAL   //ID3::Tag::discTotal()
+			};
+			
+			/**
+			 * One edit of one field.
+			 */
+			struct Edit {
+				EditKind    kind;
+				FrameID     frameID;
+				std::string description;
+				std::string value;
+			};
+			
+			/**
+			 * The edits of one file, in the order they were added.
+			 */
+			struct FileEdits {
+				std::string       path;
+				std::vector<Edit> edits;
+			};
+			
+			/**
+			 * Find the edit kind and frame of a field.
+			 * 
+			 * @param field The field name (see above).
+			 * @param edit  The edit to set the kind, frame ID, and description
+			 *              of.
+			 * @return false if the field isn't one that can be edited, true
+			 *         otherwise.
+			 */
+			static bool parseField(const std::string& field, Edit& edit);
+			
+			/**
+			 * Add an edit to a file's edits.
+			 * 
+			 * @param fileLoc The file path.
+			 * @param edit    The edit.
+			 */
+			void addEdit(const std::string& fileLoc, Edit edit);
+			
+			/**
+			 * Edit and write one file.
+			 * 
+			 * @param file    The file's edits.
+			 * @param options How to write the file.
+			 * @param result  Where to put the result.
+			 */
+			static void editFile(const FileEdits& file, const BatchOptions& options, BatchResult& result) noexcept;
+			
+			/**
+			 * The files to edit, and the index of each file path in it.
+			 */
+			std::vector<FileEdits> files;
+			std::unordered_map<std::string, size_t> fileIndex;
+	};
+}
+
+#endif
@@ -15,6 +15,20 @@
 
 using namespace ID3;
 
+///@pkg ID3Exception.hpp
+const char* ID3::errorString(const ErrorCode error) noexcept {
+	switch(error) {
+		case ErrorCode::NONE:           return "No error";
+		case ErrorCode::FILE_NOT_FOUND: return "The file cannot be opened";
+		case ErrorCode::NOT_MP3_FILE:   return "The file is not an MP3, MP4, or WAV file";
+		case ErrorCode::FILE_FORMAT:    return "The tags on file are incorrectly formatted";
+		case ErrorCode::TAG_SIZE:       return "The tag exceeds the maximum size";
+		case ErrorCode::FRAME_SIZE:     return "A frame exceeds the maximum size";
+		case ErrorCode::WRITE:          return "The tags cannot be written to the file";
+		case ErrorCode::OTHER: default: return "Unknown error";
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////  E X C E P T I O N //////////////////////////////
@@ -16,6 +16,7 @@
 #include <exception> //For std::exception
 #include <string>    //For strings
 #include <vector>    //For vectors
+#include <cstdint>   //For uint8_t
 
 /**
  * The ID3 namespace defines everything related to reading and writing
@@ -28,6 +29,30 @@
  * @see ID3.h
  */
 namespace ID3 {
+	/**
+	 * An enum of the errors returned by the methods that don't throw
+	 * exceptions, such as ID3::Tag::open(). Each one matches the exception
+	 * the throwing method would have thrown.
+	 */
+	enum class ErrorCode : uint8_t {
+		NONE,           //No error
+		FILE_NOT_FOUND, //FileNotFoundException
+		NOT_MP3_FILE,   //NotMP3FileException
+		FILE_FORMAT,    //FileFormatException
+		TAG_SIZE,       //TagSizeException
+		FRAME_SIZE,     //FrameSizeException
+		WRITE,          //WriteException
+		OTHER           //Any other exception, such as std::bad_alloc
+	};
+	
+	/**
+	 * Get a short description of an ErrorCode. It doesn't allocate memory.
+	 * 
+	 * @param error The ErrorCode.
+	 * @return A static, null-terminated description.
+	 */
+	const char* errorString(const ErrorCode error) noexcept;
+	
 	/**
 	 * The base exception class.
 	 */
@@ -10,6 +10,8 @@
  * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
  **********************************************************************/
 
+#include <algorithm> //For std::min
+
 #include "ID3FrameFactory.hpp"            //For the class definition
 #include "Frames/ID3TextFrame.hpp"        //For TextFrame
 #include "Frames/ID3PictureFrame.hpp"     //For PictureFrame and PictureType
@@ -20,12 +22,60 @@
 
 using namespace ID3;
 
+namespace {
+	/**
+	 * Get the biggest size a frame can be under the ReadLimits, including its
+	 * header. For text frames it depends on the text encoding, so the encoding
+	 * byte is peeked at without moving the read position.
+	 * 
+	 * @param frameType The class the frame would be.
+	 * @param file      The file, positioned right after the frame header.
+	 * @param limits    The limits to apply.
+	 * @return The maximum frame size in bytes.
+	 */
+	static ulong frameSizeLimit(const FrameClass  frameType,
+	                            std::istream&     file,
+	                            const ReadLimits& limits) {
+		//The most UTF-8 bytes that can be decoded from one byte of text
+		//is 2 for LATIN-1, 1.5 for UTF-16, and 1 for UTF-8
+		ulong maxTextBytes;
+		switch(frameType) {
+			case FrameClass::CLASS_PICTURE:
+				return limits.pictureSize;
+			case FrameClass::CLASS_URL:
+				maxTextBytes = limits.textSize / 2;
+				break;
+			case FrameClass::CLASS_TEXT:
+			case FrameClass::CLASS_NUMERICAL:
+			case FrameClass::CLASS_DESCRIPTIVE:
+				switch(file.peek()) {
+					case ENCODING_UTF16BOM:
+					case ENCODING_UTF16:
+						maxTextBytes = limits.textSize / 3 * 2; break;
+					case ENCODING_UTF8:
+						maxTextBytes = limits.textSize; break;
+					default:
+						maxTextBytes = limits.textSize / 2;
+				}
+				break;
+			default:
+				return limits.frameSize;
+		}
+		
+		//Add the header and the encoding byte
+		return std::min(limits.frameSize, maxTextBytes + HEADER_BYTE_SIZE + 1);
+	}
+
+}
+
 ///@pkg ID3FrameFactory.h
-FrameFactory::FrameFactory(std::istream&  file,
-                           const ushort   version,
-                           const ulong    tagEnd) : musicFile(&file),
-                                                    ID3Ver(version),
-                                                    ID3Size(tagEnd) {}
+FrameFactory::FrameFactory(std::istream&     file,
+                           const ushort      version,
+                           const ulong       tagEnd,
+                           const ReadLimits& limits) : musicFile(&file),
+                                                       ID3Ver(version),
+                                                       ID3Size(tagEnd),
+                                                       readLimits(limits) {}
 
 ///@pkg ID3FrameFactory.h	                                              
 FrameFactory::FrameFactory(const ushort version) : musicFile(nullptr),
@@ -38,7 +88,7 @@ FrameFactory::FrameFactory() : musicFile(nullptr),
                                ID3Size(0) {}
 
 ///@pkg ID3FrameFactory.h
-FramePtr FrameFactory::create(const ulong readpos) const {
+FramePtr FrameFactory::create(const ulong readpos, const ulong maxSize) const {
 	//Validate the file
 	if(readpos + HEADER_BYTE_SIZE > ID3Size || musicFile == nullptr || !musicFile->good())
 		return FramePtr(new UnknownFrame());
@@ -59,9 +109,11 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 	//ID3v2.2 and below have a different frame header structure, so they need to
 	//be read differently
 	if(ID3Ver >= 3) {
-		//Read the frame header
+		//Read the frame header. Frames that are cut short by the end of the
+		//stream aren't read.
 		FrameHeader header;
 		musicFile->read(reinterpret_cast<char*>(&header), HEADER_BYTE_SIZE);
+		if(static_cast<ulong>(musicFile->gcount()) != HEADER_BYTE_SIZE) return FramePtr(new UnknownFrame());
 		
 		//Get the size of the frame
 		ulong frameSize = byteIntVal(header.size, 4, ID3Ver >= 4);
@@ -74,13 +126,18 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 		id = terminatedstring(header.id, 4);
 		
 		//Get the class the Frame should be
-		frameType = FrameFactory::frameType(id);
+		frameType = id.metadata().frameClass;
+		
+		//Skip the frame without reading it if it's over the limits
+		if(frameSize + HEADER_BYTE_SIZE > std::min(maxSize, frameSizeLimit(frameType, *musicFile, readLimits)))
+			return skippedFrame(id, frameSize + HEADER_BYTE_SIZE, readpos);
 		
 		//Create the ByteArray with the entire frame contents
 		frameBytes = ByteArray(frameSize + HEADER_BYTE_SIZE, '\0');
 		musicFile->seekg(readpos, std::ifstream::beg);
 		if(musicFile->fail()) return FramePtr(new UnknownFrame(id));
 		musicFile->read(reinterpret_cast<char*>(&frameBytes.front()), frameSize + HEADER_BYTE_SIZE);
+		if(static_cast<ulong>(musicFile->gcount()) != frameSize + HEADER_BYTE_SIZE) return FramePtr(new UnknownFrame(id));
 	} else {
 		//The ID3v2.2 frame header has 6 bytes instead of 10
 		const ushort OLD_FRAME_HEADER_BYTE_SIZE = sizeof(V2FrameHeader);
@@ -88,6 +145,7 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 		//Read the frame header
 		V2FrameHeader header;
 		musicFile->read(reinterpret_cast<char*>(&header), OLD_FRAME_HEADER_BYTE_SIZE);
+		if(static_cast<ulong>(musicFile->gcount()) != OLD_FRAME_HEADER_BYTE_SIZE) return FramePtr(new UnknownFrame());
 		
 		//Get the size of the frame
 		ulong frameSize = byteIntVal(header.size, 3, false);
@@ -100,7 +158,12 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 		id = FrameID(terminatedstring(header.id, 4), ID3Ver);
 		
 		//Get the class the Frame should be
-		frameType = FrameFactory::frameType(id);
+		frameType = id.metadata().frameClass;
+		
+		//Skip the frame without reading it if it's over the limits. The frame
+		//size is counted as it would be once converted to ID3v2.4.
+		if(frameSize + HEADER_BYTE_SIZE > std::min(maxSize, frameSizeLimit(frameType, *musicFile, readLimits)))
+			return skippedFrame(id, frameSize + HEADER_BYTE_SIZE, readpos);
 		
 		//Create the ByteArray with room for the entire frame content, if it were
 		//a new ID3v2 tag
@@ -110,6 +173,7 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 		
 		//Get the frame bytes, reserving the first four bytes in the ByteArray
 		musicFile->read(reinterpret_cast<char*>(&frameBytes.front()+4), frameSize + OLD_FRAME_HEADER_BYTE_SIZE);
+		if(static_cast<ulong>(musicFile->gcount()) != frameSize + OLD_FRAME_HEADER_BYTE_SIZE) return FramePtr(new UnknownFrame(id));
 		
 		//===========================================
 		//Reconstruct the header as an ID3v2.4 header
@@ -130,49 +194,64 @@ FramePtr FrameFactory::create(const ulong readpos) const {
 		frameBytes[9] = 0;
 	}
 	
-	//Return the Frame
+	//Create the Frame
+	FramePtr frame;
 	switch(frameType) {
 		case FrameClass::CLASS_TEXT:
-			return FramePtr(new TextFrame(id, ID3Ver, frameBytes));
+			frame = FramePtr(new TextFrame(id, ID3Ver, frameBytes)); break;
 		case FrameClass::CLASS_NUMERICAL:
-			return FramePtr(new NumericalTextFrame(id, ID3Ver, frameBytes));
+			frame = FramePtr(new NumericalTextFrame(id, ID3Ver, frameBytes)); break;
 		case FrameClass::CLASS_DESCRIPTIVE:
-			return FramePtr(new DescriptiveTextFrame(id, ID3Ver, frameBytes, frameOptions(id)));
+			frame = FramePtr(new DescriptiveTextFrame(id, ID3Ver, frameBytes, id.metadata().options)); break;
 		case FrameClass::CLASS_URL:
-			return FramePtr(new URLTextFrame(id, ID3Ver, frameBytes));
+			frame = FramePtr(new URLTextFrame(id, ID3Ver, frameBytes)); break;
 		case FrameClass::CLASS_PICTURE:
-			return FramePtr(new PictureFrame(ID3Ver, frameBytes));
+			frame = FramePtr(new PictureFrame(ID3Ver, frameBytes)); break;
 		case FrameClass::CLASS_PLAY_COUNT:
-			return FramePtr(new PlayCountFrame(ID3Ver, frameBytes));
+			frame = FramePtr(new PlayCountFrame(ID3Ver, frameBytes)); break;
 		case FrameClass::CLASS_POPULARIMETER:
-			return FramePtr(new PopularimeterFrame(ID3Ver, frameBytes));
+			frame = FramePtr(new PopularimeterFrame(ID3Ver, frameBytes)); break;
 		case FrameClass::CLASS_EVENT_TIMING:
-			return FramePtr(new EventTimingFrame(ID3Ver, frameBytes));
+			frame = FramePtr(new EventTimingFrame(ID3Ver, frameBytes)); break;
 		case FrameClass::CLASS_UNKNOWN: default:
-			return FramePtr(new UnknownFrame(id, ID3Ver, frameBytes));
+			frame = FramePtr(new UnknownFrame(id, ID3Ver, frameBytes));
 	}
+	
+	//Save where the frame was read from, so it can be read again if compacted
+	frame->filePosition = readpos;
+	
+	//Return the Frame
+	return frame;
+}
+
+///@pkg ID3FrameFactory.h
+FramePtr FrameFactory::skippedFrame(const FrameID& id, const ulong readSize, const ulong readpos) {
+	FramePtr frame(new UnknownFrame(id));
+	frame->readSize = readSize;
+	frame->filePosition = readpos;
+	return frame;
 }
 
 ///@pkg ID3FrameFactory.h
 FramePtr FrameFactory::create(const FrameID&     frameName,
-                              const std::string& textContent,
-                              const std::string& description,
+                              std::string        textContent,
+                              std::string        description,
                               const std::string& language) const {
-	FrameClass frameType = FrameFactory::frameType(frameName);
+	const FrameClass frameType = frameName.metadata().frameClass;
 	
 	switch(frameType) {
 		case FrameClass::CLASS_TEXT:
-			return FramePtr(new TextFrame(frameName, textContent));
+			return FramePtr(new TextFrame(frameName, std::move(textContent)));
 		case FrameClass::CLASS_NUMERICAL:
-			return FramePtr(new NumericalTextFrame(frameName, textContent));
+			return FramePtr(new NumericalTextFrame(frameName, std::move(textContent)));
 		case FrameClass::CLASS_DESCRIPTIVE:
 			return FramePtr(new DescriptiveTextFrame(frameName,
-			                                         textContent,
-			                                         description,
+			                                         std::move(textContent),
+			                                         std::move(description),
 			                                         language,
-			                                         frameOptions(frameName)));
+			                                         frameName.metadata().options));
 		case FrameClass::CLASS_URL:
-			return FramePtr(new URLTextFrame(frameName, textContent));
+			return FramePtr(new URLTextFrame(frameName, std::move(textContent)));
 		case FrameClass::CLASS_PLAY_COUNT:
 			return FramePtr(new PlayCountFrame(atoll(textContent.c_str())));
 		case FrameClass::CLASS_POPULARIMETER:
@@ -189,7 +268,7 @@ FramePtr FrameFactory::create(const FrameID&                  frameName,
                               const std::vector<std::string>& textContents,
                               const std::string&              description,
                               const std::string&              language) const {
-	FrameClass frameType = FrameFactory::frameType(frameName);
+	const FrameClass frameType = frameName.metadata().frameClass;
 	
 	switch(frameType) {
 		case FrameClass::CLASS_TEXT:
@@ -201,7 +280,7 @@ FramePtr FrameFactory::create(const FrameID&                  frameName,
 			                                         textContents,
 			                                         description,
 			                                         language,
-			                                         frameOptions(frameName)));
+			                                         frameName.metadata().options));
 		case FrameClass::CLASS_URL:
 			return FramePtr(new URLTextFrame(frameName, textContents));
 		default:
@@ -214,7 +293,7 @@ FramePtr FrameFactory::create(const FrameID&     frameName,
                               const long long    frameValue,
                               const std::string& description,
                               const std::string& language) const {
-	FrameClass frameType = FrameFactory::frameType(frameName);
+	const FrameClass frameType = frameName.metadata().frameClass;
 	
 	switch(frameType) {
 		case FrameClass::CLASS_NUMERICAL:
@@ -229,11 +308,14 @@ FramePtr FrameFactory::create(const FrameID&     frameName,
 }
 
 ///@pkg ID3FrameFactory.h
-FramePtr FrameFactory::createPicture(const ByteArray&   pictureByteArray,
-			                            const std::string& mimeType,
-			                            const std::string& description,
-			                            const PictureType  type) const {
-	return FramePtr(new PictureFrame(pictureByteArray, mimeType, description, type));
+FramePtr FrameFactory::createPicture(PictureData       pictureByteArray,
+			                            std::string       mimeType,
+			                            std::string       description,
+			                            const PictureType type) const {
+	return FramePtr(new PictureFrame(std::move(pictureByteArray),
+	                                 std::move(mimeType),
+	                                 std::move(description),
+	                                 type));
 }
 
 ///@pkg ID3FrameFactory.h
@@ -247,72 +329,3 @@ FramePtr FrameFactory::createPlayCount(const unsigned long long count,
                                        const std::string&       email) const {
 	return FramePtr(new PopularimeterFrame(count, rating, email));
 }
-
-///@pkg ID3FrameFactory
-///@static
-FrameClass FrameFactory::frameType(const FrameID& frameID) {
-	if(frameID.unknown()) return FrameClass::CLASS_UNKNOWN;
-	
-	switch(frameID) {
-		//Pictures
-		case FRAME_PICTURE:
-			return FrameClass::CLASS_PICTURE;
-		//Frames with descriptions and/or languages
-		case FRAME_COMMENT:
-		case FRAME_CUSTOM_USER_INFO:
-		case FRAME_UNSYNCHRONISED_LYRICS:
-		case FRAME_TERMS_OF_USE:
-		case FRAME_USER_DEFINED_URL:
-			return FrameClass::CLASS_DESCRIPTIVE;
-		//Text frames that should contain an integer value
-		//NOTE: Track and Disc are not numerical values as they may contain a
-		//slash to separate the total number of tracks/discs in the set.
-		case FRAME_BPM:
-		case FRAME_DATE:
-		case FRAME_PLAYLIST_DELAY:
-		case FRAME_TIME:
-		case FRAME_LENGTH:
-		case FRAME_ORIGINAL_RELEASE_YEAR:
-		case FRAME_YEAR:
-			return FrameClass::CLASS_NUMERICAL;
-		//Frames that are essentially text frames, but don't start with a T
-		case FRAME_INVOLVED_PEOPLE:
-			return FrameClass::CLASS_TEXT;
-		//The Play Count frame
-		case FRAME_PLAY_COUNT:
-			return FrameClass::CLASS_PLAY_COUNT;
-		//The Popularimeter
-		case FRAME_POPULARIMETER:
-			return FrameClass::CLASS_POPULARIMETER;
-		//The Event Timing Codes frame
-		case FRAME_EVENT_TIMING_CODES:
-			return FrameClass::CLASS_EVENT_TIMING;
-		//For the rest of the frames, compare the string values as there's too
-		//many enum cases
-		default:
-			switch(frameID[0]) {
-				case 'T': return FrameClass::CLASS_TEXT;
-				case 'W': return FrameClass::CLASS_URL;
-				default:  return FrameClass::CLASS_UNKNOWN;
-			}
-	}
-}
-
-///@pkg ID3FrameFactory
-///@static
-ushort FrameFactory::frameOptions(const FrameID& frameID) {
-	switch(frameID) {
-		//These frames have a language field
-		case FRAME_UNSYNCHRONISED_LYRICS:
-		case FRAME_COMMENT:
-			return DescriptiveTextFrame::OPTION_LANGUAGE;
-		//This frame always encodes the text content as Latin-1
-		case FRAME_USER_DEFINED_URL:
-			return DescriptiveTextFrame::OPTION_LATIN1_TEXT;
-		//This frame has a language field and no description
-		case FRAME_TERMS_OF_USE:
-			return DescriptiveTextFrame::OPTION_LANGUAGE | DescriptiveTextFrame::OPTION_NO_DESCRIPTION;
-		default:
-			return 0;
-	}
-}
@@ -17,6 +17,8 @@
 #include <string>        //For std::string
 #include <unordered_map> //For std::unordered_map and std::pair
 #include <memory>        //For std::shared_ptr
+#include <utility>       //For std::move
+#include <climits>       //For ULONG_MAX
 
 #include "Frames/ID3Frame.hpp"        //For the Frame class
 #include "Frames/ID3PictureFrame.hpp" //For the PictureType enum
@@ -43,6 +45,54 @@ namespace ID3 {
 	 */
 	typedef std::pair<FrameID, FramePtr> FramePair;
 	
+	/**
+	 * ReadLimits caps how much work and memory reading the ID3v2 tags of a file
+	 * can take, for reading files that may be corrupt or crafted. The sizes of
+	 * frames are checked before their bytes are read, so frames that are over a
+	 * limit are skipped without being allocated. The defaults are far above
+	 * what ordinary files need.
+	 * 
+	 * NOTE: A Tag that skipped frames can't be written, as writing it would
+	 *       delete them from the file.
+	 * 
+	 * @see ID3::Tag::Tag(std::string&, ReadLimits&, FileCheck)
+	 */
+	struct ReadLimits {
+		/**
+		 * The maximum size of a frame in bytes, including its header. Bigger
+		 * frames are skipped. Pictures use pictureSize instead.
+		 */
+		ulong frameSize = 16 * 1024 * 1024;
+		
+		/**
+		 * The maximum size of a picture frame in bytes, including its header.
+		 * Bigger pictures are skipped.
+		 */
+		ulong pictureSize = 16 * 1024 * 1024;
+		
+		/**
+		 * The maximum number of frames read from a tag. Any frames after that
+		 * are ignored.
+		 */
+		ulong frames = 8192;
+		
+		/**
+		 * The maximum number of bytes read from a tag, counting the decoded
+		 * tag for unsynchronised ID3v2.3 tags and the bytes of every frame kept.
+		 * Frames that don't fit are skipped, and unsynchronised ID3v2.3 tags
+		 * are cut short.
+		 */
+		ulong totalSize = 64 * 1024 * 1024;
+		
+		/**
+		 * The maximum number of UTF-8 bytes a text frame may decode to, taking
+		 * the worst case for its encoding: twice the text size for LATIN-1 and
+		 * one and a half times for UTF-16. Frames that could be bigger are
+		 * skipped.
+		 */
+		ulong textSize = 4 * 1024 * 1024;
+	};
+	
 	/**
 	 * FrameFactory is a factory class to create Frame objects.
 	 * After creating a FrameFactory object call create(), or call a static
@@ -75,10 +125,12 @@ namespace ID3 {
 			 * @param tagEnd  The byte position that the ID3v2 tags end on. It is
 			 *                assumed that the tag size has already been checked to
 			 *                be smaller than the filesize.
+			 * @param limits  The limits on the frames read (optional).
 			 */
-			FrameFactory(std::istream&  file,
-			             const ushort   version,
-			             const ulong    tagEnd);
+			FrameFactory(std::istream&     file,
+			             const ushort      version,
+			             const ulong       tagEnd,
+			             const ReadLimits& limits=ReadLimits());
 			
 			/**
 			 * The empty constructor.
@@ -99,21 +151,29 @@ namespace ID3 {
 			 *       constructor, or a "null" UnknownFrame will be returned. The
 			 *       read position must also be smaller than the ID3v2 tag size.
 			 * 
+			 * NOTE: If the frame is over the ReadLimits given in the constructor
+			 *       or maxSize, its bytes are not read and a "null" UnknownFrame
+			 *       with the frame's ID is returned. Its readSize is still set so
+			 *       that the next frame can be found.
+			 * 
 			 * @param readpos The position on the file to start reading from.
+			 * @param maxSize The maximum size of the frame in bytes, on top of the
+			 *                ReadLimits (optional).
 			 * @return A FramePtr containing a relevant Frame object.
 			 */
-			FramePtr create(const ulong readpos) const;
+			FramePtr create(const ulong readpos, const ulong maxSize=ULONG_MAX) const;
 			
 			/**
 			 * Creates a relevant FramePair object.
 			 * 
 			 * @param readpos The position on the file to start reading from.
+			 * @param maxSize The maximum size of the frame in bytes (optional).
 			 * @return A FramePair, with the Frame ID in the first slot and the
 			 *         FramePtr in the second slot.
-			 * @see ID3::FrameFactory::create(const ulong)
+			 * @see ID3::FrameFactory::create(const ulong, const ulong)
 			 */
-			inline FramePair createPair(const ulong readpos) const {
-				FramePtr frame = create(readpos);
+			inline FramePair createPair(const ulong readpos, const ulong maxSize=ULONG_MAX) const {
+				FramePtr frame = create(readpos, maxSize);
 				return FramePair(frame->frame(), frame);
 			}
 			
@@ -123,7 +183,7 @@ namespace ID3 {
 			 * "null" UnknownFrame will be returned.
 			 * 
 			 * @param frameName   The ID3 frame ID.
-			 * @param textContent The string content.
+			 * @param textContent The string content. It is moved into the Frame.
 			 * @param description The frame description. Only applies to text
 			 *                    frames with descriptions.
 			 * @param language    The frame language. Only applied to text frames
@@ -131,8 +191,8 @@ namespace ID3 {
 			 * @return A FramePtr containing a relevant Frame object.
 			 */
 			FramePtr create(const FrameID&     frameName,
-			                const std::string& textContent="",
-			                const std::string& description="",
+			                std::string        textContent="",
+			                std::string        description="",
 			                const std::string& language="") const;
 			
 			/**
@@ -151,11 +211,11 @@ namespace ID3 {
 			 *                                std::string&,
 			 *                                std::string&)
 			 */
-			inline FramePair createPair(const FrameID& frameName,
-			                            const std::string& textContent="",
-			                            const std::string& description="",
+			inline FramePair createPair(const FrameID&     frameName,
+			                            std::string        textContent="",
+			                            std::string        description="",
 			                            const std::string& language="") const {
-				return FramePair(frameName, create(frameName, textContent, description, language));
+				return FramePair(frameName, create(frameName, std::move(textContent), std::move(description), language));
 			}
 			
 			/**
@@ -241,27 +301,28 @@ namespace ID3 {
 			/**
 			 * Create a picture Frame.
 			 * 
-			 * @param pictureByteArray A uint8_t vector of the picture's bytes.
+			 * @param pictureByteArray The picture's bytes, which are shared with
+			 *                         the PictureFrame instead of copied.
 			 * @param mimeType         The MIME type of the image (PNG or JPEG only).
 			 * @param description      The image description (optional).
 			 * @param type             The ID3v2 APIC type (optional, defaults to
 			 *                         front cover).
 			 * @return A FramePtr with the relevant PictureFrame object.
 			 */
-			FramePtr createPicture(const ByteArray&   pictureByteArray,
-			                       const std::string& mimeType,
-			                       const std::string& description="",
-			                       const PictureType  type=PictureType::FRONT_COVER) const;
+			FramePtr createPicture(PictureData       pictureByteArray,
+			                       std::string       mimeType,
+			                       std::string       description="",
+			                       const PictureType type=PictureType::FRONT_COVER) const;
 			
-			/** @see ID3::Frame::Factory::createPicture(ByteArray&,
+			/** @see ID3::Frame::Factory::createPicture(PictureData&,
 			 *                                          std::string&,
 			 *                                          std::string&,
 			 *                                          PictureType) */
-			inline FramePair createPicturePair(const ByteArray&   pictureByteArray,
-			                                   const std::string& mimeType,
-			                                   const std::string& description="",
-			                                   const PictureType  type=PictureType::FRONT_COVER) const {
-				FramePtr frame = createPicture(pictureByteArray, mimeType, description, type);
+			inline FramePair createPicturePair(PictureData       pictureByteArray,
+			                                   std::string       mimeType,
+			                                   std::string       description="",
+			                                   const PictureType type=PictureType::FRONT_COVER) const {
+				FramePtr frame = createPicture(std::move(pictureByteArray), std::move(mimeType), std::move(description), type);
 				return FramePair(frame->frame(), frame);
 			}
 			
@@ -311,24 +372,16 @@ namespace ID3 {
 			explicit FrameFactory(const ushort version);
 			
 			/**
-			 * An internal method used to match each ID3 frame ID with
-			 * a FrameClass enum value. If the frame ID is not recognized
-			 * a FrameClass::CLASS_UNKNOWN value will be returned.
+			 * Create the "null" UnknownFrame returned for a frame that is over the
+			 * ReadLimits, which still records where the frame is and how big it
+			 * is on file.
 			 * 
-			 * @param frameID The ID3v2 frame ID.
-			 * @return The relevant FrameClass enum value.
+			 * @param id       The frame ID.
+			 * @param readSize The size of the frame on file.
+			 * @param readpos  The position of the frame on file.
+			 * @return A FramePtr holding the "null" UnknownFrame.
 			 */
-			static FrameClass frameType(const FrameID& frameID);
-			
-			/**
-			 * Some frames that are read with integer options specific to their
-			 * frame description in the ID3v2 standard. Use this function to get
-			 * the option for a specific frame.
-			 * 
-			 * @param frameID The ID3v2 frame ID.
-			 * @return The relevant DescriptiveTextFrame option value.
-			 */
-			static ushort frameOptions(const FrameID& frameID);
+			static FramePtr skippedFrame(const FrameID& id, const ulong readSize, const ulong readpos);
 			
 			/**
 			 * A pointer to the istream object given in the protected constructor.
@@ -344,6 +397,12 @@ namespace ID3 {
 			 * The size of the ID3 tags in bytes, given in the public constructor.
 			 */
 			ulong ID3Size;
+			
+			/**
+			 * The limits on the frames read from file, given in the protected
+			 * constructor.
+			 */
+			ReadLimits readLimits;
 	};
 }
 
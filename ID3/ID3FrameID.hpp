@@ -13,6 +13,7 @@
 #ifndef ID3_FRAME_ID_HPP
 #define ID3_FRAME_ID_HPP
 
+#include <cstdint>       //For uint8_t
 #include <vector>        //For std::vector
 #include <unordered_map> //For std::unordered_map and std::pair
 
@@ -472,6 +473,85 @@ namespace ID3 {
 		FRAMEID_XXXX             = 94
 	};
 	
+	/**
+	 * An enum that  represents a Frame class.
+	 * 
+	 * Values and their respective class:
+	 *     CLASS_DESCRIPTIVE:   DescriptiveTextFrame
+	 *     CLASS_NUMERICAL:     NumericalTextFrame
+	 *     CLASS_PICTURE:       PictureFrame
+	 *     CLASS_PLAY_COUNT:    PlayCountFrame
+	 *     CLASS_POPULARIMETER: PopularimeterFrame
+	 *     CLASS_TEXT:          TextFrame
+	 *     CLASS_UNKNOWN:       UnknownFrame
+	 *     CLASS_URL:           URLTextFrame
+	 */
+	enum FrameClass : short {
+		CLASS_DESCRIPTIVE   = 3, //DescriptiveTextFrame
+		CLASS_NUMERICAL     = 2, //NumericalTextFrame
+		CLASS_TEXT          = 1, //TextFrame
+		CLASS_UNKNOWN       = 0, //UnknownFrame
+		CLASS_URL           = 4, //URLTextFrame
+		CLASS_PICTURE       = 5, //PictureTextFrame
+		CLASS_PLAY_COUNT    = 6, //PlayCountFrame
+		CLASS_POPULARIMETER = 7, //PopularimeterFrame
+		CLASS_EVENT_TIMING  = 8  //EventTimingFrame
+	};
+	
+	/**
+	 * Options for frames read by DescriptiveTextFrame, saved in
+	 * ID3::FrameMetadata::options.
+	 * 
+	 * @see ID3::DescriptiveTextFrame::OPTION_LANGUAGE
+	 * @see ID3::DescriptiveTextFrame::OPTION_LATIN1_TEXT
+	 * @see ID3::DescriptiveTextFrame::OPTION_NO_DESCRIPTION
+	 */
+	constexpr ushort FRAME_OPTION_LANGUAGE       = 0b00000001;
+	constexpr ushort FRAME_OPTION_LATIN1_TEXT    = 0b00000010;
+	constexpr ushort FRAME_OPTION_NO_DESCRIPTION = 0b00000100;
+	
+	/**
+	 * The ID3v2.4 Discard Upon Audio Alter frame flag, saved in
+	 * ID3::FrameMetadata::flags1 for frames that have it set by default.
+	 * 
+	 * @see ID3::Frame::FLAG1_DISCARD_UPON_AUDIO_ALTER_V4
+	 */
+	constexpr uint8_t FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER = 0b00100000;
+	
+	/**
+	 * A FrameMetadata struct holds everything the library knows about a frame
+	 * ID ahead of time. There is one for every Frames enum value, which are
+	 * saved in ID3::FrameID::METADATA.
+	 * 
+	 * @see ID3::FrameID::metadata()
+	 */
+	struct FrameMetadata {
+		/**
+		 * The Frame class used to read and write the frame.
+		 */
+		FrameClass frameClass;
+		
+		/**
+		 * The DescriptiveTextFrame options for the frame, or 0 if there are none.
+		 */
+		ushort options;
+		
+		/**
+		 * Whether the ID3v2 standard allows multiple instances of the frame.
+		 */
+		bool allowsMultiple;
+		
+		/**
+		 * The first frame flag byte that is set by default when writing the frame.
+		 */
+		uint8_t flags1;
+		
+		/**
+		 * A short description/title of the frame.
+		 */
+		const char* description;
+	};
+	
 	/**
 	 * FrameID is a class that holds an ID3v2 frame ID. It has one possible value
 	 * for every enumeration in the Frames enum. It can be created with either a
@@ -637,6 +717,26 @@ namespace ID3 {
 			 */
 			std::string description() const;
 			
+			/**
+			 * Get the metadata of the frame ID, such as the Frame class used to
+			 * read it and the flags that it's written with by default.
+			 * 
+			 * @return The frame's entry in the metadata table.
+			 */
+			const FrameMetadata& metadata() const;
+			
+			/**
+			 * Get the metadata of a Frames enum value. If an unknown Frames enum
+			 * value is given, then the metadata for Frames::FRAME_UNKNOWN_FRAME is
+			 * returned.
+			 * 
+			 * @param frameID A Frames enum value.
+			 * @return The frame's entry in the metadata table.
+			 */
+			static constexpr const FrameMetadata& metadata(const Frames frameID) {
+				return METADATA[frameID < FRAME_UNKNOWN_FRAME ? frameID : FRAME_UNKNOWN_FRAME];
+			}
+			
 		private:
 			/**
 			 * A string vector of ID3v2.3-ID3v2.4 frame ID that holds a 1:1
@@ -693,13 +793,116 @@ namespace ID3 {
 			static inline FrameID convertOldFrameIDToNew(const std::string& v2FrameID);
 			
 			/**
-			 * A vector of strings that hold a 1:1 mapping of Frames enum values
-			 * and vector positions. The strings are a short description or title
-			 * of the frame ID.
+			 * The frame metadata table. It holds a 1:1 mapping of Frames enum
+			 * values and array positions, in the same order as
+			 * ID3::FrameID::FRAME_STR_LIST.
 			 * 
-			 * @see ID3::FrameID::description()
+			 * Columns: Frame class, DescriptiveTextFrame options, multiple
+			 * instances allowed, default first flag byte, and description.
+			 * 
+			 * @see ID3::FrameID::metadata()
 			 */
-			static const std::vector<std::string> FRAME_DESCRIPTIONS;
+			static constexpr FrameMetadata METADATA[] = {
+				{CLASS_UNKNOWN,       0,                                                   true,  FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Audio Encryption"}, //0 AENC
+				{CLASS_PICTURE,       0,                                                   true,  0,                                    "Attached Picture"}, //1 APIC
+				{CLASS_UNKNOWN,       0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Audio Seek Point Index"}, //2 ASPI
+				{CLASS_DESCRIPTIVE,   FRAME_OPTION_LANGUAGE,                               true,  0,                                    "Comment"}, //3 COMM
+				{CLASS_UNKNOWN,       0,                                                   true,  0,                                    "Commercial"}, //4 COMR
+				{CLASS_UNKNOWN,       0,                                                   true,  0,                                    "Encryption Method"}, //5 ENCR
+				{CLASS_UNKNOWN,       0,                                                   true,  FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Equalisation"}, //6 EQU2
+				{CLASS_UNKNOWN,       0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Equalisation"}, //7 EQUA
+				{CLASS_EVENT_TIMING,  0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Event Timing Codes"}, //8 ETCO
+				{CLASS_UNKNOWN,       0,                                                   true,  0,                                    "General Encapsulated Object"}, //9 GEOB
+				{CLASS_UNKNOWN,       0,                                                   true,  0,                                    "Group Identification Registration"}, //10 GRID
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Involved People"}, //11 IPLS
+				{CLASS_UNKNOWN,       0,                                                   true,  0,                                    "Linked Information"}, //12 LINK
+				{CLASS_UNKNOWN,       0,                                                   false, 0,                                    "Music CD Identifier"}, //13 MCDI
+				{CLASS_UNKNOWN,       0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "MPEG Location Lookup Table"}, //14 MLLT
+				{CLASS_UNKNOWN,       0,                                                   false, 0,                                    "Ownership"}, //15 OWNE
+				{CLASS_PLAY_COUNT,    0,                                                   false, 0,                                    "Play Counter"}, //16 PCNT
+				{CLASS_POPULARIMETER, 0,                                                   true,  0,                                    "Popularimeter"}, //17 POPM
+				{CLASS_UNKNOWN,       0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Position Synchronisation"}, //18 POSS
+				{CLASS_UNKNOWN,       0,                                                   true,  0,                                    "Private"}, //19 PRIV
+				{CLASS_UNKNOWN,       0,                                                   false, 0,                                    "Recommended Buffer Size"}, //20 RBUF
+				{CLASS_UNKNOWN,       0,                                                   true,  FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Relative Volume Adjustment"}, //21 RVA2
+				{CLASS_UNKNOWN,       0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Relative Volume Adjustment"}, //22 RVAD
+				{CLASS_UNKNOWN,       0,                                                   false, 0,                                    "Reverb"}, //23 RVRB
+				{CLASS_UNKNOWN,       0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Seek"}, //24 SEEK
+				{CLASS_UNKNOWN,       0,                                                   true,  0,                                    "Signature"}, //25 SIGN
+				{CLASS_UNKNOWN,       0,                                                   true,  FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Synchronised Lyrics"}, //26 SYLT
+				{CLASS_UNKNOWN,       0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Synchronised Tempo Codes"}, //27 SYTC
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Album"}, //28 TALB
+				{CLASS_NUMERICAL,     0,                                                   false, 0,                                    "BPM"}, //29 TBPM
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Composer"}, //30 TCOM
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Genre"}, //31 TCON
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Copyright"}, //32 TCOP
+				{CLASS_NUMERICAL,     0,                                                   false, 0,                                    "Date"}, //33 TDAT
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Encoding Time"}, //34 TDEN
+				{CLASS_NUMERICAL,     0,                                                   false, 0,                                    "Playlist Delay"}, //35 TDLY
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Original Release Time"}, //36 TDOR
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Recording Time"}, //37 TDRC
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Release Time"}, //38 TDRL
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Tagging Time"}, //39 TDTG
+				{CLASS_TEXT,          0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Encoded By"}, //40 TENC
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Lyricist"}, //41 TEXT
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "File Type"}, //42 TFLT
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Involved People List"}, //43 TIPL
+				{CLASS_NUMERICAL,     0,                                                   false, 0,                                    "Time"}, //44 TIME
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Content Group"}, //45 TIT1
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Title"}, //46 TIT2
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Description"}, //47 TIT3
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Initial Key"}, //48 TKEY
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Language"}, //49 TLAN
+				{CLASS_NUMERICAL,     0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Length"}, //50 TLEN
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Musician Credit List"}, //51 TMCL
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Media Type"}, //52 TMED
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Mood"}, //53 TMOO
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Original Album"}, //54 TOAL
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Original Filename"}, //55 TOFL
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Original Lyricist"}, //56 TOLY
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Original Artist"}, //57 TOPE
+				{CLASS_NUMERICAL,     0,                                                   false, 0,                                    "Original Release Year"}, //58 TORY
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "File Owner"}, //59 TOWN
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Artist"}, //60 TPE1
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Album Artist"}, //61 TPE2
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Conductor"}, //62 TPE3
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Modified By"}, //63 TPE4
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Disc"}, //64 TPOS
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Produced Notice"}, //65 TPRO
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Publisher"}, //66 TPUB
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Track"}, //67 TRCK
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Recording Dates"}, //68 TRDA
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Internet Radio Station"}, //69 TRSN
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Internet Radio Station Owner"}, //70 TRSO
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Album Artist Sort Order"}, //71 TSO2
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Album Sort Order"}, //72 TSOA
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Composer Sort Order"}, //73 TSOC
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Artist Sort Order"}, //74 TSOP
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Title Sort Order"}, //75 TSOT
+				{CLASS_TEXT,          0,                                                   false, FRAME_FLAG1_DISCARD_UPON_AUDIO_ALTER, "Size"}, //76 TSIZ
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "ISRC"}, //77 TSRC
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Encoding Settings"}, //78 TSSE
+				{CLASS_TEXT,          0,                                                   false, 0,                                    "Set Subtitle"}, //79 TSST
+				{CLASS_DESCRIPTIVE,   0,                                                   true,  0,                                    "Custom User Information"}, //80 TXXX
+				{CLASS_NUMERICAL,     0,                                                   false, 0,                                    "Year"}, //81 TYER
+				{CLASS_UNKNOWN,       0,                                                   true,  0,                                    "Unique File Identifier"}, //82 UFID
+				{CLASS_DESCRIPTIVE,   FRAME_OPTION_LANGUAGE | FRAME_OPTION_NO_DESCRIPTION, true,  0,                                    "Terms of Use"}, //83 USER
+				{CLASS_DESCRIPTIVE,   FRAME_OPTION_LANGUAGE,                               true,  0,                                    "Unsynchronised Lyrics"}, //84 USLT
+				{CLASS_URL,           0,                                                   true,  0,                                    "Commercial Information URL"}, //85 WCOM
+				{CLASS_URL,           0,                                                   false, 0,                                    "Copyright URL"}, //86 WCOP
+				{CLASS_URL,           0,                                                   false, 0,                                    "Official File URL"}, //87 WOAF
+				{CLASS_URL,           0,                                                   true,  0,                                    "Official Artist URL"}, //88 WOAR
+				{CLASS_URL,           0,                                                   false, 0,                                    "Official Audio Source URL"}, //89 WOAS
+				{CLASS_URL,           0,                                                   false, 0,                                    "Official Internet Radio Station URL"}, //90 WORS
+				{CLASS_URL,           0,                                                   false, 0,                                    "Official Payment URL"}, //91 WPAY
+				{CLASS_URL,           0,                                                   false, 0,                                    "Official Publisher URL"}, //92 WPUB
+				{CLASS_DESCRIPTIVE,   FRAME_OPTION_LATIN1_TEXT,                            true,  0,                                    "User-defined URL"}, //93 WXXX
+				{CLASS_UNKNOWN,       0,                                                   false, 0,                                    "Unknown"}  //94 XXXX
+			};
+			
+			//There should be one metadata entry for every Frames enum value
+			static_assert(sizeof(METADATA) / sizeof(FrameMetadata) == FRAME_UNKNOWN_FRAME + 1,
+			              "The frame metadata table doesn't match the Frames enum");
 			
 			/**
 			 * The Frames enum value of this FrameID.
@@ -10,9 +10,17 @@
  * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
  **********************************************************************/
 
-#include <cstring>          //For ::strlen()
-#include <unicode/unistr.h> //For icu::UnicodeString
-#include <algorithm>        //For std::reverse() and std::all_of()
+#include <cstring>          //For ::strlen() and std::memcpy()
+#include <algorithm>        //For std::reverse(), std::all_of(), and std::min()
+#include <cstdlib>          //For atoi()
+#include <cctype>           //For isdigit()
+
+//The text and unsynchronisation kernels use SSE2 and AVX2 when built with
+//GCC or Clang for x86, with the instruction set picked at runtime
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#define ID3_X86_SIMD
+	#include <immintrin.h> //For SSE2 and AVX2 intrinsics
+#endif
 
 #include "ID3Functions.hpp"    //For the function definitions
 #include "ID3Constants.hpp"    //For ID3::GENRES
@@ -20,6 +28,688 @@
 
 using namespace ID3;
 
+//Private namespace
+namespace {
+	//0x80 (128) is the first character beyond ASCII
+	const uint8_t BEYOND_ASCII = 0x80;
+	
+	//In UTF-8, if the first byte starts with "110" then it will be a two byte character
+	const uint8_t UTF8_TWO_BYTE_MASK = 0b11000000;
+	
+	//In UTF-8, bytes of characters beyond the first byte don't have the first
+	//two bits usable, since these bytes will always be 0b10XXXXXX
+	const uint8_t VARIABLE_UTF8_CHAR_USABLE_BITS = 6;
+	
+	//A mask to apply on the LATIN-1 character to store its value on the second byte
+	const uint8_t UTF8_BYTE_TWO_MASK = 0b00111111;
+	
+	//The high bit of every byte in a 64-bit word
+	const uint64_t WORD_HIGH_BITS = 0x8080808080808080ULL;
+	
+	/**
+	 * Translate a run of LATIN-1 characters to UTF-8 one character at a time.
+	 * 
+	 * @param latin1 The LATIN-1 characters.
+	 * @param size   The number of characters.
+	 * @param utf8   Where to write the UTF-8 bytes. It must have room for
+	 *               size plus the number of non-ASCII characters.
+	 * @return One past the last UTF-8 byte written.
+	 */
+	inline char* latin1CharsToUTF8(const uint8_t* latin1, size_t size, char* utf8) {
+		for(const uint8_t* const end = latin1 + size; latin1 != end; latin1++) {
+			const uint8_t curChar = *latin1;
+			if(curChar < BEYOND_ASCII) {
+				//If curChar <= 127, it is an ASCII character that is identical in UTF-8
+				*utf8++ = curChar;
+			} else {
+				//Translate the LATIN-1 character to a UTF-8 character
+				*utf8++ = UTF8_TWO_BYTE_MASK | (curChar >> VARIABLE_UTF8_CHAR_USABLE_BITS);
+				*utf8++ = BEYOND_ASCII | (curChar & UTF8_BYTE_TWO_MASK);
+			}
+		}
+		return utf8;
+	}
+	
+	/**
+	 * Count the LATIN-1 characters that are not ASCII, eight at a time.
+	 * 
+	 * @param latin1 The LATIN-1 characters.
+	 * @param size   The number of characters.
+	 * @return The number of characters that need two bytes in UTF-8.
+	 */
+	size_t countNonASCIIScalar(const uint8_t* latin1, size_t size) {
+		size_t count = 0, i = 0;
+		for(uint64_t word; i + sizeof(word) <= size; i += sizeof(word)) {
+			std::memcpy(&word, latin1 + i, sizeof(word));
+			word &= WORD_HIGH_BITS;
+			//Fold the eight high bits into a count
+			count += ((word >> 7) * 0x0101010101010101ULL) >> 56;
+		}
+		for(; i < size; i++) count += latin1[i] >> 7;
+		return count;
+	}
+	
+	/**
+	 * Translate LATIN-1 to UTF-8, copying runs of eight ASCII characters at a
+	 * time.
+	 * 
+	 * @see latin1CharsToUTF8()
+	 */
+	void latin1ToUTF8Scalar(const uint8_t* latin1, size_t size, char* utf8) {
+		size_t i = 0;
+		for(uint64_t word; i + sizeof(word) <= size; i += sizeof(word)) {
+			std::memcpy(&word, latin1 + i, sizeof(word));
+			if((word & WORD_HIGH_BITS) == 0) {
+				std::memcpy(utf8, &word, sizeof(word));
+				utf8 += sizeof(word);
+			} else {
+				utf8 = latin1CharsToUTF8(latin1 + i, sizeof(word), utf8);
+			}
+		}
+		latin1CharsToUTF8(latin1 + i, size - i, utf8);
+	}
+	
+	#ifdef ID3_X86_SIMD
+	/** @see countNonASCIIScalar() */
+	__attribute__((target("sse2")))
+	size_t countNonASCIISSE2(const uint8_t* latin1, size_t size) {
+		size_t count = 0, i = 0;
+		for(; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(latin1 + i));
+			count += __builtin_popcount(_mm_movemask_epi8(block));
+		}
+		return count + countNonASCIIScalar(latin1 + i, size - i);
+	}
+	
+	/** @see latin1ToUTF8Scalar() */
+	__attribute__((target("sse2")))
+	void latin1ToUTF8SSE2(const uint8_t* latin1, size_t size, char* utf8) {
+		size_t i = 0;
+		for(; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(latin1 + i));
+			if(_mm_movemask_epi8(block) == 0) {
+				//The whole block is ASCII, so store it as-is
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(utf8), block);
+				utf8 += sizeof(__m128i);
+			} else {
+				utf8 = latin1CharsToUTF8(latin1 + i, sizeof(__m128i), utf8);
+			}
+		}
+		latin1ToUTF8Scalar(latin1 + i, size - i, utf8);
+	}
+	
+	/** @see countNonASCIIScalar() */
+	__attribute__((target("avx2")))
+	size_t countNonASCIIAVX2(const uint8_t* latin1, size_t size) {
+		size_t count = 0, i = 0;
+		for(; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(latin1 + i));
+			count += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(block)));
+		}
+		return count + countNonASCIISSE2(latin1 + i, size - i);
+	}
+	
+	/** @see latin1ToUTF8Scalar() */
+	__attribute__((target("avx2")))
+	void latin1ToUTF8AVX2(const uint8_t* latin1, size_t size, char* utf8) {
+		size_t i = 0;
+		for(; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(latin1 + i));
+			if(_mm256_movemask_epi8(block) == 0) {
+				//The whole block is ASCII, so store it as-is
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(utf8), block);
+				utf8 += sizeof(__m256i);
+			} else {
+				utf8 = latin1CharsToUTF8(latin1 + i, sizeof(__m256i), utf8);
+			}
+		}
+		latin1ToUTF8SSE2(latin1 + i, size - i, utf8);
+	}
+	#endif
+	
+	/**
+	 * The LATIN-1 to UTF-8 kernel functions for the instruction set the CPU
+	 * supports.
+	 */
+	struct Latin1Kernel {
+		size_t (*countNonASCII)(const uint8_t*, size_t);
+		void   (*toUTF8)(const uint8_t*, size_t, char*);
+	};
+	
+	/**
+	 * Get the fastest LATIN-1 to UTF-8 kernel for this CPU. The CPU is only
+	 * checked on the first call.
+	 */
+	const Latin1Kernel& latin1Kernel() {
+		static const Latin1Kernel KERNEL = []() -> Latin1Kernel {
+			#ifdef ID3_X86_SIMD
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx2")) return { countNonASCIIAVX2, latin1ToUTF8AVX2 };
+			if(__builtin_cpu_supports("sse2")) return { countNonASCIISSE2, latin1ToUTF8SSE2 };
+			#endif
+			return { countNonASCIIScalar, latin1ToUTF8Scalar };
+		}();
+		return KERNEL;
+	}
+	
+	//The first and last UTF-16 high (leading) surrogates
+	const uint16_t HIGH_SURROGATE_START = 0xD800;
+	const uint16_t HIGH_SURROGATE_END   = 0xDBFF;
+	
+	//The first and last UTF-16 low (trailing) surrogates
+	const uint16_t LOW_SURROGATE_START = 0xDC00;
+	const uint16_t LOW_SURROGATE_END   = 0xDFFF;
+	
+	//The first code point that needs a surrogate pair in UTF-16
+	const uint32_t SUPPLEMENTARY_PLANE_START = 0x10000;
+	
+	//The character that replaces unpaired surrogates
+	const uint32_t REPLACEMENT_CHARACTER = 0xFFFD;
+	
+	/**
+	 * Read a UTF-16 code unit.
+	 * 
+	 * @param u16 The first byte of the code unit.
+	 */
+	template<bool BigEndian>
+	inline uint16_t utf16Unit(const uint8_t* u16) {
+		return BigEndian ? (u16[0] << 8) | u16[1] : (u16[1] << 8) | u16[0];
+	}
+	
+	/**
+	 * Translate UTF-16 code units to UTF-8 one code point at a time. Unpaired
+	 * surrogates are replaced with U+FFFD.
+	 * 
+	 * @param u16      The UTF-16 string.
+	 * @param pos      The code unit to start at.
+	 * @param stop     The code unit to stop before. A surrogate pair that
+	 *                 starts before stop is translated whole.
+	 * @param units    The number of code units in the UTF-16 string.
+	 * @param utf8     Where to write the UTF-8 bytes. Only used if Write is true.
+	 * @param utf8Pos  The position in utf8 to write to. It is advanced by the
+	 *                 UTF-8 size of each code point even if Write is false.
+	 * @return The code unit after the last one translated.
+	 */
+	template<bool BigEndian, bool Write>
+	inline size_t utf16UnitsToUTF8(const uint8_t* u16,
+	                               size_t         pos,
+	                               const size_t   stop,
+	                               const size_t   units,
+	                               char*          utf8,
+	                               size_t&        utf8Pos) {
+		for(; pos < stop; pos++) {
+			uint32_t codePoint = utf16Unit<BigEndian>(u16 + pos * 2);
+			
+			if(codePoint < 0x80) {
+				if(Write) utf8[utf8Pos] = codePoint;
+				utf8Pos += 1;
+				continue;
+			}
+			
+			if(codePoint < 0x800) {
+				if(Write) {
+					utf8[utf8Pos]   = 0b11000000 | (codePoint >> 6);
+					utf8[utf8Pos+1] = 0b10000000 | (codePoint & 0b00111111);
+				}
+				utf8Pos += 2;
+				continue;
+			}
+			
+			if(codePoint >= HIGH_SURROGATE_START && codePoint <= LOW_SURROGATE_END) {
+				const uint16_t nextUnit = pos + 1 < units ? utf16Unit<BigEndian>(u16 + (pos + 1) * 2) : 0;
+				if(codePoint <= HIGH_SURROGATE_END &&
+				   nextUnit >= LOW_SURROGATE_START && nextUnit <= LOW_SURROGATE_END) {
+					//Combine the surrogate pair into a four-byte UTF-8 character
+					codePoint = SUPPLEMENTARY_PLANE_START +
+					            ((codePoint - HIGH_SURROGATE_START) << 10) +
+					            (nextUnit - LOW_SURROGATE_START);
+					if(Write) {
+						utf8[utf8Pos]   = 0b11110000 | (codePoint >> 18);
+						utf8[utf8Pos+1] = 0b10000000 | ((codePoint >> 12) & 0b00111111);
+						utf8[utf8Pos+2] = 0b10000000 | ((codePoint >> 6) & 0b00111111);
+						utf8[utf8Pos+3] = 0b10000000 | (codePoint & 0b00111111);
+					}
+					utf8Pos += 4;
+					pos++;
+					continue;
+				}
+				codePoint = REPLACEMENT_CHARACTER;
+			}
+			
+			if(Write) {
+				utf8[utf8Pos]   = 0b11100000 | (codePoint >> 12);
+				utf8[utf8Pos+1] = 0b10000000 | ((codePoint >> 6) & 0b00111111);
+				utf8[utf8Pos+2] = 0b10000000 | (codePoint & 0b00111111);
+			}
+			utf8Pos += 3;
+		}
+		return pos;
+	}
+	
+	/**
+	 * Translate a UTF-16 string to UTF-8, or only measure its UTF-8 size if
+	 * Write is false.
+	 * 
+	 * @param u16     The UTF-16 string, without a BOM.
+	 * @param units   The number of code units in the string.
+	 * @param utf8    Where to write the UTF-8 bytes. Only used if Write is true.
+	 * @param utf8Pos Advanced by the UTF-8 size of the string.
+	 */
+	template<bool BigEndian, bool Write>
+	void utf16ToUTF8Scalar(const uint8_t* u16, size_t units, char* utf8, size_t& utf8Pos) {
+		utf16UnitsToUTF8<BigEndian, Write>(u16, 0, units, units, utf8, utf8Pos);
+	}
+	
+	#ifdef ID3_X86_SIMD
+	/**
+	 * Translate UTF-16 to UTF-8, narrowing blocks of eight ASCII code units at
+	 * a time.
+	 * 
+	 * @see utf16ToUTF8Scalar()
+	 */
+	template<bool BigEndian, bool Write>
+	__attribute__((target("sse2")))
+	void utf16ToUTF8SSE2(const uint8_t* u16, size_t units, char* utf8, size_t& utf8Pos) {
+		const size_t BLOCK_UNITS = sizeof(__m128i) / 2;
+		const __m128i NON_ASCII_BITS = _mm_set1_epi16(static_cast<short>(0xFF80));
+		const __m128i ZERO = _mm_setzero_si128();
+		size_t pos = 0;
+		while(pos + BLOCK_UNITS <= units) {
+			__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u16 + pos * 2));
+			if(BigEndian) block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+			if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(block, NON_ASCII_BITS), ZERO)) == 0xFFFF) {
+				//The whole block is ASCII, so narrow each code unit to a byte
+				if(Write) _mm_storel_epi64(reinterpret_cast<__m128i*>(utf8 + utf8Pos), _mm_packus_epi16(block, block));
+				utf8Pos += BLOCK_UNITS;
+				pos += BLOCK_UNITS;
+			} else {
+				pos = utf16UnitsToUTF8<BigEndian, Write>(u16, pos, pos + BLOCK_UNITS, units, utf8, utf8Pos);
+			}
+		}
+		utf16UnitsToUTF8<BigEndian, Write>(u16, pos, units, units, utf8, utf8Pos);
+	}
+	
+	/**
+	 * Translate UTF-16 to UTF-8, narrowing blocks of sixteen ASCII code units
+	 * at a time.
+	 * 
+	 * @see utf16ToUTF8Scalar()
+	 */
+	template<bool BigEndian, bool Write>
+	__attribute__((target("avx2")))
+	void utf16ToUTF8AVX2(const uint8_t* u16, size_t units, char* utf8, size_t& utf8Pos) {
+		const size_t BLOCK_UNITS = sizeof(__m256i) / 2;
+		const __m256i NON_ASCII_BITS = _mm256_set1_epi16(static_cast<short>(0xFF80));
+		size_t pos = 0;
+		while(pos + BLOCK_UNITS <= units) {
+			__m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(u16 + pos * 2));
+			if(BigEndian) block = _mm256_or_si256(_mm256_slli_epi16(block, 8), _mm256_srli_epi16(block, 8));
+			if(_mm256_testz_si256(block, NON_ASCII_BITS)) {
+				//The whole block is ASCII, so narrow each code unit to a byte. The
+				//pack works per 128-bit lane, so gather the two halves afterwards.
+				if(Write) {
+					const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(block, block), 0b1000);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(utf8 + utf8Pos), _mm256_castsi256_si128(packed));
+				}
+				utf8Pos += BLOCK_UNITS;
+				pos += BLOCK_UNITS;
+			} else {
+				pos = utf16UnitsToUTF8<BigEndian, Write>(u16, pos, pos + BLOCK_UNITS, units, utf8, utf8Pos);
+			}
+		}
+		utf16UnitsToUTF8<BigEndian, Write>(u16, pos, units, units, utf8, utf8Pos);
+	}
+	#endif
+	
+	/**
+	 * The UTF-16 to UTF-8 kernel functions for the instruction set the CPU
+	 * supports. The first index is whether the string is big endian, and the
+	 * second is whether to write the UTF-8 bytes or only measure them.
+	 */
+	struct UTF16Kernel {
+		void (*toUTF8[2][2])(const uint8_t*, size_t, char*, size_t&);
+	};
+	
+	/**
+	 * Get the fastest UTF-16 to UTF-8 kernel for this CPU. The CPU is only
+	 * checked on the first call.
+	 */
+	const UTF16Kernel& utf16Kernel() {
+		static const UTF16Kernel KERNEL = []() -> UTF16Kernel {
+			#ifdef ID3_X86_SIMD
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx2"))
+				return {{{ utf16ToUTF8AVX2<false, false>, utf16ToUTF8AVX2<false, true> },
+				         { utf16ToUTF8AVX2<true,  false>, utf16ToUTF8AVX2<true,  true> }}};
+			if(__builtin_cpu_supports("sse2"))
+				return {{{ utf16ToUTF8SSE2<false, false>, utf16ToUTF8SSE2<false, true> },
+				         { utf16ToUTF8SSE2<true,  false>, utf16ToUTF8SSE2<true,  true> }}};
+			#endif
+			return {{{ utf16ToUTF8Scalar<false, false>, utf16ToUTF8Scalar<false, true> },
+			         { utf16ToUTF8Scalar<true,  false>, utf16ToUTF8Scalar<true,  true> }}};
+		}();
+		return KERNEL;
+	}
+	
+	/**
+	 * Find the next unsynchronisation byte pair, 0xFF followed by 0x00.
+	 * 
+	 * @param bytes The bytes to search.
+	 * @param pos   The position to start searching from.
+	 * @param size  The number of bytes.
+	 * @return The position of the 0xFF byte of the pair, or size if there is
+	 *         no pair.
+	 */
+	size_t findUnsyncPairScalar(const uint8_t* bytes, size_t pos, const size_t size) {
+		while(pos + 1 < size) {
+			const void* found = std::memchr(bytes + pos, 0xFF, size - 1 - pos);
+			if(found == nullptr) break;
+			pos = static_cast<const uint8_t*>(found) - bytes;
+			if(bytes[pos + 1] == 0x00) return pos;
+			pos++;
+		}
+		return size;
+	}
+	
+	#ifdef ID3_X86_SIMD
+	/**
+	 * Find the next unsynchronisation byte pair, comparing sixteen byte
+	 * positions at a time.
+	 * 
+	 * @see findUnsyncPairScalar()
+	 */
+	__attribute__((target("sse2")))
+	size_t findUnsyncPairSSE2(const uint8_t* bytes, size_t pos, const size_t size) {
+		const __m128i ALL_ONES = _mm_set1_epi8(static_cast<char>(0xFF));
+		const __m128i ZERO = _mm_setzero_si128();
+		//Each block is compared against the same block shifted by one byte, so
+		//one more byte than the block size has to be readable
+		for(; pos + sizeof(__m128i) + 1 <= size; pos += sizeof(__m128i)) {
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos));
+			const __m128i next  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos + 1));
+			const int pairs = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block, ALL_ONES),
+			                                                  _mm_cmpeq_epi8(next, ZERO)));
+			if(pairs != 0) return pos + __builtin_ctz(pairs);
+		}
+		return findUnsyncPairScalar(bytes, pos, size);
+	}
+	
+	/**
+	 * Find the next unsynchronisation byte pair, comparing thirty-two byte
+	 * positions at a time.
+	 * 
+	 * @see findUnsyncPairScalar()
+	 */
+	__attribute__((target("avx2")))
+	size_t findUnsyncPairAVX2(const uint8_t* bytes, size_t pos, const size_t size) {
+		const __m256i ALL_ONES = _mm256_set1_epi8(static_cast<char>(0xFF));
+		const __m256i ZERO = _mm256_setzero_si256();
+		for(; pos + sizeof(__m256i) + 1 <= size; pos += sizeof(__m256i)) {
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + pos));
+			const __m256i next  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + pos + 1));
+			const unsigned pairs = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block, ALL_ONES),
+			                                                             _mm256_cmpeq_epi8(next, ZERO)));
+			if(pairs != 0) return pos + __builtin_ctz(pairs);
+		}
+		return findUnsyncPairSSE2(bytes, pos, size);
+	}
+	#endif
+	
+	/**
+	 * Get the fastest unsynchronisation byte pair finder for this CPU. The CPU
+	 * is only checked on the first call.
+	 */
+	size_t (*unsyncPairFinder())(const uint8_t*, size_t, size_t) {
+		static size_t (*const FINDER)(const uint8_t*, size_t, size_t) = []() {
+			#ifdef ID3_X86_SIMD
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx2")) return findUnsyncPairAVX2;
+			if(__builtin_cpu_supports("sse2")) return findUnsyncPairSSE2;
+			#endif
+			return findUnsyncPairScalar;
+		}();
+		return FINDER;
+	}
+	
+	/**
+	 * Find the next UTF-16 NUL terminator, a pair of 0x00 bytes that starts
+	 * an even number of bytes after the start position.
+	 * 
+	 * @param bytes The bytes to search.
+	 * @param pos   The position to start searching from.
+	 * @param size  The number of bytes.
+	 * @return The position of the terminator, or size if there is none.
+	 */
+	size_t findWideNullScalar(const uint8_t* bytes, size_t pos, const size_t size) {
+		const size_t START = pos;
+		while(pos + 1 < size) {
+			const void* found = std::memchr(bytes + pos, 0x00, size - 1 - pos);
+			if(found == nullptr) break;
+			pos = static_cast<const uint8_t*>(found) - bytes;
+			//A 0x00 byte in the second half of a character isn't a terminator
+			if(((pos - START) & 1) != 0) { pos++; continue; }
+			if(bytes[pos + 1] == 0x00) return pos;
+			pos += 2;
+		}
+		return size;
+	}
+	
+	#ifdef ID3_X86_SIMD
+	/**
+	 * Find the next UTF-16 NUL terminator, checking eight characters at a
+	 * time.
+	 * 
+	 * @see findWideNullScalar()
+	 */
+	__attribute__((target("sse2")))
+	size_t findWideNullSSE2(const uint8_t* bytes, size_t pos, const size_t size) {
+		const __m128i ZERO = _mm_setzero_si128();
+		//Each block is compared against the same block shifted by one byte, and
+		//only the even positions are kept, as those start characters. The block
+		//size is even, so they stay even relative to the start position.
+		for(; pos + sizeof(__m128i) + 1 <= size; pos += sizeof(__m128i)) {
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos));
+			const __m128i next  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + pos + 1));
+			const int nulls = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block, ZERO),
+			                                                  _mm_cmpeq_epi8(next, ZERO))) & 0x5555;
+			if(nulls != 0) return pos + __builtin_ctz(nulls);
+		}
+		return findWideNullScalar(bytes, pos, size);
+	}
+	
+	/**
+	 * Find the next UTF-16 NUL terminator, checking sixteen characters at a
+	 * time.
+	 * 
+	 * @see findWideNullScalar()
+	 */
+	__attribute__((target("avx2")))
+	size_t findWideNullAVX2(const uint8_t* bytes, size_t pos, const size_t size) {
+		const __m256i ZERO = _mm256_setzero_si256();
+		for(; pos + sizeof(__m256i) + 1 <= size; pos += sizeof(__m256i)) {
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + pos));
+			const __m256i next  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes + pos + 1));
+			const unsigned nulls = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block, ZERO),
+			                                                             _mm256_cmpeq_epi8(next, ZERO))) & 0x55555555U;
+			if(nulls != 0) return pos + __builtin_ctz(nulls);
+		}
+		return findWideNullSSE2(bytes, pos, size);
+	}
+	#endif
+	
+	/**
+	 * Get the fastest UTF-16 NUL terminator finder for this CPU. The CPU is
+	 * only checked on the first call.
+	 */
+	size_t (*wideNullFinder())(const uint8_t*, size_t, size_t) {
+		static size_t (*const FINDER)(const uint8_t*, size_t, size_t) = []() {
+			#ifdef ID3_X86_SIMD
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx2")) return findWideNullAVX2;
+			if(__builtin_cpu_supports("sse2")) return findWideNullSSE2;
+			#endif
+			return findWideNullScalar;
+		}();
+		return FINDER;
+	}
+	
+	/**
+	 * Counts of the kinds of bytes in a UTF-8 string, which are enough to work
+	 * out its size in every ID3v2 text encoding.
+	 */
+	struct UTF8Counts {
+		size_t nonASCII;     //Bytes above 0x7F
+		size_t continuation; //Bytes 0x80 to 0xBF, which don't start a character
+		size_t beyondLatin1; //Bytes 0xC4 and above, which start a character above U+00FF
+		size_t fourByte;     //Bytes 0xF0 and above, which start a character above U+FFFF
+	};
+	
+	/**
+	 * Count the kinds of bytes in a UTF-8 string, one at a time.
+	 * 
+	 * @param utf8   The UTF-8 bytes.
+	 * @param size   The number of bytes.
+	 * @param counts The counts to add to.
+	 */
+	void countUTF8Scalar(const uint8_t* utf8, size_t size, UTF8Counts& counts) {
+		for(const uint8_t* const end = utf8 + size; utf8 != end; utf8++) {
+			const uint8_t curByte = *utf8;
+			counts.nonASCII     += curByte >= 0x80;
+			counts.continuation += (curByte & 0xC0) == 0x80;
+			counts.beyondLatin1 += curByte >= 0xC4;
+			counts.fourByte     += curByte >= 0xF0;
+		}
+	}
+	
+	#ifdef ID3_X86_SIMD
+	/**
+	 * Count the kinds of bytes in a UTF-8 string, sixteen at a time. The
+	 * comparisons are signed, so bytes above 0x7F are negative.
+	 * 
+	 * @see countUTF8Scalar()
+	 */
+	__attribute__((target("sse2")))
+	void countUTF8SSE2(const uint8_t* utf8, size_t size, UTF8Counts& counts) {
+		const __m128i CONTINUATION_END = _mm_set1_epi8(static_cast<char>(0xC0));
+		const __m128i LATIN1_LEAD_END  = _mm_set1_epi8(static_cast<char>(0xC3));
+		const __m128i THREE_BYTE_END   = _mm_set1_epi8(static_cast<char>(0xEF));
+		size_t i = 0;
+		for(; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+			const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(utf8 + i));
+			const unsigned nonASCII = _mm_movemask_epi8(block);
+			if(nonASCII == 0) continue;
+			counts.nonASCII     += __builtin_popcount(nonASCII);
+			counts.continuation += __builtin_popcount(_mm_movemask_epi8(_mm_cmplt_epi8(block, CONTINUATION_END)));
+			counts.beyondLatin1 += __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(block, LATIN1_LEAD_END)) & nonASCII);
+			counts.fourByte     += __builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(block, THREE_BYTE_END)) & nonASCII);
+		}
+		countUTF8Scalar(utf8 + i, size - i, counts);
+	}
+	
+	/**
+	 * Count the kinds of bytes in a UTF-8 string, thirty-two at a time.
+	 * 
+	 * @see countUTF8SSE2()
+	 */
+	__attribute__((target("avx2")))
+	void countUTF8AVX2(const uint8_t* utf8, size_t size, UTF8Counts& counts) {
+		const __m256i CONTINUATION_END = _mm256_set1_epi8(static_cast<char>(0xC0));
+		const __m256i LATIN1_LEAD_END  = _mm256_set1_epi8(static_cast<char>(0xC3));
+		const __m256i THREE_BYTE_END   = _mm256_set1_epi8(static_cast<char>(0xEF));
+		size_t i = 0;
+		for(; i + sizeof(__m256i) <= size; i += sizeof(__m256i)) {
+			const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(utf8 + i));
+			const unsigned nonASCII = _mm256_movemask_epi8(block);
+			if(nonASCII == 0) continue;
+			counts.nonASCII     += __builtin_popcount(nonASCII);
+			counts.continuation += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(CONTINUATION_END, block))));
+			counts.beyondLatin1 += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(block, LATIN1_LEAD_END))) & nonASCII);
+			counts.fourByte     += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(block, THREE_BYTE_END))) & nonASCII);
+		}
+		countUTF8SSE2(utf8 + i, size - i, counts);
+	}
+	#endif
+	
+	/**
+	 * Get the fastest UTF-8 byte counter for this CPU. The CPU is only checked
+	 * on the first call.
+	 */
+	void (*utf8Counter())(const uint8_t*, size_t, UTF8Counts&) {
+		static void (*const COUNTER)(const uint8_t*, size_t, UTF8Counts&) = []() {
+			#ifdef ID3_X86_SIMD
+			__builtin_cpu_init();
+			if(__builtin_cpu_supports("avx2")) return countUTF8AVX2;
+			if(__builtin_cpu_supports("sse2")) return countUTF8SSE2;
+			#endif
+			return countUTF8Scalar;
+		}();
+		return COUNTER;
+	}
+	
+	/**
+	 * Decode the UTF-8 character at a position. Malformed, overlong, and
+	 * surrogate sequences decode to U+FFFD one byte at a time.
+	 * 
+	 * @param utf8 The UTF-8 bytes.
+	 * @param size The number of bytes.
+	 * @param pos  The position of the character, which is moved past it.
+	 * @return The code point.
+	 */
+	uint32_t utf8CodePoint(const uint8_t* utf8, const size_t size, size_t& pos) {
+		const uint8_t lead = utf8[pos++];
+		if(lead < 0x80) return lead;
+		
+		//The number of continuation bytes, and the smallest code point that
+		//needs that many
+		size_t length;
+		uint32_t codePoint, minimum;
+		     if((lead & 0xE0) == 0xC0) { length = 1; codePoint = lead & 0x1F; minimum = 0x80; }
+		else if((lead & 0xF0) == 0xE0) { length = 2; codePoint = lead & 0x0F; minimum = 0x800; }
+		else if((lead & 0xF8) == 0xF0) { length = 3; codePoint = lead & 0x07; minimum = SUPPLEMENTARY_PLANE_START; }
+		else return REPLACEMENT_CHARACTER;
+		
+		if(pos + length > size) return REPLACEMENT_CHARACTER;
+		for(size_t i = 0; i < length; i++) {
+			if((utf8[pos + i] & 0xC0) != 0x80) return REPLACEMENT_CHARACTER;
+			codePoint = (codePoint << 6) | (utf8[pos + i] & 0x3F);
+		}
+		if(codePoint < minimum || codePoint > 0x10FFFF ||
+		   (codePoint >= HIGH_SURROGATE_START && codePoint <= LOW_SURROGATE_END))
+			return REPLACEMENT_CHARACTER;
+		pos += length;
+		return codePoint;
+	}
+	
+	//The primes of the XXH64 hash
+	const uint64_t XXH_PRIME1 = 11400714785074694791ULL, XXH_PRIME2 = 14029467366897019727ULL,
+	               XXH_PRIME3 = 1609587929392839161ULL,  XXH_PRIME4 = 9650029242287828579ULL,
+	               XXH_PRIME5 = 2870177450012600261ULL;
+	
+	inline uint64_t rotateLeft(const uint64_t value, const int bits) { return (value << bits) | (value >> (64 - bits)); }
+	
+	inline uint64_t hashRound(const uint64_t hash, const uint64_t input) {
+		return rotateLeft(hash + input * XXH_PRIME2, 31) * XXH_PRIME1;
+	}
+	
+	/**
+	 * Read a little-endian number, so that the hash doesn't depend on the
+	 * machine.
+	 */
+	inline uint64_t readLittleEndian(const uint8_t* const bytes, const size_t length) {
+		if(length == 8) {
+			uint64_t value;
+			std::memcpy(&value, bytes, 8);
+			#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+				value = __builtin_bswap64(value);
+			#endif
+			return value;
+		}
+		uint64_t value = 0;
+		for(size_t i = 0; i < length; i++) value |= static_cast<uint64_t>(bytes[i]) << (i * 8);
+		return value;
+	}
+}
+
 ///@pkg ID3Functions.h
 std::string ID3::V1::getGenreString(ushort genre) {
 	if(genre < V1::GENRES.size())
@@ -27,6 +717,37 @@ std::string ID3::V1::getGenreString(ushort genre) {
 	return "";
 }
 
+///@pkg ID3Functions.h
+std::string ID3::V1::processGenre(const std::string& genre) {
+	if(genre.empty()) return "";
+	std::string genreString;
+	
+	if(numericalString(genre)) {
+		genreString = V1::getGenreString(atoi(genre.c_str()));
+	} else {
+		//Look for digits surrounded by a single pair of parenthesis at the
+		//start of the string
+		std::string::size_type digitsEnd = 1;
+		ushort genreInt = 0;
+		if(genre[0] == '(') {
+			for(; digitsEnd < genre.size() && isdigit(static_cast<unsigned char>(genre[digitsEnd])); digitsEnd++)
+				//Larger numbers aren't ID3v1 genres, so stop counting
+				if(genreInt < 1000) genreInt = genreInt * 10 + (genre[digitsEnd] - '0');
+		}
+		
+		//If a ID3v1 genre is found
+		if(digitsEnd > 1 && digitsEnd < genre.size() && genre[digitsEnd] == ')') {
+			//Remove the ID3v1 genre from the tag string
+			genreString = genre.substr(digitsEnd + 1);
+			//If there's nothing else in the tag string, then return
+			//the ID3v1 genre
+			if(genreString.empty()) genreString = V1::getGenreString(genreInt);
+		} else { genreString = genre; }
+	}
+	
+	return genreString;
+}
+
 ///@pkg ID3Functions.h
 unsigned long long ID3::byteIntVal(uint8_t* array, int size, bool synchsafe) {
 	if(array == nullptr || size < 1) return 0;
@@ -94,71 +815,51 @@ std::string ID3::utf16toutf8(const ByteArray& u16s,
 	if(end - start < 2)
 		return "";
 	
-	const int u16sSize = end - start;
-	
-	//The byte offset to start processing the UTF-16 string
-	int offset = 0;
-	
-	//Create an array of 2-byte characters that is encoded in UTF-16
-	uint16_t* utf16CharArr = new uint16_t[u16sSize / 2];
-	
-	//The string to return
-	std::string toReturn;
+	const uint8_t* u16 = u16s.data() + start;
+	size_t u16sSize = end - start;
 	
 	//If it has the BOM, it checks the first character in the string.
-	//If it's 0xFFFE then it uses little endian, and the bytes for each character
-	//are flipped around. If it's 0xFEFF, then it uses big endian.
-	//If there's no BOM, then it's assumed the string uses big endian.
-	//ICU does not seem to processes the BOM or little endian encoding, so it has
-	//to be manually done. This is automatically checked and processed in
-	//utf16toutf8(), no need to mess with the BOM beforehand.
-	if((uint8_t)u16s[start] == 0xFF && (uint8_t)u16s[start+1] == 0xFE) { //Has Little Endian BOM
-		offset = 2; //Don't want to include the BOM in the returned string
-		
-		//Since this is in the case of little endian-ness, the byte with
-		//the most significant values are in the second byte.
-		for(int i = 0; i < u16sSize; i += 2)
-			utf16CharArr[i/2] = ((uint16_t)u16s[start + offset + i + 1] << 8) + (uint16_t)u16s[start + offset + i];
-	} else { //May or may not have BOM, is Big Endian
-		//Checks if the first character is 0xFEFF. If it is, then increment the
-		//starting position by two to remove the BOM from the returned string
-		if((uint8_t)u16s[start] == 0xFE && (uint8_t)u16s[start+1] == 0xFF)
-			offset = 2;
-		
-		for(int i = 0; i < u16sSize; i += 2)
-			utf16CharArr[i/2] = ((uint16_t)u16s[start + offset + i] << 8) + (uint16_t)u16s[start + i + offset + 1];
+	//If it's 0xFFFE then it uses little endian, and if it's 0xFEFF then it uses
+	//big endian. If there's no BOM, then it's assumed the string uses big endian.
+	//The BOM is not included in the returned string.
+	bool bigEndian = true;
+	if(u16[0] == 0xFF && u16[1] == 0xFE) { //Has Little Endian BOM
+		bigEndian = false;
+		u16 += 2;
+		u16sSize -= 2;
+	} else if(u16[0] == 0xFE && u16[1] == 0xFF) { //Has Big Endian BOM
+		u16 += 2;
+		u16sSize -= 2;
 	}
 	
-	//Create a UnicodeString from the UTF-16 character array
-	//If there was a BOM, the string will be one character shorter
-	//than the char vector.
-	icu::UnicodeString icuStr(utf16CharArr, (u16sSize - offset) / 2);
+	//A trailing odd byte is not a full character, so it is ignored
+	const size_t units = u16sSize / 2;
+	if(units == 0)
+		return "";
+	
+	//Measure the UTF-8 string first, so that it can be allocated once at its
+	//exact size and written into directly
+	const UTF16Kernel& kernel = utf16Kernel();
+	size_t utf8Size = 0;
+	kernel.toUTF8[bigEndian][false](u16, units, nullptr, utf8Size);
 	
-	//Have the UnicodeString converted to UTF-8 and store the result
-	//in toReturn.
-	icuStr.toUTF8String(toReturn);
+	std::string toReturn(utf8Size, '\0');
+	size_t utf8Pos = 0;
+	kernel.toUTF8[bigEndian][true](u16, units, &toReturn[0], utf8Pos);
 	
-	//Prevent memory leaks.
-	delete [] utf16CharArr;
+	//Each value of a multi-value string may start with its own byte order
+	//mark, which is U+FEFF once decoded with the byte order of the first
+	static const char ENCODED_BOM[] = "\0\xEF\xBB\xBF";
+	for(size_t bomPos = toReturn.find(ENCODED_BOM, 0, 4);
+	    bomPos != std::string::npos;
+	    bomPos = toReturn.find(ENCODED_BOM, bomPos + 1, 4))
+		toReturn.erase(bomPos + 1, 3);
 	
 	return toReturn;
 }
 
 ///@pkg ID3Functions.h
 std::string ID3::latin1toutf8(const ByteArray& latin1s, long start, long end) {
-	//0x80 (128) is the first character beyond ASCII
-	static const uint8_t BEYOND_ASCII = 0x80;
-	
-	//In UTF-8, if the first byte starts with "110" then it will be a two byte character
-	static const uint8_t UTF8_TWO_BYTE_MASK = 0b11000000;
-	
-	//In UTF-8, bytes of characters beyond the first byte don't have the first
-	//two bits usable, since these bytes will always be 0b10XXXXXX
-	static const uint8_t VARIABLE_UTF8_CHAR_USABLE_BITS = 6;
-	
-	//A mask to apply on the LATIN-1 character to store its value on the second byte
-	static const uint8_t UTF8_BYTE_TWO_MASK = 0b00111111;
-	
 	//Set the start
 	if(start < 0)
 		start = 0;
@@ -171,38 +872,21 @@ std::string ID3::latin1toutf8(const ByteArray& latin1s, long start, long end) {
 	if(end <= start)
 		return "";
 	
-	const int latin1sSize = end - start;
-	
-	int curPos = 0;
-		
-	//Create a char array to hold the translated UTF-8 string.
-	//In the worst case utf8CharArr's byte size will have to be twice the LATIN-1
-	//string's size, which will happen if the LATIN-1 string contains no ASCII
-	//characters.
-	char* utf8CharArr = new char[latin1sSize * 2];
-	
-	for(long i = start; i < end; i++) {
-		uint8_t curChar = latin1s[i];
-		
-		if(curChar < BEYOND_ASCII) {
-			//If curChar <= 127, it is an ASCII character that is identical in UTF-8
-			utf8CharArr[curPos] = curChar;
-			curPos++;
-		} else {
-			//Translate the LATIN-1 character to a UTF-8 character
-			utf8CharArr[curPos] = UTF8_TWO_BYTE_MASK | (curChar >> VARIABLE_UTF8_CHAR_USABLE_BITS);
-			utf8CharArr[curPos+1] = BEYOND_ASCII | (curChar & UTF8_BYTE_TWO_MASK);
-			curPos += 2;
-		}
-	}
+	const uint8_t* const latin1 = latin1s.data() + start;
+	const size_t latin1sSize = end - start;
+	const Latin1Kernel& kernel = latin1Kernel();
 	
-	//Create a string from the array
-	std::string toReturn(utf8CharArr, curPos);
+	//Every non-ASCII LATIN-1 character takes up two bytes in UTF-8, so the
+	//exact size of the UTF-8 string is known before translating
+	const size_t nonASCII = kernel.countNonASCII(latin1, latin1sSize);
 	
-	//Prevent memory leaks
-	delete [] utf8CharArr;
+	//If the string is all ASCII, it is already valid UTF-8
+	if(nonASCII == 0)
+		return std::string(reinterpret_cast<const char*>(latin1), latin1sSize);
 	
-	//Return the string
+	//Translate straight into the string to return
+	std::string toReturn(latin1sSize + nonASCII, '\0');
+	kernel.toUTF8(latin1, latin1sSize, &toReturn[0]);
 	return toReturn;
 }
 
@@ -237,7 +921,233 @@ std::string ID3::getUTF8String(uint8_t encoding,
 	}
 }
 
+///@pkg ID3Functions.h
+EncodedSizes ID3::encodedSizes(const std::string& utf8, bool terminated) {
+	UTF8Counts counts = {0, 0, 0, 0};
+	utf8Counter()(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.size(), counts);
+	
+	const ulong CODE_POINTS = utf8.size() - counts.continuation;
+	const ulong TERMINATOR  = terminated ? 1 : 0;
+	
+	EncodedSizes sizes;
+	sizes.latin1     = CODE_POINTS + TERMINATOR;
+	sizes.utf8       = utf8.size() + TERMINATOR;
+	//Characters above U+FFFF need a surrogate pair
+	sizes.utf16      = (CODE_POINTS + counts.fourByte + TERMINATOR) * 2;
+	sizes.ascii      = counts.nonASCII == 0;
+	sizes.fitsLatin1 = counts.beyondLatin1 == 0;
+	return sizes;
+}
+
+///@pkg ID3Functions.h
+void ID3::appendEncodedString(ByteArray&         bytes,
+                              uint8_t            encoding,
+                              const std::string& utf8,
+                              bool               terminate) {
+	const uint8_t* const str = reinterpret_cast<const uint8_t*>(utf8.data());
+	const size_t SIZE = utf8.size();
+	
+	switch(encoding) {
+		//UTF-16 case, written big-endian
+		case FrameEncoding::ENCODING_UTF16BOM:
+		case FrameEncoding::ENCODING_UTF16: {
+			bytes.reserve(bytes.size() + SIZE * 2 + 4);
+			if(encoding == FrameEncoding::ENCODING_UTF16BOM) {
+				bytes.push_back(0xFE);
+				bytes.push_back(0xFF);
+			}
+			for(size_t pos = 0; pos < SIZE;) {
+				uint32_t codePoint = utf8CodePoint(str, SIZE, pos);
+				if(codePoint >= SUPPLEMENTARY_PLANE_START) {
+					codePoint -= SUPPLEMENTARY_PLANE_START;
+					const uint16_t high = HIGH_SURROGATE_START + (codePoint >> 10);
+					bytes.push_back(high >> 8);
+					bytes.push_back(high & 0xFF);
+					codePoint = LOW_SURROGATE_START + (codePoint & 0x3FF);
+				}
+				bytes.push_back(codePoint >> 8);
+				bytes.push_back(codePoint & 0xFF);
+				//Each value of a multi-value string gets its own byte order mark
+				if(codePoint == 0 && pos < SIZE && encoding == FrameEncoding::ENCODING_UTF16BOM) {
+					bytes.push_back(0xFE);
+					bytes.push_back(0xFF);
+				}
+			}
+			if(terminate) bytes.insert(bytes.end(), 2, 0x00);
+			return;
+		}
+		//LATIN-1 case, where characters above U+00FF become question marks
+		case FrameEncoding::ENCODING_LATIN1: {
+			bytes.reserve(bytes.size() + SIZE + 1);
+			for(size_t pos = 0; pos < SIZE;) {
+				if(str[pos] < 0x80) {
+					bytes.push_back(str[pos++]);
+				} else {
+					const uint32_t codePoint = utf8CodePoint(str, SIZE, pos);
+					bytes.push_back(codePoint <= 0xFF ? codePoint : '?');
+				}
+			}
+			break;
+		}
+		//UTF-8 case
+		case FrameEncoding::ENCODING_UTF8: default:
+			bytes.insert(bytes.end(), str, str + SIZE);
+	}
+	if(terminate) bytes.push_back(0x00);
+}
+
+///@pkg ID3Functions.h
+ulong ID3::fitEncodedString(std::string&  utf8,
+                            const uint8_t encoding,
+                            const ulong   maxSize,
+                            const bool    terminated) {
+	const bool  WIDE_CHARS = encoding == FrameEncoding::ENCODING_UTF16BOM || encoding == FrameEncoding::ENCODING_UTF16;
+	const ulong BOM_SIZE   = encoding == FrameEncoding::ENCODING_UTF16BOM ? 2 : 0;
+	const uint8_t* const str = reinterpret_cast<const uint8_t*>(utf8.data());
+	const size_t SIZE = utf8.size();
+	
+	//The byte order mark and terminator are written even for an empty string
+	ulong encodedSize = BOM_SIZE + (terminated ? (WIDE_CHARS ? 2 : 1) : 0);
+	for(size_t pos = 0; pos < SIZE;) {
+		const uint8_t LEAD = str[pos];
+		const size_t LENGTH = std::min<size_t>(SIZE - pos, LEAD >= 0xF0 ? 4 : LEAD >= 0xE0 ? 3 : LEAD >= 0xC0 ? 2 : 1);
+		
+		//Characters above U+FFFF are a surrogate pair in UTF-16
+		ulong charSize = encoding == FrameEncoding::ENCODING_LATIN1 ? 1 :
+		                 WIDE_CHARS                                 ? (LENGTH == 4 ? 4 : 2) :
+		                                                              LENGTH;
+		if(LEAD == 0 && pos + 1 < SIZE) charSize += BOM_SIZE;
+		
+		if(encodedSize + charSize > maxSize) {
+			utf8.resize(pos);
+			break;
+		}
+		encodedSize += charSize;
+		pos += LENGTH;
+	}
+	return std::min(encodedSize, maxSize);
+}
+
 ///@pkg ID3Functions.h
 bool ID3::numericalString(const std::string& str) {
 	return std::all_of(str.begin(), str.end(), ::isdigit);
 }
+
+///@pkg ID3Functions.h
+ulong ID3::findNullTerminator(const ByteArray& bytes, ulong start, bool wideChars) {
+	const size_t SIZE = bytes.size();
+	if(start >= SIZE) return SIZE;
+	
+	//The C library's memchr() is already vectorised for single bytes
+	if(!wideChars) {
+		const void* found = std::memchr(bytes.data() + start, 0x00, SIZE - start);
+		return found == nullptr ? SIZE : static_cast<const uint8_t*>(found) - bytes.data();
+	}
+	
+	return wideNullFinder()(bytes.data(), start, SIZE);
+}
+
+///@pkg ID3Functions.h
+ulong ID3::resynchronise(ByteArray& bytes, ulong start) {
+	const size_t SIZE = bytes.size();
+	if(start >= SIZE) return 0;
+	
+	uint8_t* const data = bytes.data();
+	size_t (*const findPair)(const uint8_t*, size_t, size_t) = unsyncPairFinder();
+	
+	//Nothing has to be moved until the first byte pair
+	size_t readPos = findPair(data, start, SIZE);
+	if(readPos == SIZE) return 0;
+	size_t writePos = readPos;
+	
+	//Each loop moves the bytes up to and including the next pair's 0xFF byte,
+	//then skips over the pair's 0x00 byte
+	while(readPos < SIZE) {
+		const size_t pairPos = findPair(data, readPos, SIZE);
+		const size_t copyEnd = pairPos == SIZE ? SIZE : pairPos + 1;
+		if(writePos != readPos)
+			std::memmove(data + writePos, data + readPos, copyEnd - readPos);
+		writePos += copyEnd - readPos;
+		readPos = copyEnd + 1;
+	}
+	
+	bytes.resize(writePos);
+	return SIZE - writePos;
+}
+
+///@pkg ID3Functions.h
+uint64_t ID3::hashBytes(const uint8_t* bytes, size_t size) {
+	ByteHasher hasher;
+	hasher.update(bytes, size);
+	return hasher.digest();
+}
+
+///@pkg ID3Functions.h
+ID3::ByteHasher::ByteHasher() noexcept : lanes{XXH_PRIME1 + XXH_PRIME2, XXH_PRIME2, 0, 0 - XXH_PRIME1},
+                                         length(0) {}
+
+///@pkg ID3Functions.h
+void ID3::ByteHasher::update(const uint8_t* bytes, size_t size) noexcept {
+	size_t buffered = length % sizeof(stripe);
+	length += size;
+	
+	//Finish the stripe left over from the last update
+	if(buffered > 0) {
+		const size_t FILL = std::min(size, sizeof(stripe) - buffered);
+		std::memcpy(stripe + buffered, bytes, FILL);
+		bytes += FILL, size -= FILL, buffered += FILL;
+		if(buffered < sizeof(stripe)) return;
+		for(int lane = 0; lane < 4; lane++)
+			lanes[lane] = hashRound(lanes[lane], readLittleEndian(stripe + lane * 8, 8));
+	}
+	
+	//Hash whole stripes in four independent lanes
+	for(; size >= sizeof(stripe); bytes += sizeof(stripe), size -= sizeof(stripe))
+		for(int lane = 0; lane < 4; lane++)
+			lanes[lane] = hashRound(lanes[lane], readLittleEndian(bytes + lane * 8, 8));
+	std::memcpy(stripe, bytes, size);
+}
+
+///@pkg ID3Functions.h
+void ID3::ByteHasher::update(const std::string& text) noexcept {
+	update(static_cast<uint64_t>(text.size()));
+	update(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+}
+
+///@pkg ID3Functions.h
+void ID3::ByteHasher::update(const uint64_t number) noexcept {
+	uint8_t bytes[8];
+	for(size_t i = 0; i < 8; i++) bytes[i] = number >> (i * 8);
+	update(bytes, 8);
+}
+
+///@pkg ID3Functions.h
+uint64_t ID3::ByteHasher::digest() const noexcept {
+	uint64_t hash;
+	if(length >= sizeof(stripe)) {
+		hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+		for(const uint64_t lane : lanes)
+			hash = (hash ^ hashRound(0, lane)) * XXH_PRIME1 + XXH_PRIME4;
+	} else {
+		hash = XXH_PRIME5;
+	}
+	hash += length;
+	
+	//Hash the bytes after the last whole stripe
+	const uint8_t* bytes = stripe;
+	size_t size = length % sizeof(stripe);
+	for(; size >= 8; bytes += 8, size -= 8)
+		hash = rotateLeft(hash ^ hashRound(0, readLittleEndian(bytes, 8)), 27) * XXH_PRIME1 + XXH_PRIME4;
+	if(size >= 4) {
+		hash = rotateLeft(hash ^ (readLittleEndian(bytes, 4) * XXH_PRIME1), 23) * XXH_PRIME2 + XXH_PRIME3;
+		bytes += 4, size -= 4;
+	}
+	for(; size > 0; bytes++, size--)
+		hash = rotateLeft(hash ^ (*bytes * XXH_PRIME5), 11) * XXH_PRIME1;
+	
+	hash ^= hash >> 33;
+	hash *= XXH_PRIME2;
+	hash ^= hash >> 29;
+	hash *= XXH_PRIME3;
+	return hash ^ (hash >> 32);
+}
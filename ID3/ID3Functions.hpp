@@ -42,6 +42,16 @@ namespace ID3 {
 		 * @returns The genre if the genre was found, and a blank string otherwise.
 		 */
 		std::string getGenreString(ushort genre);
+		
+		/**
+		 * A function to process the text of an ID3v2 genre frame, replacing an
+		 * ID3v1 genre number, alone or in parenthesis at the start, with the
+		 * genre it refers to.
+		 * @param genre The genre frame's text.
+		 * @returns The processed genre.
+		 * @see ID3::Tag::genre(bool)
+		 */
+		std::string processGenre(const std::string& genre);
 	}
 	
 	/**
@@ -92,6 +102,12 @@ namespace ID3 {
 	 * or without the BOM) created from ID3::Frame::getTextFrame(), and
 	 * returns the string encoded in UTF-8.
 	 * 
+	 * NOTE: Surrogate pairs are combined, and unpaired surrogates are
+	 *       replaced with U+FFFD. A trailing odd byte is ignored. ASCII runs
+	 *       are narrowed a block at a time, using SSE2 or AVX2 when the CPU
+	 *       supports them, and the UTF-8 string is allocated once at its
+	 *       exact size.
+	 * 
 	 * @param u16s The char vector that contains a UTF-16 encoded string.
 	 * @param start The byte position in the ByteArray to start reading (optional).
 	 *              If given a negative value, it will default to 0.
@@ -108,6 +124,10 @@ namespace ID3 {
 	 * utf16toutf8() takes a char vector of a string encoded in LATIN-1 created
 	 * from ID3::Frame::getTextFrame(), and returns the string encoded in UTF-8.
 	 * 
+	 * NOTE: ASCII runs are copied a block at a time, using SSE2 or AVX2 when
+	 *       the CPU supports them, and the UTF-8 string is allocated once at
+	 *       its exact size. An all-ASCII string is copied without translating.
+	 * 
 	 * @param u16s The char vector that contains a LATIN-1 encoded string.
 	 * @param start The byte position in the ByteArray to start reading (optional).
 	 *              If given a negative value, it will default to 0.
@@ -145,6 +165,87 @@ namespace ID3 {
 	                          long start=-1,
 	                          long end=-1);
 	
+	/**
+	 * The number of bytes a UTF-8 string takes up in each ID3v2 text encoding.
+	 * 
+	 * @see ID3::encodedSizes()
+	 */
+	struct EncodedSizes {
+		ulong latin1;    //Only meaningful if fitsLatin1 is true
+		ulong utf8;
+		ulong utf16;     //Without a byte order mark
+		bool ascii;      //If the string is pure ASCII
+		bool fitsLatin1; //If every character is U+00FF or below
+		
+		/**
+		 * Add the sizes of another string that will be written with the same
+		 * encoding.
+		 */
+		EncodedSizes& operator+=(const EncodedSizes& other) {
+			latin1 += other.latin1;
+			utf8 += other.utf8;
+			utf16 += other.utf16;
+			ascii = ascii && other.ascii;
+			fitsLatin1 = fitsLatin1 && other.fitsLatin1;
+			return *this;
+		}
+	};
+	
+	/**
+	 * Work out how many bytes a UTF-8 string would take up in LATIN-1, UTF-8,
+	 * and UTF-16, without encoding it.
+	 * 
+	 * NOTE: The string is scanned once, sixteen or thirty-two bytes at a time
+	 *       when the CPU supports SSE2 or AVX2. It is assumed to be valid
+	 *       UTF-8.
+	 * 
+	 * @param utf8       The UTF-8 string.
+	 * @param terminated If the string will be followed by a NUL terminator
+	 *                   (optional).
+	 * @return The sizes in each encoding.
+	 */
+	EncodedSizes encodedSizes(const std::string& utf8, bool terminated=false);
+	
+	/**
+	 * Encode a UTF-8 string in an ID3v2 text encoding, and append it to a
+	 * ByteArray. This is the opposite of ID3::getUTF8String().
+	 * 
+	 * NOTE: UTF-16 is written big-endian. If the encoding is
+	 *       ID3::FrameEncoding::ENCODING_UTF16BOM, a byte order mark is written
+	 *       before the string and before each value after a NUL separator of
+	 *       a multi-value string. Characters that can't be encoded in LATIN-1
+	 *       are written as question marks.
+	 * 
+	 * @param bytes     The ByteArray to append to.
+	 * @param encoding  A value of the enum ID3::FrameEncoding. If the encoding
+	 *                  is unknown it will default to UTF-8.
+	 * @param utf8      The UTF-8 string to encode.
+	 * @param terminate If a NUL terminator should be appended after the
+	 *                  string (optional).
+	 */
+	void appendEncodedString(ByteArray&         bytes,
+	                         uint8_t            encoding,
+	                         const std::string& utf8,
+	                         bool               terminate=false);
+	
+	/**
+	 * Cut off a UTF-8 string so that it fits in a number of bytes once it's
+	 * encoded with ID3::appendEncodedString(), without cutting a character
+	 * in half.
+	 * 
+	 * @param utf8       The UTF-8 string, which is shortened if it doesn't fit.
+	 * @param encoding   A value of the enum ID3::FrameEncoding.
+	 * @param maxSize    The most bytes the encoded string may take up.
+	 * @param terminated If the string will be followed by a NUL terminator
+	 *                   (optional).
+	 * @return The number of bytes the encoded string takes up, which is at
+	 *         most maxSize.
+	 */
+	ulong fitEncodedString(std::string&  utf8,
+	                       const uint8_t encoding,
+	                       const ulong   maxSize,
+	                       const bool    terminated=false);
+	
 	/**
 	 * Check if a string contains only digits.
 	 * 
@@ -152,6 +253,107 @@ namespace ID3 {
 	 * @return If the string is numerical.
 	 */
 	bool numericalString(const std::string& str);
+	
+	/**
+	 * Find the NUL character that terminates a string in a frame. In UTF-16
+	 * encodings the terminator is two 0x00 bytes that start a character, so
+	 * only positions an even number of bytes after the start are checked.
+	 * 
+	 * NOTE: Wide terminators are searched for a block at a time, using SSE2
+	 *       or AVX2 when the CPU supports them.
+	 * 
+	 * @param bytes     The bytes to search.
+	 * @param start     The position the string starts at.
+	 * @param wideChars If the string is encoded in UTF-16 (optional).
+	 * @return The position of the terminator, or the size of the ByteArray
+	 *         if the string isn't terminated.
+	 */
+	ulong findNullTerminator(const ByteArray& bytes, ulong start, bool wideChars=false);
+	
+	/**
+	 * Undo ID3v2 unsynchronisation in place. Unsynchronisation inserts a 0x00
+	 * byte after every 0xFF byte that could be mistaken for an MPEG sync
+	 * signal, so every 0xFF 0x00 byte pair after the start position has its
+	 * 0x00 removed and the ByteArray is shortened to fit.
+	 * 
+	 * NOTE: The byte pairs are found a block at a time, using SSE2 or AVX2
+	 *       when the CPU supports them, and the bytes between them are moved
+	 *       up in place. No memory is allocated.
+	 * 
+	 * @param bytes The unsynchronised bytes.
+	 * @param start The position to start decoding from (optional). Bytes
+	 *              before it, such as a header, are left as-is.
+	 * @return The number of bytes removed.
+	 */
+	ulong resynchronise(ByteArray& bytes, ulong start=0);
+	
+	/**
+	 * Calculate the 64-bit XXH64 hash of some bytes, with a seed of 0. The
+	 * hash is the same on every machine.
+	 * 
+	 * @param bytes The bytes to hash.
+	 * @param size  The number of bytes.
+	 * @return The hash.
+	 * @see ID3::ByteHasher
+	 */
+	uint64_t hashBytes(const uint8_t* bytes, size_t size);
+	
+	/**
+	 * ByteHasher calculates the same hash as ID3::hashBytes() of bytes that
+	 * are given a piece at a time, so that a file can be hashed without
+	 * reading all of it into memory.
+	 */
+	class ByteHasher {
+		public:
+			/**
+			 * Start a hash of no bytes.
+			 */
+			ByteHasher() noexcept;
+			
+			/**
+			 * Add bytes to the hash.
+			 * 
+			 * @param bytes The bytes to add.
+			 * @param size  The number of bytes.
+			 */
+			void update(const uint8_t* bytes, size_t size) noexcept;
+			
+			/**
+			 * Add a string to the hash, after its length, so that strings added
+			 * one after another can't run together.
+			 * 
+			 * @param text The string to add.
+			 */
+			void update(const std::string& text) noexcept;
+			
+			/**
+			 * Add a number to the hash, as 8 little-endian bytes.
+			 * 
+			 * @param number The number to add.
+			 */
+			void update(const uint64_t number) noexcept;
+			
+			/**
+			 * @return The hash of the bytes added so far.
+			 */
+			uint64_t digest() const noexcept;
+		
+		private:
+			/**
+			 * The hash of each 8-byte lane of the 32-byte stripes hashed so far.
+			 */
+			uint64_t lanes[4];
+			
+			/**
+			 * The bytes after the last whole stripe.
+			 */
+			uint8_t stripe[32];
+			
+			/**
+			 * The number of bytes added so far.
+			 */
+			uint64_t length;
+	};
 }
 
 #endif
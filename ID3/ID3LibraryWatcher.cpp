@@ -0,0 +1,238 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <vector>        //For std::vector
+#include <algorithm>     //For std::min
+#include <cerrno>        //For errno
+#include <sys/inotify.h> //For inotify_init1(), inotify_add_watch(), and inotify_rm_watch()
+#include <poll.h>        //For poll()
+#include <dirent.h>      //For opendir(), readdir(), and closedir()
+#include <sys/stat.h>    //For lstat() and stat()
+#include <unistd.h>      //For read() and close()
+
+#include "ID3LibraryWatcher.hpp" //For the class definition
+#include "ID3Exception.hpp"      //For exceptions
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The inotify events of a watched directory that change the files in it.
+	 */
+	const uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+	
+	/**
+	 * Check if a file location is in a directory, or under it.
+	 */
+	bool inDirectory(const std::string& fileLoc, const std::string& dirLoc) {
+		return fileLoc.size() > dirLoc.size() &&
+		       fileLoc[dirLoc.size()] == '/' &&
+		       fileLoc.compare(0, dirLoc.size(), dirLoc) == 0;
+	}
+}
+
+///@pkg ID3LibraryWatcher.h
+LibraryWatcher::LibraryWatcher(const std::string& rootLoc,
+                               TagCache&          cache,
+                               TagIndex* const    index,
+                               const ulong        debounceMillis) : root(rootLoc),
+                                                                    tagCache(cache),
+                                                                    tagIndex(index),
+                                                                    debounce(std::chrono::milliseconds(debounceMillis)),
+                                                                    fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)),
+                                                                    overflowed(false) {
+	while(root.size() > 1 && root.back() == '/') root.pop_back();
+	if(fd < 0 || !watch(root, false)) {
+		if(fd >= 0) ::close(fd);
+		throw FileNotFoundException("Cannot watch the directory \"" + rootLoc + "\".");
+	}
+}
+
+///@pkg ID3LibraryWatcher.h
+LibraryWatcher::~LibraryWatcher() { ::close(fd); }
+
+///@pkg ID3LibraryWatcher.h
+size_t LibraryWatcher::poll(const int timeoutMillis) {
+	//Wake up when the first changed file is due, if that's sooner
+	int timeout = timeoutMillis;
+	if(!changedFiles.empty()) {
+		Clock::time_point due = Clock::time_point::max();
+		for(const auto& file : changedFiles)
+			due = std::min(due, file.second + debounce);
+		const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(due - Clock::now()).count() + 1;
+		const int dueMillis = wait < 0 ? 0 : static_cast<int>(std::min<long long>(wait, 1000000000));
+		timeout = timeout < 0 ? dueMillis : std::min(timeout, dueMillis);
+	}
+	
+	pollfd descriptor = {fd, POLLIN, 0};
+	if(::poll(&descriptor, 1, timeout) > 0) readEvents();
+	if(overflowed) return rescan();
+	
+	//Rescan the files that haven't changed for the debounce time. Files that
+	//fail stay queued, and are retried after the debounce time.
+	const Clock::time_point NOW = Clock::now();
+	std::vector<std::string> dueFiles;
+	for(const auto& file : changedFiles)
+		if(NOW - file.second >= debounce) dueFiles.push_back(file.first);
+	size_t rescanned = 0;
+	for(const std::string& fileLoc : dueFiles) {
+		if(rescanFile(fileLoc)) {
+			changedFiles.erase(fileLoc);
+			rescanned++;
+		} else {
+			changedFiles[fileLoc] = Clock::now();
+		}
+	}
+	return rescanned;
+}
+
+///@pkg ID3LibraryWatcher.h
+size_t LibraryWatcher::rescan() {
+	//Watch any directories that were missed, and queue every file
+	overflowed = false;
+	watch(root, true);
+	size_t rescanned = 0;
+	const Clock::time_point NOW = Clock::now();
+	for(auto file = changedFiles.begin(); file != changedFiles.end();) {
+		if(rescanFile(file->first)) {
+			file = changedFiles.erase(file);
+			rescanned++;
+		} else {
+			file->second = NOW;
+			file++;
+		}
+	}
+	
+	//Files that weren't found have been deleted
+	if(tagIndex != nullptr) {
+		struct stat info;
+		for(const TagIndex::Row row : tagIndex->all()) {
+			const std::string fileLoc = tagIndex->path(row).str();
+			if(inDirectory(fileLoc, root) && stat(fileLoc.c_str(), &info) != 0) {
+				tagIndex->remove(fileLoc);
+				rescanned++;
+			}
+		}
+	}
+	return rescanned;
+}
+
+///@pkg ID3LibraryWatcher.h
+int LibraryWatcher::fileDescriptor() const { return fd; }
+
+///@pkg ID3LibraryWatcher.h
+size_t LibraryWatcher::pending() const { return changedFiles.size(); }
+
+///@pkg ID3LibraryWatcher.h
+bool LibraryWatcher::watch(const std::string& dirLoc, const bool queueFiles) {
+	const int wd = inotify_add_watch(fd, dirLoc.c_str(), WATCH_EVENTS | IN_ONLYDIR | IN_DONT_FOLLOW);
+	if(wd < 0) return false;
+	directories[wd] = dirLoc;
+	
+	DIR* const dir = opendir(dirLoc.c_str());
+	if(dir == nullptr) return true;
+	const Clock::time_point NOW = Clock::now();
+	while(const dirent* const file = readdir(dir)) {
+		const std::string name = file->d_name;
+		if(name == "." || name == "..") continue;
+		const std::string fileLoc = dirLoc + '/' + name;
+		
+		//Not every file system gives the file type
+		unsigned char type = file->d_type;
+		struct stat info;
+		if(type == DT_UNKNOWN && lstat(fileLoc.c_str(), &info) == 0)
+			type = S_ISDIR(info.st_mode) ? DT_DIR : S_ISREG(info.st_mode) ? DT_REG : DT_UNKNOWN;
+		
+		if(type == DT_DIR)
+			watch(fileLoc, queueFiles);
+		else if(type == DT_REG && queueFiles)
+			changedFiles[fileLoc] = NOW;
+	}
+	closedir(dir);
+	return true;
+}
+
+///@pkg ID3LibraryWatcher.h
+void LibraryWatcher::unwatch(const std::string& dirLoc) {
+	for(auto dir = directories.begin(); dir != directories.end();) {
+		if(dir->second == dirLoc || inDirectory(dir->second, dirLoc)) {
+			inotify_rm_watch(fd, dir->first);
+			dir = directories.erase(dir);
+		} else { dir++; }
+	}
+	
+	//The files that were in the directory are gone from their old paths
+	if(tagIndex != nullptr) {
+		const Clock::time_point NOW = Clock::now();
+		for(const TagIndex::Row row : tagIndex->all()) {
+			const std::string fileLoc = tagIndex->path(row).str();
+			if(inDirectory(fileLoc, dirLoc)) changedFiles[fileLoc] = NOW;
+		}
+	}
+}
+
+///@pkg ID3LibraryWatcher.h
+void LibraryWatcher::readEvents() {
+	alignas(inotify_event) char buffer[64 * 1024];
+	while(true) {
+		const ssize_t length = read(fd, buffer, sizeof(buffer));
+		if(length < 0 && errno == EINTR) continue;
+		if(length <= 0) return;
+		
+		const Clock::time_point NOW = Clock::now();
+		for(ssize_t pos = 0; pos < length;) {
+			const inotify_event* const event = reinterpret_cast<const inotify_event*>(buffer + pos);
+			pos += sizeof(inotify_event) + event->len;
+			
+			if(event->mask & IN_Q_OVERFLOW) {
+				overflowed = true;
+				continue;
+			}
+			const auto dir = directories.find(event->wd);
+			if(dir == directories.end()) continue;
+			if(event->mask & IN_IGNORED) {
+				directories.erase(dir);
+				continue;
+			}
+			if(event->len == 0) continue;
+			
+			const std::string fileLoc = dir->second + '/' + event->name;
+			if(!(event->mask & IN_ISDIR))
+				changedFiles[fileLoc] = NOW;
+			else if(event->mask & (IN_CREATE | IN_MOVED_TO))
+				watch(fileLoc, true);
+			else if(event->mask & (IN_DELETE | IN_MOVED_FROM))
+				unwatch(fileLoc);
+		}
+	}
+}
+
+///@pkg ID3LibraryWatcher.h
+bool LibraryWatcher::rescanFile(const std::string& fileLoc) {
+	try {
+		//A file that was read but couldn't be cached keeps its index entry,
+		//as it isn't gone
+		const ErrorCode error = tagCache.update(fileLoc);
+		if(error == ErrorCode::WRITE || error == ErrorCode::OTHER) return false;
+		if(tagIndex == nullptr) return true;
+		
+		TagCache::Entry entry;
+		if(tagCache.find(fileLoc, entry))
+			tagIndex->add(fileLoc, entry);
+		else
+			tagIndex->remove(fileLoc);
+		return true;
+	} catch(...) {
+		return false;
+	}
+}
@@ -0,0 +1,195 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_LIBRARY_WATCHER_HPP
+#define ID3_LIBRARY_WATCHER_HPP
+
+#include <string>        //For std::string
+#include <unordered_map> //For std::unordered_map
+#include <chrono>        //For std::chrono::steady_clock
+
+#include "ID3TagCache.hpp" //For TagCache
+#include "ID3TagIndex.hpp" //For TagIndex
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * LibraryWatcher keeps a TagCache, and optionally a TagIndex, up to date
+	 * with a music library directory by watching it for changes with inotify,
+	 * instead of scanning the whole library again.
+	 * 
+	 * Every directory under the library root is watched. When a file is
+	 * written, created, deleted, or moved, it is rescanned once it hasn't
+	 * changed for the debounce time, so a file that is written several times
+	 * in a row is only read once. A file that is moved or renamed without
+	 * being changed keeps its cache entry and isn't read again.
+	 * 
+	 * Changes are only handled when poll() is called, so the watcher can be
+	 * used from an existing event loop with fileDescriptor().
+	 * 
+	 * NOTE: LibraryWatcher uses inotify, so it's only available on Linux.
+	 *       Symbolic links to directories aren't followed. If the kernel's
+	 *       event queue overflows, the whole library is rescanned.
+	 * 
+	 * @see ID3::TagCache::update()
+	 */
+	class LibraryWatcher {
+		public:
+			/**
+			 * Start watching a library directory.
+			 * 
+			 * NOTE: Files that changed before the watcher was created aren't
+			 *       rescanned. Call rescan() to bring the cache up to date first.
+			 * 
+			 * @param rootLoc        The library directory.
+			 * @param cache          The TagCache to update.
+			 * @param index          The TagIndex to update, or nullptr (optional,
+			 *                       defaults to nullptr).
+			 * @param debounceMillis How long a file must not change before it's
+			 *                       rescanned, in milliseconds (optional, defaults
+			 *                       to 500).
+			 * @throws ID3::FileNotFoundException if the directory can't be watched.
+			 */
+			LibraryWatcher(const std::string& rootLoc,
+			               TagCache&          cache,
+			               TagIndex* const    index=nullptr,
+			               const ulong        debounceMillis=500);
+			
+			/**
+			 * The destructor, which stops watching the library.
+			 */
+			~LibraryWatcher();
+			
+			LibraryWatcher(const LibraryWatcher&) = delete;
+			LibraryWatcher& operator=(const LibraryWatcher&) = delete;
+			
+			/**
+			 * Wait for changes to the library, and rescan the files whose
+			 * changes have settled. It returns early if a file is due to be
+			 * rescanned before the timeout.
+			 * 
+			 * NOTE: A file that can't be rescanned, such as when the cache can't
+			 *       be written to, stays pending and is retried once the debounce
+			 *       time has passed again.
+			 * 
+			 * @param timeoutMillis How long to wait for changes, in milliseconds.
+			 *                      0 doesn't wait, and -1 waits until there is a
+			 *                      change (optional, defaults to 0).
+			 * @return The number of files rescanned.
+			 */
+			size_t poll(const int timeoutMillis=0);
+			
+			/**
+			 * Rescan every file in the library. Unchanged files aren't read, and
+			 * files that no longer exist are removed from the index. Files that
+			 * can't be rescanned stay pending, as with poll().
+			 * 
+			 * @return The number of files rescanned.
+			 */
+			size_t rescan();
+			
+			/**
+			 * @return The inotify file descriptor, which is readable when there
+			 *         are changes for poll() to handle.
+			 */
+			int fileDescriptor() const;
+			
+			/**
+			 * @return The number of changed files waiting to be rescanned.
+			 */
+			size_t pending() const;
+		
+		private:
+			typedef std::chrono::steady_clock Clock;
+			
+			/**
+			 * Watch a directory and every directory under it.
+			 * 
+			 * @param dirLoc     The directory.
+			 * @param queueFiles Whether to queue the files in the directories to
+			 *                   be rescanned, for directories moved into the
+			 *                   library.
+			 * @return false if the directory couldn't be watched, true otherwise.
+			 */
+			bool watch(const std::string& dirLoc, const bool queueFiles);
+			
+			/**
+			 * Stop watching a directory and every directory under it, and queue
+			 * the files that were in them in the index to be rescanned.
+			 * 
+			 * @param dirLoc The directory.
+			 */
+			void unwatch(const std::string& dirLoc);
+			
+			/**
+			 * Read the waiting inotify events.
+			 */
+			void readEvents();
+			
+			/**
+			 * Rescan a file, updating the cache and index.
+			 * 
+			 * @param fileLoc The file location.
+			 * @return false if the file has to be rescanned again, because it
+			 *         couldn't be added to the cache or an error was thrown, true
+			 *         otherwise.
+			 */
+			bool rescanFile(const std::string& fileLoc);
+			
+			/**
+			 * The library directory.
+			 */
+			std::string root;
+			
+			/**
+			 * The cache and index to update.
+			 */
+			TagCache& tagCache;
+			TagIndex* tagIndex;
+			
+			/**
+			 * How long a file must not change before it's rescanned.
+			 */
+			Clock::duration debounce;
+			
+			/**
+			 * The inotify file descriptor.
+			 */
+			int fd;
+			
+			/**
+			 * The watched directories, by watch descriptor.
+			 */
+			std::unordered_map<int, std::string> directories;
+			
+			/**
+			 * The files waiting to be rescanned, and when they last changed.
+			 */
+			std::unordered_map<std::string, Clock::time_point> changedFiles;
+			
+			/**
+			 * Whether events were lost and the whole library must be rescanned.
+			 */
+			bool overflowed;
+	};
+}
+
+#endif
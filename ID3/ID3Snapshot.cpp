@@ -0,0 +1,340 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <cstring>    //For memcmp() and memcpy()
+#include <cstdlib>    //For strtoul()
+#include <cerrno>     //For errno
+#include <climits>    //For USHRT_MAX
+#include <algorithm>  //For std::sort and std::min
+#include <numeric>    //For std::iota
+#include <fcntl.h>    //For open()
+#include <unistd.h>   //For pwrite(), fsync(), close(), and unlink()
+#include <stdio.h>    //For rename()
+#include <libgen.h>   //For dirname()
+#include <sys/mman.h> //For mmap() and munmap()
+#include <sys/stat.h> //For fstat()
+
+#include "ID3Snapshot.hpp"  //For the class definitions
+#include "ID3Exception.hpp" //For exceptions
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The bytes at the start of a snapshot file: a magic string, the format
+	 * version, and a number to check the byte order with.
+	 */
+	const char SNAPSHOT_MAGIC[8] = {'I', 'D', '3', 'S', 'N', 'A', 'P', 'S'};
+	const uint32_t SNAPSHOT_VERSION = 2;
+	const uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304;
+	
+	/**
+	 * The columns of a snapshot file, in the order they're stored in. The
+	 * text columns are in the order of ID3::SnapshotText.
+	 */
+	enum Column : size_t {
+		STRING_OFFSETS, //uint64_t, one more than the number of strings
+		STRING_BYTES,   //The strings, one after the other
+		TEXT_COLUMNS,   //uint32_t string IDs, one column per SnapshotText
+		PLAY_COUNT = TEXT_COLUMNS + static_cast<size_t>(SnapshotText::GENRE) + 1, //uint64_t
+		PICTURE_HASH, //uint64_t
+		DURATION,     //uint32_t
+		YEAR,         //uint16_t
+		TRACK,        //uint16_t
+		TRACK_TOTAL,  //uint16_t
+		DISC,         //uint16_t
+		DISC_TOTAL,   //uint16_t
+		RATING,       //uint8_t
+		COLUMNS
+	};
+	
+	/**
+	 * The header of a snapshot file, followed by the columns. Each column
+	 * starts on an 8-byte boundary.
+	 */
+	struct SnapshotHeader {
+		char     magic[sizeof(SNAPSHOT_MAGIC)];
+		uint32_t version;
+		uint32_t byteOrder;
+		uint64_t rows;
+		uint64_t strings;
+		uint64_t stringBytes;
+		uint64_t columnOffsets[COLUMNS];
+	};
+	
+	/**
+	 * Round a file offset up to the start of the next column.
+	 */
+	inline uint64_t align(const uint64_t offset) { return (offset + 7) & ~static_cast<uint64_t>(7); }
+	
+	/**
+	 * Get the number in a string, or 0 if it doesn't start with one.
+	 */
+	uint16_t toShort(const std::string& text) {
+		return std::min<ulong>(strtoul(text.c_str(), nullptr, 10), USHRT_MAX);
+	}
+	
+	/**
+	 * Write all of some bytes to a file descriptor.
+	 * 
+	 * @return false if they couldn't all be written, true otherwise.
+	 */
+	bool writeAll(const int fd, const void* const data, ulong size, ulong offset) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		while(size > 0) {
+			const ssize_t written = pwrite(fd, bytes, size, offset);
+			if(written < 0 && errno == EINTR) continue;
+			if(written <= 0) return false;
+			bytes += written, offset += written, size -= written;
+		}
+		return true;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////// SnapshotWriter //////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+///@pkg ID3Snapshot.h
+void SnapshotWriter::add(const Tag& tag) { add(tag.fileName(), tag); }
+
+///@pkg ID3Snapshot.h
+void SnapshotWriter::add(const std::string& fileLoc, const Tag& tag) {
+	textColumns[static_cast<size_t>(SnapshotText::PATH)].push_back(intern(fileLoc));
+	textColumns[static_cast<size_t>(SnapshotText::TITLE)].push_back(intern(tag.title()));
+	textColumns[static_cast<size_t>(SnapshotText::ARTIST)].push_back(intern(tag.artist()));
+	textColumns[static_cast<size_t>(SnapshotText::ALBUM)].push_back(intern(tag.album()));
+	textColumns[static_cast<size_t>(SnapshotText::ALBUM_ARTIST)].push_back(intern(tag.albumArtist()));
+	textColumns[static_cast<size_t>(SnapshotText::GENRE)].push_back(intern(tag.genre()));
+	
+	const Picture picture = tag.picture();
+	playCounts.push_back(tag.playCount());
+	pictureHashes.push_back(picture.null() ? 0 : picture.hash());
+	durations.push_back(std::min<ulong>(strtoul(tag.textString(FRAME_LENGTH).c_str(), nullptr, 10), UINT32_MAX));
+	years.push_back(toShort(tag.year()));
+	tracks.push_back(toShort(tag.track()));
+	trackTotals.push_back(toShort(tag.trackTotal()));
+	discs.push_back(toShort(tag.disc()));
+	discTotals.push_back(toShort(tag.discTotal()));
+	ratings.push_back(tag.rating());
+}
+
+///@pkg ID3Snapshot.h
+void SnapshotWriter::write(const std::string& snapshotLoc) const {
+	//Sort the dictionary, so that comparing string IDs compares the strings
+	std::vector<uint32_t> order(strings.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [this](const uint32_t a, const uint32_t b) { return strings[a] < strings[b]; });
+	std::vector<uint32_t> newIDs(strings.size());
+	std::vector<uint64_t> stringOffsets(strings.size() + 1, 0);
+	for(size_t i = 0; i < order.size(); i++) {
+		newIDs[order[i]] = i;
+		stringOffsets[i + 1] = stringOffsets[i] + strings[order[i]].size();
+	}
+	
+	//Lay out the columns
+	SnapshotHeader header;
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.version = SNAPSHOT_VERSION;
+	header.byteOrder = SNAPSHOT_BYTE_ORDER;
+	header.rows = size();
+	header.strings = strings.size();
+	header.stringBytes = stringOffsets.back();
+	const uint64_t columnSizes[COLUMNS] = {
+		stringOffsets.size() * sizeof(uint64_t), header.stringBytes,
+		header.rows * sizeof(uint32_t), header.rows * sizeof(uint32_t), header.rows * sizeof(uint32_t),
+		header.rows * sizeof(uint32_t), header.rows * sizeof(uint32_t), header.rows * sizeof(uint32_t),
+		header.rows * sizeof(uint64_t), header.rows * sizeof(uint64_t), header.rows * sizeof(uint32_t),
+		header.rows * sizeof(uint16_t), header.rows * sizeof(uint16_t), header.rows * sizeof(uint16_t),
+		header.rows * sizeof(uint16_t), header.rows * sizeof(uint16_t), header.rows * sizeof(uint8_t)
+	};
+	uint64_t offset = align(sizeof(SnapshotHeader));
+	for(size_t i = 0; i < COLUMNS; i++) {
+		header.columnOffsets[i] = offset;
+		offset = align(offset + columnSizes[i]);
+	}
+	
+	const std::string tempFile = snapshotLoc + ".tmp";
+	const int fd = ::open(tempFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(fd < 0)
+		throw WriteException("Cannot write the snapshot \"" + snapshotLoc + "\", unable to create \"" + tempFile + "\".");
+	
+	bool success = writeAll(fd, &header, sizeof(SnapshotHeader), 0) && ftruncate(fd, offset) == 0 &&
+	               writeAll(fd, stringOffsets.data(), columnSizes[STRING_OFFSETS], header.columnOffsets[STRING_OFFSETS]);
+	
+	//Write the dictionary in large chunks
+	ByteArray output;
+	ulong written = header.columnOffsets[STRING_BYTES];
+	for(size_t i = 0; success && i < order.size(); i++) {
+		const std::string& text = strings[order[i]];
+		output.insert(output.end(), text.begin(), text.end());
+		if(output.size() >= 1024 * 1024 || i + 1 == order.size()) {
+			success = writeAll(fd, output.data(), output.size(), written);
+			written += output.size();
+			output.clear();
+		}
+	}
+	
+	for(size_t i = 0; success && i < static_cast<size_t>(SnapshotText::GENRE) + 1; i++) {
+		std::vector<uint32_t> ids(textColumns[i].size());
+		for(size_t row = 0; row < ids.size(); row++)
+			ids[row] = newIDs[textColumns[i][row]];
+		success = writeAll(fd, ids.data(), columnSizes[TEXT_COLUMNS + i], header.columnOffsets[TEXT_COLUMNS + i]);
+	}
+	
+	success = success &&
+	          writeAll(fd, playCounts.data(),    columnSizes[PLAY_COUNT],   header.columnOffsets[PLAY_COUNT]) &&
+	          writeAll(fd, pictureHashes.data(), columnSizes[PICTURE_HASH], header.columnOffsets[PICTURE_HASH]) &&
+	          writeAll(fd, durations.data(),     columnSizes[DURATION],     header.columnOffsets[DURATION]) &&
+	          writeAll(fd, years.data(),         columnSizes[YEAR],         header.columnOffsets[YEAR]) &&
+	          writeAll(fd, tracks.data(),        columnSizes[TRACK],        header.columnOffsets[TRACK]) &&
+	          writeAll(fd, trackTotals.data(),   columnSizes[TRACK_TOTAL],  header.columnOffsets[TRACK_TOTAL]) &&
+	          writeAll(fd, discs.data(),         columnSizes[DISC],         header.columnOffsets[DISC]) &&
+	          writeAll(fd, discTotals.data(),    columnSizes[DISC_TOTAL],   header.columnOffsets[DISC_TOTAL]) &&
+	          writeAll(fd, ratings.data(),       columnSizes[RATING],       header.columnOffsets[RATING]) &&
+	          fsync(fd) == 0;
+	::close(fd);
+	
+	if(!success || rename(tempFile.c_str(), snapshotLoc.c_str()) != 0) {
+		unlink(tempFile.c_str());
+		throw WriteException("Cannot write the snapshot \"" + snapshotLoc + "\", error writing \"" + tempFile + "\".");
+	}
+	
+	//Sync the directory so the rename survives a crash. If it doesn't, the
+	//old snapshot, or no snapshot, is back after the crash.
+	std::string directory = snapshotLoc;
+	const int dirFD = ::open(dirname(&directory[0]), O_RDONLY | O_DIRECTORY);
+	if(dirFD >= 0) {
+		fsync(dirFD);
+		::close(dirFD);
+	}
+}
+
+///@pkg ID3Snapshot.h
+size_t SnapshotWriter::size() const { return ratings.size(); }
+
+///@pkg ID3Snapshot.h
+uint32_t SnapshotWriter::intern(const std::string& text) {
+	const auto inserted = stringIndexes.emplace(text, strings.size());
+	if(inserted.second)
+		strings.push_back(text);
+	return inserted.first->second;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// Snapshot /////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+///@pkg ID3Snapshot.h
+Snapshot::Snapshot(const std::string& snapshotLoc) : snapshotFile(snapshotLoc),
+                                                     mapping(nullptr),
+                                                     mappedSize(0),
+                                                     rows(0),
+                                                     strings(0),
+                                                     columnOffsets(COLUMNS, 0) {
+	const int fd = ::open(snapshotLoc.c_str(), O_RDONLY | O_CLOEXEC);
+	if(fd < 0)
+		throw FileNotFoundException("Cannot open the snapshot \"" + snapshotLoc + "\".");
+	
+	struct stat fileInfo;
+	void* address = MAP_FAILED;
+	if(fstat(fd, &fileInfo) == 0 && static_cast<ulong>(fileInfo.st_size) >= sizeof(SnapshotHeader))
+		address = mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if(address == MAP_FAILED)
+		throw FileFormatException("\"" + snapshotLoc + "\" is not a snapshot.");
+	mapping = static_cast<const uint8_t*>(address);
+	mappedSize = fileInfo.st_size;
+	
+	//Check that every column fits in the file
+	SnapshotHeader header;
+	memcpy(&header, mapping, sizeof(SnapshotHeader));
+	bool valid = memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) == 0 &&
+	             header.version == SNAPSHOT_VERSION &&
+	             header.byteOrder == SNAPSHOT_BYTE_ORDER &&
+	             header.rows <= mappedSize && header.strings < mappedSize && header.stringBytes <= mappedSize;
+	const uint64_t rowSizes[COLUMNS] = {0, 0, 4, 4, 4, 4, 4, 4, 8, 8, 4, 2, 2, 2, 2, 2, 1};
+	for(size_t i = 0; valid && i < COLUMNS; i++) {
+		const uint64_t columnSize = i == STRING_OFFSETS ? (header.strings + 1) * sizeof(uint64_t) :
+		                            i == STRING_BYTES   ? header.stringBytes :
+		                                                  header.rows * rowSizes[i];
+		valid = header.columnOffsets[i] % 8 == 0 && header.columnOffsets[i] <= mappedSize &&
+		        columnSize <= mappedSize - header.columnOffsets[i];
+		columnOffsets[i] = header.columnOffsets[i];
+	}
+	if(valid) {
+		rows = header.rows;
+		strings = header.strings;
+		valid = column<uint64_t>(STRING_OFFSETS)[strings] == header.stringBytes;
+	}
+	if(!valid) {
+		munmap(const_cast<uint8_t*>(mapping), mappedSize);
+		throw FileFormatException("\"" + snapshotLoc + "\" is not a valid snapshot.");
+	}
+}
+
+///@pkg ID3Snapshot.h
+Snapshot::~Snapshot() {
+	munmap(const_cast<uint8_t*>(mapping), mappedSize);
+}
+
+///@pkg ID3Snapshot.h
+size_t Snapshot::size() const { return rows; }
+
+///@pkg ID3Snapshot.h
+size_t Snapshot::stringCount() const { return strings; }
+
+///@pkg ID3Snapshot.h
+uint32_t Snapshot::textID(const SnapshotText field, const size_t row) const {
+	return column<uint32_t>(TEXT_COLUMNS + static_cast<size_t>(field))[row];
+}
+
+///@pkg ID3Snapshot.h
+StringView Snapshot::string(const uint32_t id) const {
+	if(id >= strings)
+		return StringView();
+	
+	//Keep damaged offsets inside the dictionary
+	const uint64_t* const offsets = column<uint64_t>(STRING_OFFSETS);
+	const uint64_t end = offsets[strings];
+	const uint64_t start = std::min(offsets[id], end);
+	const char* const bytes = reinterpret_cast<const char*>(column<uint8_t>(STRING_BYTES));
+	return StringView(bytes + start, std::max(start, std::min(offsets[id + 1], end)) - start);
+}
+
+///@pkg ID3Snapshot.h
+ushort Snapshot::year(const size_t row) const { return column<uint16_t>(YEAR)[row]; }
+
+///@pkg ID3Snapshot.h
+ushort Snapshot::track(const size_t row) const { return column<uint16_t>(TRACK)[row]; }
+
+///@pkg ID3Snapshot.h
+ushort Snapshot::trackTotal(const size_t row) const { return column<uint16_t>(TRACK_TOTAL)[row]; }
+
+///@pkg ID3Snapshot.h
+ushort Snapshot::disc(const size_t row) const { return column<uint16_t>(DISC)[row]; }
+
+///@pkg ID3Snapshot.h
+ushort Snapshot::discTotal(const size_t row) const { return column<uint16_t>(DISC_TOTAL)[row]; }
+
+///@pkg ID3Snapshot.h
+ulong Snapshot::duration(const size_t row) const { return column<uint32_t>(DURATION)[row]; }
+
+///@pkg ID3Snapshot.h
+unsigned long long Snapshot::playCount(const size_t row) const { return column<uint64_t>(PLAY_COUNT)[row]; }
+
+///@pkg ID3Snapshot.h
+ushort Snapshot::rating(const size_t row) const { return column<uint8_t>(RATING)[row]; }
+
+///@pkg ID3Snapshot.h
+uint64_t Snapshot::pictureHash(const size_t row) const { return column<uint64_t>(PICTURE_HASH)[row]; }
@@ -0,0 +1,292 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_SNAPSHOT_HPP
+#define ID3_SNAPSHOT_HPP
+
+#include <string>        //For std::string
+#include <vector>        //For std::vector
+#include <unordered_map> //For std::unordered_map
+#include <cstdint>       //For uint8_t, uint16_t, uint32_t, and uint64_t
+
+#include "ID3.hpp"           //For Tag
+#include "ID3StringView.hpp" //For StringView
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * The string fields of a library snapshot.
+	 * 
+	 * @see ID3::Snapshot
+	 */
+	enum class SnapshotText : uint8_t {
+		PATH,
+		TITLE,
+		ARTIST,
+		ALBUM,
+		ALBUM_ARTIST,
+		GENRE
+	};
+	
+	/**
+	 * SnapshotWriter collects the common fields of many tags and writes them
+	 * to a library snapshot file, which is read with ID3::Snapshot.
+	 * 
+	 * The snapshot is columnar: every field is stored as an array with one
+	 * value per file. The strings of all the text fields are stored once each
+	 * in a sorted dictionary, and the text columns hold indexes into it.
+	 * 
+	 * NOTE: Only the fields are kept for each added Tag, not the Tag itself.
+	 * 
+	 * @see ID3::Snapshot
+	 */
+	class SnapshotWriter {
+		public:
+			/**
+			 * Add a tag's fields to the snapshot, with the Tag's file name as the
+			 * path.
+			 * 
+			 * @param tag The Tag.
+			 * @see ID3::Tag::fileName()
+			 */
+			void add(const Tag& tag);
+			
+			/**
+			 * Add a tag's fields to the snapshot.
+			 * 
+			 * @param fileLoc The path to store for the file.
+			 * @param tag     The Tag.
+			 */
+			void add(const std::string& fileLoc, const Tag& tag);
+			
+			/**
+			 * Write the snapshot file. The file is written next to the destination
+			 * and renamed over it, so readers never see a half-written snapshot,
+			 * and its directory is synced so that the rename survives a crash.
+			 * 
+			 * @param snapshotLoc The location of the snapshot file.
+			 * @throws ID3::WriteException if the file can't be written.
+			 */
+			void write(const std::string& snapshotLoc) const;
+			
+			/**
+			 * @return The number of tags added.
+			 */
+			size_t size() const;
+		
+		private:
+			/**
+			 * The number of text fields.
+			 */
+			static const size_t TEXT_FIELDS = static_cast<size_t>(SnapshotText::GENRE) + 1;
+			
+			/**
+			 * Get the dictionary index of a string, adding it if it's new.
+			 * 
+			 * @param text The string.
+			 * @return Its index in the order strings were added.
+			 */
+			uint32_t intern(const std::string& text);
+			
+			/**
+			 * The strings in the order they were added.
+			 */
+			std::vector<std::string> strings;
+			
+			/**
+			 * The index of each string in strings.
+			 */
+			std::unordered_map<std::string, uint32_t> stringIndexes;
+			
+			/**
+			 * The text columns, as indexes into strings.
+			 */
+			std::vector<uint32_t> textColumns[TEXT_FIELDS];
+			
+			/**
+			 * The numeric columns.
+			 */
+			std::vector<uint64_t> playCounts;
+			std::vector<uint64_t> pictureHashes;
+			std::vector<uint32_t> durations;
+			std::vector<uint16_t> years;
+			std::vector<uint16_t> tracks;
+			std::vector<uint16_t> trackTotals;
+			std::vector<uint16_t> discs;
+			std::vector<uint16_t> discTotals;
+			std::vector<uint8_t>  ratings;
+	};
+	
+	/**
+	 * Snapshot reads a library snapshot file written by ID3::SnapshotWriter.
+	 * The file is memory-mapped and nothing is copied out of it when it's
+	 * opened, so opening a snapshot is fast no matter how many files it holds,
+	 * and its pages are shared with other processes that map it.
+	 * 
+	 * Each file in the snapshot is a row, numbered from 0 to size() - 1 in the
+	 * order they were added. Strings are returned as views into the mapping,
+	 * which are valid as long as the Snapshot is.
+	 * 
+	 * Every string is given an ID, which is its index in the snapshot's sorted
+	 * dictionary. Comparing the IDs of two strings compares the strings, so
+	 * rows can be sorted by a text field without looking at the strings.
+	 * 
+	 * NOTE: The snapshot file is stored in the byte order of the machine, and
+	 *       should only be read on a machine with the same byte order. A row
+	 *       number past the end of the snapshot is undefined behaviour.
+	 * 
+	 * @see ID3::SnapshotWriter
+	 */
+	class Snapshot {
+		public:
+			/**
+			 * Open and map a snapshot file.
+			 * 
+			 * @param snapshotLoc The location of the snapshot file.
+			 * @throws ID3::FileNotFoundException if the file can't be opened.
+			 * @throws ID3::FileFormatException if the file isn't a valid snapshot.
+			 */
+			explicit Snapshot(const std::string& snapshotLoc);
+			
+			/**
+			 * The destructor, which unmaps the file.
+			 */
+			~Snapshot();
+			
+			Snapshot(const Snapshot&) = delete;
+			Snapshot& operator=(const Snapshot&) = delete;
+			
+			/**
+			 * @return The number of rows.
+			 */
+			size_t size() const;
+			
+			/**
+			 * @return The number of distinct strings.
+			 */
+			size_t stringCount() const;
+			
+			/**
+			 * Get the ID of a text field of a row.
+			 * 
+			 * @param field The text field.
+			 * @param row   The row.
+			 * @return The string's ID.
+			 */
+			uint32_t textID(const SnapshotText field, const size_t row) const;
+			
+			/**
+			 * Get a string by its ID.
+			 * 
+			 * @param id The string ID, less than stringCount().
+			 * @return The string.
+			 */
+			StringView string(const uint32_t id) const;
+			
+			/**
+			 * Get a text field of a row.
+			 * 
+			 * @param field The text field.
+			 * @param row   The row.
+			 * @return The text, or an empty view if it isn't set.
+			 */
+			inline StringView text(const SnapshotText field, const size_t row) const { return string(textID(field, row)); }
+			
+			/** @return The file path of a row. */
+			inline StringView path(const size_t row) const { return text(SnapshotText::PATH, row); }
+			/** @return The title of a row. */
+			inline StringView title(const size_t row) const { return text(SnapshotText::TITLE, row); }
+			/** @return The artist of a row. */
+			inline StringView artist(const size_t row) const { return text(SnapshotText::ARTIST, row); }
+			/** @return The album of a row. */
+			inline StringView album(const size_t row) const { return text(SnapshotText::ALBUM, row); }
+			/** @return The album artist of a row. */
+			inline StringView albumArtist(const size_t row) const { return text(SnapshotText::ALBUM_ARTIST, row); }
+			/** @return The genre of a row. */
+			inline StringView genre(const size_t row) const { return text(SnapshotText::GENRE, row); }
+			
+			/** @return The year of a row, or 0 if it isn't set. */
+			ushort year(const size_t row) const;
+			/** @return The track number of a row, or 0 if it isn't set. */
+			ushort track(const size_t row) const;
+			/** @return The total tracks of a row, or 0 if it isn't set. */
+			ushort trackTotal(const size_t row) const;
+			/** @return The disc number of a row, or 0 if it isn't set. */
+			ushort disc(const size_t row) const;
+			/** @return The total discs of a row, or 0 if it isn't set. */
+			ushort discTotal(const size_t row) const;
+			/** @return The length of a row in milliseconds, or 0 if it isn't set. */
+			ulong duration(const size_t row) const;
+			/** @return The play count of a row. @see ID3::Tag::playCount() */
+			unsigned long long playCount(const size_t row) const;
+			/** @return The 0-5 rating of a row. @see ID3::Tag::rating() */
+			ushort rating(const size_t row) const;
+			
+			/**
+			 * Get the hash of a row's picture, so that rows with the same picture
+			 * can be found without reading it.
+			 * 
+			 * @return The ID3::Picture::hash() of the picture returned by
+			 *         ID3::Tag::picture(), or 0 if there is no picture.
+			 */
+			uint64_t pictureHash(const size_t row) const;
+		
+		private:
+			/**
+			 * Get a pointer to a column in the mapping.
+			 * 
+			 * @param column The column's number in the file header.
+			 * @return The start of the column.
+			 */
+			template<typename Number>
+			inline const Number* column(const size_t column) const {
+				return reinterpret_cast<const Number*>(mapping + columnOffsets[column]);
+			}
+			
+			/**
+			 * The location of the snapshot file, for error messages.
+			 */
+			std::string snapshotFile;
+			
+			/**
+			 * The memory-mapped snapshot file.
+			 */
+			const uint8_t* mapping;
+			
+			/**
+			 * The size of the mapping.
+			 */
+			size_t mappedSize;
+			
+			/**
+			 * The number of rows and distinct strings.
+			 */
+			size_t rows;
+			size_t strings;
+			
+			/**
+			 * The offset of every column in the mapping.
+			 */
+			std::vector<uint64_t> columnOffsets;
+	};
+}
+
+#endif
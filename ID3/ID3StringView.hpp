@@ -0,0 +1,396 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_STRING_VIEW_HPP
+#define ID3_STRING_VIEW_HPP
+
+#include <string>    //For std::string
+#include <cstring>   //For std::memchr() and std::memcmp()
+#include <ostream>   //For std::ostream
+#include <iterator>  //For std::forward_iterator_tag
+#if __cplusplus >= 201703L
+#include <string_view> //For std::string_view
+#endif
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// S T R I N G V I E W //////////////////////////
+	////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * StringView is a read-only, non-owning reference to a run of characters
+	 * in a string owned by someone else, usually a Frame. It is returned by the
+	 * "view" getters so that text can be read without copying it into a new
+	 * std::string. When compiling with C++17 or later it converts implicitly
+	 * to std::string_view.
+	 * 
+	 * NOTE: A StringView does not keep the string it refers to alive. A view
+	 *       returned from a Frame or Tag is invalidated when that frame's
+	 *       content is changed, when the frame is removed from the Tag, or when
+	 *       the Tag is destroyed.
+	 */
+	class StringView {
+		public:
+			typedef const char* const_iterator;
+			
+			/**
+			 * Create an empty view.
+			 */
+			constexpr StringView() noexcept : viewData(""), viewSize(0) {}
+			
+			/**
+			 * Create a view of a character range.
+			 * 
+			 * @param str    The first character.
+			 * @param length The number of characters.
+			 */
+			constexpr StringView(const char* str, size_t length) noexcept : viewData(str), viewSize(length) {}
+			
+			/**
+			 * Create a view of a whole std::string.
+			 * 
+			 * @param str The string to view.
+			 */
+			StringView(const std::string& str) noexcept : viewData(str.data()), viewSize(str.size()) {}
+			
+			/**
+			 * Get the viewed characters.
+			 * 
+			 * NOTE: The characters are not NUL-terminated.
+			 * 
+			 * @return A pointer to the first character.
+			 */
+			constexpr const char* data() const noexcept { return viewData; }
+			
+			/**
+			 * Get the length of the view.
+			 * 
+			 * @return The number of characters in the view.
+			 */
+			constexpr size_t size() const noexcept { return viewSize; }
+			
+			/**
+			 * Check if the view has no characters.
+			 * 
+			 * @return true if the view is empty, false otherwise.
+			 */
+			constexpr bool empty() const noexcept { return viewSize == 0; }
+			
+			/**
+			 * Get an iterator to the first character.
+			 * 
+			 * @return The iterator.
+			 */
+			constexpr const_iterator begin() const noexcept { return viewData; }
+			
+			/**
+			 * Get an iterator to one past the last character.
+			 * 
+			 * @return The iterator.
+			 */
+			constexpr const_iterator end() const noexcept { return viewData + viewSize; }
+			
+			/**
+			 * Get a character of the view.
+			 * 
+			 * NOTE: The position is not bounds checked.
+			 * 
+			 * @param pos The position of the character.
+			 * @return The character.
+			 */
+			constexpr char operator[](size_t pos) const noexcept { return viewData[pos]; }
+			
+			/**
+			 * Copy the viewed characters into a std::string.
+			 * 
+			 * @return The std::string copy.
+			 */
+			std::string str() const { return std::string(viewData, viewSize); }
+			
+			/**
+			 * @see ID3::StringView::str()
+			 */
+			explicit operator std::string() const { return str(); }
+			
+			#if __cplusplus >= 201703L
+			/**
+			 * Convert the view to the standard library view type.
+			 * 
+			 * @return A std::string_view of the same characters.
+			 */
+			constexpr operator std::string_view() const noexcept { return std::string_view(viewData, viewSize); }
+			#endif
+			
+			/**
+			 * Compare the viewed characters to those of another view.
+			 * 
+			 * @param other The other view.
+			 * @return true if the characters are the same, false otherwise.
+			 */
+			bool operator==(const StringView& other) const noexcept {
+				return viewSize == other.viewSize &&
+				       (viewSize == 0 || std::memcmp(viewData, other.viewData, viewSize) == 0);
+			}
+			
+			/**
+			 * @see ID3::StringView::operator==(const StringView&)
+			 */
+			bool operator!=(const StringView& other) const noexcept { return !(*this == other); }
+			
+			/**
+			 * Compare the viewed characters to a std::string.
+			 * 
+			 * @param other The string.
+			 * @return true if the characters are the same, false otherwise.
+			 */
+			bool operator==(const std::string& other) const noexcept { return *this == StringView(other); }
+			
+			/**
+			 * @see ID3::StringView::operator==(const std::string&)
+			 */
+			bool operator!=(const std::string& other) const noexcept { return !(*this == StringView(other)); }
+			
+			/**
+			 * Compare the viewed characters to a NUL-terminated string.
+			 * 
+			 * @param other The string.
+			 * @return true if the characters are the same, false otherwise.
+			 */
+			bool operator==(const char* other) const noexcept { return *this == StringView(other, std::strlen(other)); }
+			
+			/**
+			 * @see ID3::StringView::operator==(const char*)
+			 */
+			bool operator!=(const char* other) const noexcept { return !(*this == other); }
+		
+		private:
+			/**
+			 * The first viewed character.
+			 */
+			const char* viewData;
+			
+			/**
+			 * The number of viewed characters.
+			 */
+			size_t viewSize;
+	};
+	
+	/**
+	 * Write the viewed characters to an output stream.
+	 * 
+	 * @param out  The output stream.
+	 * @param view The view to write.
+	 * @return The output stream.
+	 */
+	inline std::ostream& operator<<(std::ostream& out, const StringView& view) {
+		return out.write(view.data(), view.size());
+	}
+	
+	////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////
+	/////////////////// S E P A R A T E D S T R I N G V I E W //////////////////
+	////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////////////////////////////////////////////////
+	
+	/**
+	 * SeparatedStringView is a range over the values in a multi-value text
+	 * string, such as the content of a TextFrame whose values are divided by
+	 * its separating character. Iterating it yields a StringView for each
+	 * value without allocating. Like ID3::TextFrame::contents(), empty values
+	 * are skipped, but unlike contents() an empty string yields no values
+	 * instead of a single empty one.
+	 * 
+	 * NOTE: The same lifetime rules as ID3::StringView apply.
+	 */
+	class SeparatedStringView {
+		public:
+			/**
+			 * A forward iterator over the separated values.
+			 */
+			class const_iterator {
+				public:
+					typedef std::forward_iterator_tag iterator_category;
+					typedef StringView                value_type;
+					typedef std::ptrdiff_t            difference_type;
+					typedef const StringView*         pointer;
+					typedef const StringView&         reference;
+					
+					/**
+					 * Create an iterator that isn't on any range.
+					 */
+					const_iterator() noexcept : rangeEnd(nullptr), separator('\0') {}
+					
+					/**
+					 * Get the value the iterator is on.
+					 * 
+					 * @return The value.
+					 */
+					reference operator*() const noexcept { return current; }
+					
+					/**
+					 * @see ID3::SeparatedStringView::const_iterator::operator*()
+					 */
+					pointer operator->() const noexcept { return &current; }
+					
+					/**
+					 * Move to the next non-empty value.
+					 * 
+					 * @return The iterator.
+					 */
+					const_iterator& operator++() noexcept {
+						find(current.end() == rangeEnd ? rangeEnd : current.end() + 1);
+						return *this;
+					}
+					
+					/**
+					 * Move to the next non-empty value.
+					 * 
+					 * @return A copy of the iterator from before it was moved.
+					 */
+					const_iterator operator++(int) noexcept { const_iterator old = *this; ++*this; return old; }
+					
+					/**
+					 * Check if two iterators are on the same value.
+					 * 
+					 * @param other The other iterator.
+					 * @return true if they are, false otherwise.
+					 */
+					bool operator==(const const_iterator& other) const noexcept { return current.data() == other.current.data(); }
+					
+					/**
+					 * @see ID3::SeparatedStringView::const_iterator::operator==(const const_iterator&)
+					 */
+					bool operator!=(const const_iterator& other) const noexcept { return !(*this == other); }
+				
+				private:
+					friend class SeparatedStringView;
+					
+					/**
+					 * Create an iterator positioned on the first non-empty value at or
+					 * after the given position.
+					 * 
+					 * @param pos The position to start looking from.
+					 * @param end One past the last character of the range.
+					 * @param sep The character that divides values.
+					 */
+					const_iterator(const char* pos, const char* end, char sep) noexcept : rangeEnd(end), separator(sep) { find(pos); }
+					
+					/**
+					 * Move to the first non-empty value at or after the given position,
+					 * or to the end of the range if there is none.
+					 * 
+					 * @param pos The position to start looking from.
+					 */
+					void find(const char* pos) noexcept {
+						while(pos != rangeEnd && *pos == separator) ++pos;
+						const void* next = std::memchr(pos, separator, rangeEnd - pos);
+						current = StringView(pos, next == nullptr ? rangeEnd - pos :
+						                                            static_cast<const char*>(next) - pos);
+					}
+					
+					/**
+					 * The value the iterator is on.
+					 */
+					StringView current;
+					
+					/**
+					 * One past the last character of the range.
+					 */
+					const char* rangeEnd;
+					
+					/**
+					 * The character that divides values.
+					 */
+					char separator;
+			};
+			
+			/**
+			 * Create an empty range.
+			 */
+			SeparatedStringView() noexcept : separator('\0') {}
+			
+			/**
+			 * Create a range over the values of a string.
+			 * 
+			 * @param str The full string.
+			 * @param sep The character that divides values.
+			 */
+			SeparatedStringView(StringView str, char sep) noexcept : whole(str), separator(sep) {}
+			
+			/**
+			 * Get an iterator to the first non-empty value.
+			 * 
+			 * @return The iterator.
+			 */
+			const_iterator begin() const noexcept { return const_iterator(whole.begin(), whole.end(), separator); }
+			
+			/**
+			 * Get an iterator to the end of the range.
+			 * 
+			 * @return The iterator.
+			 */
+			const_iterator end() const noexcept { return const_iterator(whole.end(), whole.end(), separator); }
+			
+			/**
+			 * Check if the range has no values.
+			 * 
+			 * @return true if there are no non-empty values, false otherwise.
+			 */
+			bool empty() const noexcept { return begin() == end(); }
+			
+			/**
+			 * Get the first value.
+			 * 
+			 * @return The first value, or an empty view if there are none.
+			 */
+			StringView front() const noexcept { return *begin(); }
+			
+			/**
+			 * Get the whole string the range is over.
+			 * 
+			 * @return The full string, separators included.
+			 */
+			StringView str() const noexcept { return whole; }
+			
+			/**
+			 * Get the separating character.
+			 * 
+			 * @return The character that divides values.
+			 */
+			char delimiter() const noexcept { return separator; }
+		
+		private:
+			/**
+			 * The full string.
+			 */
+			StringView whole;
+			
+			/**
+			 * The character that divides values.
+			 */
+			char separator;
+	};
+}
+
+#endif
@@ -11,9 +11,21 @@
  **********************************************************************/
 
 #include <iostream>  //For std::string
-#include <cstring>   //For memcmp()
-#include <regex>     //For regular expressions
+#include <cstring>   //For memcmp() and strlen()
+#include <strings.h> //For strncasecmp()
 #include <time.h>    //For strftime()
+#include <utility>   //For std::move
+#include <memory>    //For std::unique_ptr
+#include <streambuf> //For std::streambuf
+#include <algorithm> //For std::min, std::max, and std::sort
+#include <cerrno>    //For errno
+#include <fcntl.h>   //For open(), fcntl(), posix_fadvise(), and O_DIRECT
+#include <unistd.h>  //For pread() and close()
+#include <sys/stat.h> //For fstat()
+#include <sys/mman.h> //For mmap() and mincore()
+#include <thread>    //For std::thread
+#include <atomic>    //For std::atomic
+#include <functional> //For std::function
 
 #include "ID3.hpp"                      //For the Tag class definition
 #include "ID3Functions.hpp"             //For assorted functions
@@ -23,55 +35,142 @@
 #include "Frames/ID3PlayCountFrame.hpp" //For PlayCountFrame
 #include "ID3Constants.hpp"             //For constants such as HEADER_BYTE_SIZE
 #include "ID3Exception.hpp"             //For exceptions
+#include "ID3TagCache.hpp"              //For TagCache
 
 using namespace ID3;
 
 //Private namespace
 namespace {
 	/**
-	 * Process a genre tag string.
+	 * Check if a file location ends in an MP3, MP4, or WAV file extension,
+	 * ignoring case.
 	 * 
-	 * @see ID3::Tag::genre(bool)
+	 * @param fileLoc The file location.
+	 * @return true if the extension is allowed, false otherwise.
 	 */
-	static std::string processGenre(const std::string& genre) {
-		if(genre.empty()) return "";
-		std::string genreString;
+	static bool allowedFileExtension(const std::string& fileLoc) {
+		static const char* const EXTENSIONS[] = { "mp3", "tag", "mp4", "m4a", "m4p", "m4b", "m4r", "m4v", "wav", "wave" };
 		
-		if(numericalString(genre)) {
-			genreString = V1::getGenreString(atoi(genre.c_str()));
-		} else {
-			//This regex matches any digit surrounded by a single pair of
-			//parenthesis at the start of a string
-			std::regex findV1Genre("^\\(\\d+\\)");
-			std::smatch v1Genre;
-			
-			//If a ID3v1 genre is found
-			if(std::regex_search(genre, v1Genre, findV1Genre)) {
-				//Get the match
-				std::string genreIntStr = v1Genre.str();
-				//Get the int value of the ID3v1 genre
-				int genreInt = atoi(genreIntStr.substr(1, genreIntStr.length() - 1).c_str());
-				//Remove the string from the tag string
-				genreString = std::regex_replace(genre, findV1Genre, "");
-				//If there's nothing else in the tag string, then return
-				//the ID3v1 genre
-				if(genreString.empty()) genreString = V1::getGenreString(genreInt);
-			} else { genreString = genre; }
+		const std::string::size_type dot = fileLoc.rfind('.');
+		if(dot == std::string::npos) return false;
+		const std::string::size_type LENGTH = fileLoc.size() - dot - 1;
+		
+		for(const char* const extension : EXTENSIONS) {
+			if(std::strlen(extension) == LENGTH && strncasecmp(fileLoc.c_str() + dot + 1, extension, LENGTH) == 0)
+				return true;
 		}
+		return false;
+	}
+	
+	/**
+	 * Check if a file starts with an ID3v2 tag, an MPEG audio frame sync
+	 * word, a RIFF WAVE header, or an MP4 file type box. The read position is
+	 * restored afterwards.
+	 * 
+	 * @param file The file to check.
+	 * @return true if the file looks like an MP3, MP4, or WAV file, false
+	 *         otherwise.
+	 */
+	static bool allowedFileContent(std::istream& file) {
+		uint8_t start[12] = {0};
+		const std::streampos readPos = file.tellg();
+		file.seekg(0, std::ifstream::beg);
+		file.read(reinterpret_cast<char*>(start), sizeof(start));
+		const std::streamsize READ = file.gcount();
+		file.clear();
+		file.seekg(readPos);
 		
-		return genreString;
+		return (READ >= 3 && std::memcmp(start, "ID3", 3) == 0) ||
+		       (READ >= 2 && start[0] == 0xFF && (start[1] & 0xE0) == 0xE0) ||
+		       (READ >= 12 && std::memcmp(start, "RIFF", 4) == 0 && std::memcmp(start + 8, "WAVE", 4) == 0) ||
+		       (READ >= 8 && std::memcmp(start + 4, "ftyp", 4) == 0);
 	}
 	
 	/**
-	 * Check if a file is a valid MP3 or MP4 file.
+	 * Throw the exception matching an ErrorCode from reading a file.
 	 * 
+	 * @param error   The ErrorCode.
 	 * @param fileLoc The file location.
-	 * @throws NotMP3FileException if the file location is not valid.
+	 * @throws NotMP3FileException if the file is not an MP3, MP4, or WAV file.
+	 * @throws FileNotFoundException if the file cannot be opened.
+	 * @throws FileFormatException if the tags on file are too big.
+	 */
+	static void throwFileError(const ErrorCode error, const std::string& fileLoc) {
+		switch(error) {
+			case ErrorCode::NONE:
+				return;
+			case ErrorCode::NOT_MP3_FILE:
+				throw NotMP3FileException("File \"" + fileLoc + "\" is not an MP3 or MP4 file!\n");
+			case ErrorCode::FILE_NOT_FOUND:
+				throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+			case ErrorCode::FILE_FORMAT:
+				throw FileFormatException("Tag size format error on file \"" + fileLoc + "\" when reading tags: tags are bigger than the file size!");
+			default:
+				throw Exception(errorString(error));
+		}
+	}
+	
+	/**
+	 * Get the ErrorCode of an exception thrown while reading or writing.
+	 * Must be called from a catch block.
 	 */
-	static void validateFileLocation(const std::string& fileLoc) {
-		//Check if the file is an MP3 file
-		if(!std::regex_search(fileLoc, std::regex("\\.(?:mp3|tag|mp4|m4a|m4p|m4b|m4r|m4v|wav|wave)$", std::regex::icase|std::regex::ECMAScript)))
-			throw NotMP3FileException("File \"" + fileLoc + "\" is not an MP3 or MP4 file!\n");
+	static ErrorCode currentErrorCode() noexcept {
+		try { throw; }
+		catch(const FileNotFoundException&) { return ErrorCode::FILE_NOT_FOUND; }
+		catch(const NotMP3FileException&)   { return ErrorCode::NOT_MP3_FILE; }
+		catch(const FileFormatException&)   { return ErrorCode::FILE_FORMAT; }
+		catch(const TagSizeException&)      { return ErrorCode::TAG_SIZE; }
+		catch(const FrameSizeException&)    { return ErrorCode::FRAME_SIZE; }
+		catch(const WriteException&)        { return ErrorCode::WRITE; }
+		catch(...)                          { return ErrorCode::OTHER; }
+	}
+	
+	/**
+	 * Read part of a file in large chunks, checking that the file hasn't
+	 * changed size since its tags were read.
+	 * 
+	 * @param fileLoc  The file location.
+	 * @param fileSize The size of the file when its tags were read.
+	 * @param start    The position to start reading from.
+	 * @param end      The position to stop reading at.
+	 * @param consume  The function given each chunk that's read.
+	 * @throws ID3::FileNotFoundException if the file can't be opened or read.
+	 * @throws ID3::FileFormatException if the file's size has changed.
+	 */
+	static void readFileRange(const std::string&                                  fileLoc,
+	                          const ulong                                         fileSize,
+	                          const ulong                                         start,
+	                          const ulong                                         end,
+	                          const std::function<void(const uint8_t*, size_t)>& consume) {
+		const int fd = ::open(fileLoc.c_str(), O_RDONLY | O_CLOEXEC);
+		if(fd < 0) throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+		
+		//The tag positions are only right if the file hasn't changed size
+		struct stat info;
+		if(fstat(fd, &info) != 0 || static_cast<ulong>(info.st_size) != fileSize || end < start || end > fileSize) {
+			::close(fd);
+			throw FileFormatException("File \"" + fileLoc + "\" has changed since its tags were read.");
+		}
+		posix_fadvise(fd, start, end - start, POSIX_FADV_SEQUENTIAL);
+		
+		const ulong CHUNK_SIZE = 1024 * 1024;
+		ByteArray chunk(std::min(CHUNK_SIZE, end - start));
+		for(ulong pos = start; pos < end;) {
+			const ssize_t READ = pread(fd, chunk.data(), std::min(CHUNK_SIZE, end - pos), pos);
+			if(READ < 0 && errno == EINTR) continue;
+			if(READ <= 0) {
+				::close(fd);
+				throw FileNotFoundException("File \"" + fileLoc + "\" cannot be read!\n");
+			}
+			try {
+				consume(chunk.data(), READ);
+			} catch(...) {
+				::close(fd);
+				throw;
+			}
+			pos += READ;
+		}
+		::close(fd);
 	}
 	
 	/**
@@ -84,35 +183,507 @@ namespace {
 		try {
 			time_t rawtime;
 			time(&rawtime);
-			struct tm* utctime = gmtime(&rawtime);
+			//gmtime_r() instead of gmtime() so that tags can be written on
+			//several threads at once
+			struct tm utctime;
+			gmtime_r(&rawtime, &utctime);
 			char buffer [20];
-			strftime(buffer, 20, "%Y-%m-%dT%H:%M:%S", utctime);
+			strftime(buffer, 20, "%Y-%m-%dT%H:%M:%S", &utctime);
 			return std::string(buffer, 20);
 		} catch(...) {
 			return "";
 		}
 	}
+	
+	/**
+	 * How many bytes are read from the start of a file when looking for ID3v2
+	 * tags. It is big enough to usually hold the whole tag, so that the tag
+	 * can be read with a single read from the file.
+	 */
+	const ulong HEAD_READ_SIZE = 64 * 1024;
+	
+	/**
+	 * Read bytes from the start of a file, with a single read.
+	 * 
+	 * @param file  The file to read from.
+	 * @param bytes Where to put the bytes. It is resized to how many bytes
+	 *              were read, which is fewer than asked for if the file is
+	 *              shorter. Bytes already in it are kept, and reading carries
+	 *              on from where they end.
+	 * @param size  How many bytes to have in total.
+	 * @return false if the file can't be read, true otherwise.
+	 */
+	static bool readHead(std::istream& file, ByteArray& bytes, const ulong size) {
+		const ulong START = bytes.size();
+		if(size <= START) return true;
+		
+		file.clear();
+		file.seekg(START, std::ifstream::beg);
+		if(!file) return false;
+		
+		bytes.resize(size);
+		file.read(reinterpret_cast<char*>(bytes.data() + START), size - START);
+		bytes.resize(START + file.gcount());
+		file.clear();
+		return true;
+	}
+	
+	/**
+	 * An ID3v2 tag read into memory, that frames can be read from as if it
+	 * were the file. For ID3v2.3 and below, whole-tag unsynchronisation
+	 * has to be undone on the bytes first, as the frame positions and sizes
+	 * are only valid after decoding.
+	 */
+	class TagStream : public std::istream {
+		public:
+			/**
+			 * Create a stream over the bytes of a tag, starting from its header.
+			 * 
+			 * @param bytes The tag bytes.
+			 */
+			explicit TagStream(ByteArray bytes) : std::istream(nullptr),
+			                                      tagBytes(std::move(bytes)),
+			                                      buffer(tagBytes) {
+				rdbuf(&buffer);
+			}
+			
+			/**
+			 * @return The size of the tag in memory.
+			 */
+			ulong size() const { return tagBytes.size(); }
+			
+		private:
+			/**
+			 * A read-only, seekable stream buffer over a ByteArray.
+			 */
+			class ByteArrayBuffer : public std::streambuf {
+				public:
+					explicit ByteArrayBuffer(ByteArray& bytes) {
+						char* const begin = reinterpret_cast<char*>(bytes.data());
+						setg(begin, begin, begin + bytes.size());
+					}
+					
+				protected:
+					pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+						char* const base = dir == std::ios_base::beg ? eback() :
+						                   dir == std::ios_base::cur ? gptr() : egptr();
+						if((which & std::ios_base::in) == 0 || off < eback() - base || off > egptr() - base)
+							return pos_type(off_type(-1));
+						setg(eback(), base + off, egptr());
+						return pos_type(gptr() - eback());
+					}
+					
+					pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+						return seekoff(off_type(pos), std::ios_base::beg, which);
+					}
+			};
+			
+			/**
+			 * The tag bytes.
+			 */
+			ByteArray tagBytes;
+			
+			/**
+			 * The stream buffer reading from tagBytes.
+			 */
+			ByteArrayBuffer buffer;
+	};
+	
+	/**
+	 * A file opened for ReadMode::SCAN. Readahead is turned off, since only
+	 * the start and end of the file are read, and the pages the reads brought
+	 * into the page cache are dropped from it when the file is closed. Pages
+	 * that were already cached, such as those of a song that is playing, are
+	 * left alone. With O_DIRECT, the reads bypass the page cache entirely,
+	 * using aligned blocks.
+	 */
+	class ScanFileStream : public std::istream {
+		public:
+			/**
+			 * Open a file. If it can't be opened, the stream's fail bit will be
+			 * set.
+			 * 
+			 * @param fileLoc The file location.
+			 * @param direct  Whether to read with O_DIRECT. If the file system
+			 *                doesn't support it, the file is read normally.
+			 */
+			ScanFileStream(const std::string& fileLoc, const bool direct) : std::istream(nullptr),
+			                                                                buffer(fileLoc, direct) {
+				rdbuf(&buffer);
+				if(!buffer.isOpen()) setstate(std::ios::failbit);
+			}
+			
+		private:
+			/**
+			 * A read-only, seekable stream buffer that reads a file descriptor in
+			 * aligned blocks with pread().
+			 */
+			class ScanFileBuffer : public std::streambuf {
+				public:
+					ScanFileBuffer(const std::string& fileLoc, const bool direct) : fd(-1),
+					                                                                directIO(false),
+					                                                                fileSize(0),
+					                                                                blockStart(0),
+					                                                                memory(BLOCK_SIZE + ALIGNMENT) {
+						#ifdef O_DIRECT
+						if(direct) fd = ::open(fileLoc.c_str(), O_RDONLY | O_DIRECT);
+						directIO = fd >= 0;
+						#endif
+						if(fd < 0) fd = ::open(fileLoc.c_str(), O_RDONLY);
+						if(fd < 0) return;
+						
+						struct stat info;
+						if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+							::close(fd);
+							fd = -1;
+							return;
+						}
+						fileSize = info.st_size;
+						posix_fadvise(fd, 0, 0, POSIX_FADV_RANDOM);
+						
+						//O_DIRECT reads need a block-aligned buffer
+						const uintptr_t ADDRESS = reinterpret_cast<uintptr_t>(memory.data());
+						block = reinterpret_cast<char*>(memory.data()) + (ALIGNMENT - ADDRESS % ALIGNMENT) % ALIGNMENT;
+						setg(block, block, block);
+					}
+					
+					~ScanFileBuffer() {
+						if(fd < 0) return;
+						for(const std::pair<ulong, ulong>& range : uncachedRanges)
+							posix_fadvise(fd, range.first, range.second, POSIX_FADV_DONTNEED);
+						::close(fd);
+					}
+					
+					bool isOpen() const { return fd >= 0; }
+					
+				protected:
+					int_type underflow() override {
+						if(gptr() == egptr() && !readBlock(blockStart + (egptr() - eback())))
+							return traits_type::eof();
+						return traits_type::to_int_type(*gptr());
+					}
+					
+					pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+						const off_type CURRENT = blockStart + (gptr() - eback());
+						const off_type POS = dir == std::ios_base::beg ? off :
+						                     dir == std::ios_base::cur ? CURRENT + off : fileSize + off;
+						if((which & std::ios_base::in) == 0 || POS < 0 || POS > static_cast<off_type>(fileSize))
+							return pos_type(off_type(-1));
+						
+						//Keep the block that was read if the position is in it
+						if(POS >= static_cast<off_type>(blockStart) && POS < static_cast<off_type>(blockStart) + (egptr() - eback())) {
+							setg(eback(), eback() + (POS - blockStart), egptr());
+						} else {
+							blockStart = POS;
+							setg(block, block, block);
+						}
+						return pos_type(POS);
+					}
+					
+					pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+						return seekoff(off_type(pos), std::ios_base::beg, which);
+					}
+					
+				private:
+					/**
+					 * Read the aligned block holding a position in the file.
+					 * 
+					 * @param pos The position in the file.
+					 * @return true if the block was read, false if at the end of the
+					 *         file or if the file can't be read.
+					 */
+					bool readBlock(const ulong pos) {
+						if(pos >= fileSize) return false;
+						const ulong ALIGNED_POS = pos - pos % ALIGNMENT;
+						
+						ssize_t bytesRead;
+						do {
+							if(!directIO) recordUncachedPages(ALIGNED_POS, BLOCK_SIZE);
+							bytesRead = pread(fd, block, BLOCK_SIZE, ALIGNED_POS);
+							#ifdef O_DIRECT
+							//Some file systems only refuse O_DIRECT once reading
+							if(bytesRead < 0 && errno == EINVAL && directIO) {
+								fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+								directIO = false;
+								errno = EINTR;
+							}
+							#endif
+						} while(bytesRead < 0 && errno == EINTR);
+						
+						if(bytesRead <= static_cast<ssize_t>(pos - ALIGNED_POS)) return false;
+						blockStart = ALIGNED_POS;
+						setg(block, block + (pos - ALIGNED_POS), block + bytesRead);
+						return true;
+					}
+					
+					/**
+					 * Save the pages of a range of the file that aren't in the page
+					 * cache before it's read, so that only the pages the stream
+					 * brought into the cache are dropped when it's closed. If the
+					 * pages can't be checked, they're left alone.
+					 * 
+					 * @param pos  The position in the file of the range.
+					 * @param size The size of the range.
+					 */
+					void recordUncachedPages(const ulong pos, const ulong size) {
+						const ulong PAGE_BYTES = sysconf(_SC_PAGESIZE);
+						const ulong START = pos - pos % PAGE_BYTES;
+						const ulong LENGTH = std::min(pos + size, fileSize) - START;
+						if(pos >= fileSize || LENGTH == 0) return;
+						
+						void* const MAPPING = mmap(nullptr, LENGTH, PROT_READ, MAP_SHARED, fd, START);
+						if(MAPPING == MAP_FAILED) return;
+						std::vector<unsigned char> resident((LENGTH + PAGE_BYTES - 1) / PAGE_BYTES);
+						if(mincore(MAPPING, LENGTH, resident.data()) == 0) {
+							for(size_t i = 0; i < resident.size(); i++) {
+								if(resident[i] & 1) continue;
+								//Join the page to the last range if it follows it
+								const ulong PAGE = START + i * PAGE_BYTES;
+								if(!uncachedRanges.empty() && uncachedRanges.back().first + uncachedRanges.back().second == PAGE)
+									uncachedRanges.back().second += PAGE_BYTES;
+								else
+									uncachedRanges.emplace_back(PAGE, PAGE_BYTES);
+							}
+						}
+						munmap(MAPPING, LENGTH);
+					}
+					
+					/**
+					 * The size of each read. It is the same as the speculative head
+					 * read, so that a tag that fits in it is read at once.
+					 */
+					static const ulong BLOCK_SIZE = 64 * 1024;
+					
+					/**
+					 * The alignment of reads and of the buffer needed by O_DIRECT.
+					 */
+					static const ulong ALIGNMENT = 4096;
+					
+					/**
+					 * The file descriptor, or -1 if the file isn't open.
+					 */
+					int fd;
+					
+					/**
+					 * Whether the file is read with O_DIRECT, which doesn't use the
+					 * page cache.
+					 */
+					bool directIO;
+					
+					/**
+					 * The position and size of each range of pages that was read into
+					 * the page cache by the stream.
+					 */
+					std::vector<std::pair<ulong, ulong>> uncachedRanges;
+					
+					/**
+					 * The size of the file.
+					 */
+					ulong fileSize;
+					
+					/**
+					 * The position in the file of the block that was read.
+					 */
+					ulong blockStart;
+					
+					/**
+					 * The memory the aligned block is in.
+					 */
+					ByteArray memory;
+					
+					/**
+					 * The aligned block in memory.
+					 */
+					char* block;
+			};
+			
+			/**
+			 * The stream buffer reading from the file.
+			 */
+			ScanFileBuffer buffer;
+	};
+}
+
+///@pkg ID3.h
+Tag::Tag(const std::string& fileLoc) : Tag(fileLoc, true, FileCheck::EXTENSION) {}
+
+///@pkg ID3.h
+Tag::Tag(const std::string& fileLoc, const FileCheck check) : Tag(fileLoc, true, check) {}
+
+///@pkg ID3.h
+Tag::Tag(const std::string& fileLoc,
+         const ReadLimits&  limits,
+         const FileCheck    check) : filename(fileLoc),
+                                     filesize(0),
+                                     compactFrames(false),
+                                     framesSkipped(false),
+                                     fileRewritten(false),
+                                     textEncodingPolicy(EncodingPolicy::UTF8),
+                                     fileCheck(check),
+                                     frameLimits(limits),
+                                     fileReadMode(ReadMode::NORMAL) {
+	throwFileError(load(fileLoc, true), fileLoc);
+}
+
+///@pkg ID3.h
+Tag::Tag(const std::string& fileLoc,
+         const ReadMode     mode,
+         const FileCheck    check) : filename(fileLoc),
+                                     filesize(0),
+                                     compactFrames(false),
+                                     framesSkipped(false),
+                                     fileRewritten(false),
+                                     textEncodingPolicy(EncodingPolicy::UTF8),
+                                     fileCheck(check),
+                                     fileReadMode(mode) {
+	throwFileError(load(fileLoc, true), fileLoc);
+}
+
+///@pkg ID3.h
+Tag::Tag(const std::string& fileLoc,
+         TagCache&          cache,
+         const FileCheck    check,
+         const ReadLimits&  limits,
+         const ReadMode     mode) : filename(fileLoc),
+                                    filesize(0),
+                                    compactFrames(false),
+                                    framesSkipped(false),
+                                    fileRewritten(false),
+                                    textEncodingPolicy(EncodingPolicy::UTF8),
+                                    fileCheck(check),
+                                    frameLimits(limits),
+                                    fileReadMode(mode) {
+	throwFileError(load(fileLoc, true, &cache), fileLoc);
+}
+
+///@pkg ID3.h
+Tag::Tag(const std::string& fileLoc,
+         const bool         readFrames,
+         const FileCheck    check) : filename(fileLoc),
+                                     filesize(0),
+                                     compactFrames(false),
+                                     framesSkipped(false),
+                                     fileRewritten(false),
+                                     textEncodingPolicy(EncodingPolicy::UTF8),
+                                     fileCheck(check),
+                                     fileReadMode(ReadMode::NORMAL) {
+	throwFileError(load(fileLoc, readFrames), fileLoc);
+}
+
+///@pkg ID3.h
+Tag::Tag() noexcept : filesize(0),
+                      compactFrames(false),
+                      framesSkipped(false),
+                      fileRewritten(false),
+                      textEncodingPolicy(EncodingPolicy::UTF8),
+                      fileCheck(FileCheck::EXTENSION),
+                      fileReadMode(ReadMode::NORMAL) {}
+
+///@pkg ID3.h
+ErrorCode Tag::open(const std::string& fileLoc,
+                    Tag&               tag,
+                    const FileCheck    check,
+                    const ReadLimits&  limits,
+                    const ReadMode     mode) noexcept {
+	try {
+		Tag fileTag;
+		fileTag.fileCheck = check;
+		fileTag.frameLimits = limits;
+		fileTag.fileReadMode = mode;
+		const ErrorCode error = fileTag.load(fileLoc, true);
+		if(error == ErrorCode::NONE) tag = std::move(fileTag);
+		return error;
+	} catch(...) {
+		return currentErrorCode();
+	}
+}
+
+///@pkg ID3.h
+ErrorCode Tag::probe(const std::string& fileLoc,
+                     Tag&               tag,
+                     const FileCheck    check,
+                     const ReadLimits&  limits,
+                     const ReadMode     mode) noexcept {
+	try {
+		Tag fileTag;
+		fileTag.fileCheck = check;
+		fileTag.frameLimits = limits;
+		fileTag.fileReadMode = mode;
+		const ErrorCode error = fileTag.load(fileLoc, false);
+		if(error == ErrorCode::NONE) tag = std::move(fileTag);
+		return error;
+	} catch(...) {
+		return currentErrorCode();
+	}
 }
 
 ///@pkg ID3.h
-Tag::Tag(const std::string& fileLoc) : Tag(fileLoc, true) {}
+ErrorCode Tag::open(const std::string& fileLoc,
+                    Tag&               tag,
+                    TagCache&          cache,
+                    const FileCheck    check,
+                    const ReadLimits&  limits,
+                    const ReadMode     mode) noexcept {
+	try {
+		Tag fileTag;
+		fileTag.fileCheck = check;
+		fileTag.frameLimits = limits;
+		fileTag.fileReadMode = mode;
+		const ErrorCode error = fileTag.load(fileLoc, true, &cache);
+		if(error == ErrorCode::NONE) tag = std::move(fileTag);
+		return error;
+	} catch(...) {
+		return currentErrorCode();
+	}
+}
 
 ///@pkg ID3.h
-Tag::Tag(const std::string& fileLoc, const bool readFrames) : filename(fileLoc), filesize(0) {
-	validateFileLocation(fileLoc); //Throws NotMP3FileException
+ErrorCode Tag::load(const std::string& fileLoc, const bool readFrames, TagCache* const cache) {
+	//Checking the file content has to wait until the file is open
+	const bool ALLOWED_EXTENSION = allowedFileExtension(fileLoc);
+	if(!ALLOWED_EXTENSION && fileCheck == FileCheck::EXTENSION)
+		return ErrorCode::NOT_MP3_FILE;
+	
+	//Read the tags from the cache, or from the bytes of the file that will be
+	//added to the cache
+	if(cache != nullptr) {
+		TagCache::Pending pending;
+		std::unique_ptr<std::istream> cachedFile = cache->stream(fileLoc, pending, frameLimits, fileReadMode);
+		if(cachedFile) {
+			if(!ALLOWED_EXTENSION && !allowedFileContent(*cachedFile))
+				return ErrorCode::NOT_MP3_FILE;
+			
+			filename = fileLoc;
+			const ErrorCode error = readFile(*cachedFile, readFrames);
+			//Frames past the part of the tag that the cache holds are missing
+			if(readFrames && TagCache::cutShort(*cachedFile)) framesSkipped = true;
+			//A cache that can't be written to is a miss, as the tags were read
+			if(error == ErrorCode::NONE && readFrames) {
+				try {
+					cache->insert(pending, *this);
+				} catch(const WriteException&) {}
+			}
+			return error;
+		}
+	}
 	
-	std::ifstream file(fileLoc, std::ios::in | std::ios::binary | std::ios::ate);
+	std::unique_ptr<std::istream> file = openFile(fileLoc, fileReadMode);
+	if(!*file)
+		return ErrorCode::FILE_NOT_FOUND;
 	
-	if(file.is_open()) {
-		readFile(file, readFrames);
-		file.close();
-	} else {
-		throw FileNotFoundException("File \"" + filename + "\" cannot be opened!\n");
-	}
+	if(!ALLOWED_EXTENSION && !allowedFileContent(*file))
+		return ErrorCode::NOT_MP3_FILE;
+	
+	filename = fileLoc;
+	return readFile(*file, readFrames);
 }
 
 ///@pkg ID3.h
-Tag::Tag() noexcept : filesize(0) {}
+std::unique_ptr<std::istream> Tag::openFile(const std::string& fileLoc, const ReadMode mode) {
+	if(mode == ReadMode::NORMAL)
+		return std::unique_ptr<std::istream>(new std::ifstream(fileLoc, std::ios::in | std::ios::binary | std::ios::ate));
+	return std::unique_ptr<std::istream>(new ScanFileStream(fileLoc, mode == ReadMode::SCAN_DIRECT));
+}
 
 ///@pkg ID3.h
 Tag::operator bool() const noexcept { return !frames.empty(); }
@@ -127,15 +698,95 @@ void Tag::write(const std::string& fileLoc,
                 const bool         discardNonCoverPictures,
                 const bool         discardUnknown,
                 const bool         addTaggingTime) {
-	if(!setFileNameUponSuccess) filename = fileLoc;
-	validateFileLocation(fileLoc); //Throws NotMP3FileException
+	throwFileError(writeFile(fileLoc,
+	                         paddingFactor,
+	                         setFileNameUponSuccess,
+	                         discardNonCoverPictures,
+	                         discardUnknown,
+	                         addTaggingTime), fileLoc);
+}
+
+///@pkg ID3.h
+ErrorCode Tag::tryWrite(const std::string& fileLoc,
+                        const float        paddingFactor,
+                        const bool         setFileNameUponSuccess,
+                        const bool         discardNonCoverPictures,
+                        const bool         discardUnknown,
+                        const bool         addTaggingTime) noexcept {
+	try {
+		return writeFile(fileLoc,
+		                 paddingFactor,
+		                 setFileNameUponSuccess,
+		                 discardNonCoverPictures,
+		                 discardUnknown,
+		                 addTaggingTime);
+	} catch(...) {
+		return currentErrorCode();
+	}
+}
+
+///@pkg ID3.h
+bool Tag::rewritten() const { return fileRewritten; }
+
+///@pkg ID3.h
+std::vector<ErrorCode> Tag::audioHashes(const std::vector<std::string>& fileLocs,
+                                        std::vector<uint64_t>&          hashes,
+                                        const unsigned                  threads,
+                                        const FileCheck                 check) {
+	std::vector<ErrorCode> errors(fileLocs.size(), ErrorCode::NONE);
+	hashes.assign(fileLocs.size(), 0);
 	
-	//A newly-constructed Tag of the file, to get the most up-to-date file information
-	const Tag fileInfo(fileLoc, false);
+	//Each thread takes the next file until there are none left
+	std::atomic<size_t> next(0);
+	const auto hashFiles = [&]() {
+		for(size_t i = next++; i < fileLocs.size(); i = next++) {
+			Tag tag;
+			errors[i] = probe(fileLocs[i], tag, check);
+			if(errors[i] != ErrorCode::NONE) continue;
+			try {
+				hashes[i] = tag.audioHash();
+			} catch(...) {
+				errors[i] = currentErrorCode();
+			}
+		}
+	};
+	
+	size_t threadCount = threads > 0 ? threads : std::thread::hardware_concurrency();
+	threadCount = std::max<size_t>(1, std::min(threadCount, fileLocs.size()));
+	std::vector<std::thread> workers;
+	for(size_t i = 1; i < threadCount; i++)
+		workers.emplace_back(hashFiles);
+	hashFiles();
+	for(std::thread& worker : workers)
+		worker.join();
+	return errors;
+}
+
+///@pkg ID3.h
+ErrorCode Tag::writeFile(const std::string& fileLoc,
+                         const float        paddingFactor,
+                         const bool         setFileNameUponSuccess,
+                         const bool         discardNonCoverPictures,
+                         const bool         discardUnknown,
+                         const bool         addTaggingTime) {
+	fileRewritten = false;
+	
+	//Writing the tags would delete the frames that were skipped when reading
+	if(framesSkipped)
+		throw WriteException("Cannot write tags to file \""+fileLoc+"\", as frames of \""+filename+"\" over the read limits were skipped and would be lost.");
+	
+	//A newly-read Tag of the file, to get the most up-to-date file
+	//information. It also checks the file.
+	Tag fileInfo;
+	fileInfo.fileCheck = fileCheck;
+	const ErrorCode error = fileInfo.load(fileLoc, false);
+	if(error != ErrorCode::NONE) return error;
+	
+	if(!setFileNameUponSuccess) filename = fileLoc;
 	
 	std::fstream file(fileLoc, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
 	if(!file.is_open())
-		throw FileNotFoundException("File \"" + fileLoc + "\" cannot be opened!\n");
+		return ErrorCode::FILE_NOT_FOUND;
 	
 	//The ID3v2 tag data to write to file
 	ByteArray binaryTagData(10, '\0');
@@ -179,10 +830,14 @@ void Tag::write(const std::string& fileLoc,
 		//Delete unknown frames if discardUnknown is true
 		if(discardUnknown && dynamic_cast<UnknownFrame*>(framePair.second.get()) != nullptr) continue;
 		
+		framePair.second->encodingPolicy = textEncodingPolicy;
 		ByteArray frameBytes = framePair.second->write();
 		//If the Frame data is valid add the it to the tag data
-		if(frameBytes.size() > HEADER_BYTE_SIZE)
+		if(frameBytes.size() > HEADER_BYTE_SIZE) {
+			//Save where the frame will be on file in case it's compacted
+			framePair.second->filePosition = binaryTagData.size();
 			binaryTagData.insert(binaryTagData.end(), frameBytes.begin(), frameBytes.end());
+		}
 	}
 	
 	//Whether the file needs to be completely rewritten
@@ -227,6 +882,10 @@ void Tag::write(const std::string& fileLoc,
 	v2TagInfo.size = binaryTagData.size() - HEADER_BYTE_SIZE;
 	v2TagInfo.totalSize = binaryTagData.size();
 	
+	//The size of the file once it's written
+	ulong newFileSize = fileInfo.filesize;
+	
+	fileRewritten = needToRewriteFile;
 	if(needToRewriteFile) {
 		//Rewrite the file to accomodate the bigger tags/removed ID3v1 tags.
 		            //The start of the audio data in the file
@@ -260,6 +919,7 @@ void Tag::write(const std::string& fileLoc,
 		//Write the audio
 		file.seekp(0, std::ios_base::end);
 		file.write(reinterpret_cast<char*>(&binaryAudioData.front()), binaryAudioData.size());
+		newFileSize = binaryTagData.size() + binaryAudioData.size();
 	} else {
 		//Overwrite the existing ID3v2 tags
 		//Seek to the beginning
@@ -269,6 +929,11 @@ void Tag::write(const std::string& fileLoc,
 		file.write(reinterpret_cast<char*>(&binaryTagData.front()), binaryTagData.size());
 	}
 	
+	//Check that every write reached the file, so that a failed write isn't
+	//reported as a success
+	file.flush();
+	if(!file) throw WriteException("Cannot write tags to file \""+fileLoc+"\", error writing to file.");
+	
 	//Now that the write has been successful, remove any null/empty frames
 	foundCoverPicture = false;
 	auto itr = frames.begin();
@@ -287,29 +952,93 @@ void Tag::write(const std::string& fileLoc,
 		} else if(discardUnknown && dynamic_cast<UnknownFrame*>(itr->second.get()) != nullptr) {
 			itr = frames.erase(itr); //Delete unknown frames if discardUnknown is true
 		}else {
+			//Drop the frame bytes that were just written if in compact mode
+			if(compactFrames) itr->second->compact();
 			itr++;
 		}
 	}
 	
 	//Close the file
 	file.close();
-	if(setFileNameUponSuccess) filename = fileLoc;
+	if(setFileNameUponSuccess) filename = fileLoc, filesize = newFileSize, tagsSet.v2 = true;
 	tagsSet.v1 = false, tagsSet.v1_1 = false, tagsSet.v1Extended = false;
+	return ErrorCode::NONE;
 }
 
 ///@pkg ID3.h
 void Tag::revert() {
+	//The file and FrameFactory to read edited compacted frames from, which are
+	//only opened if necessary
+	std::ifstream file;
+	std::unique_ptr<TagStream> decodedTag;
+	FrameFactory fileFactory;
+	
 	//Loop through every Frame and revert it
 	auto itr = frames.begin();
 	while(itr != frames.end()) {
 		if(itr->second.get() == nullptr) { itr = frames.erase(itr); continue; }
-		itr->second->revert();
+		if(itr->second->compacted() && itr->second->edited()) {
+			//The compacted frame has to be read from file again
+			if(!file.is_open()) {
+				file.open(filename, std::ios::in | std::ios::binary);
+				if(!file.is_open())
+					throw FileNotFoundException("File \"" + filename + "\" cannot be opened to revert the tags!\n");
+				//Frame positions in unsynchronised ID3v2.3 tags are in the decoded tag
+				if(v2TagInfo.flagUnsynchronisation && v2TagInfo.majorVer <= 3) {
+					ByteArray tagBytes;
+					if(!readHead(file, tagBytes, std::min(v2TagInfo.totalSize, frameLimits.totalSize)))
+						throw FileNotFoundException("File \"" + filename + "\" cannot be read to revert the tags!\n");
+					//The tag header is never unsynchronised
+					resynchronise(tagBytes, HEADER_BYTE_SIZE);
+					decodedTag.reset(new TagStream(std::move(tagBytes)));
+					fileFactory = FrameFactory(*decodedTag, v2TagInfo.majorVer, decodedTag->size(), frameLimits);
+				} else {
+					fileFactory = FrameFactory(file, v2TagInfo.majorVer, v2TagInfo.totalSize, frameLimits);
+				}
+			}
+			FramePtr fileFrame = fileFactory.create(itr->second->filePosition);
+			
+			//Make sure that the tags on file haven't been changed since the frame
+			//was read or written
+			if(fileFrame->frame() != itr->first || fileFrame->type() != itr->second->type())
+				throw FileFormatException("Cannot revert the tags of file \"" + filename + "\", as they have been changed on file!");
+			
+			fileFrame->compact();
+			itr->second = fileFrame;
+		} else {
+			itr->second->revert();
+		}
 		//If the Frame is null or empty then remove it
 		if(itr->second->null() || itr->second->empty()) itr = frames.erase(itr);
 		else                                            itr++;
 	}
 }
 
+///@pkg ID3.h
+void Tag::compact() {
+	compactFrames = true;
+	for(const auto& framePair : frames)
+		if(framePair.second.get() != nullptr) framePair.second->compact();
+}
+
+///@pkg ID3.h
+bool Tag::compacted() const { return compactFrames; }
+
+///@pkg ID3.h
+void Tag::encodingPolicy(const EncodingPolicy policy) { textEncodingPolicy = policy; }
+
+///@pkg ID3.h
+EncodingPolicy Tag::encodingPolicy() const { return textEncodingPolicy; }
+
+///@pkg ID3.h
+void Tag::readLimits(const ReadLimits& limits) { frameLimits = limits; }
+
+///@pkg ID3.h
+const ReadLimits& Tag::readLimits() const { return frameLimits; }
+
+///@pkg ID3.h
+bool Tag::partial() const { return framesSkipped; }
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////  S T A R T   F R A M E   G E T T E R S ////////////////////
@@ -328,6 +1057,18 @@ std::string Tag::textString(const FrameID& frameName) const {
 	return textFrameObj == nullptr ? "" : textFrameObj->content();
 }
 
+///@pkg ID3.h
+StringView Tag::textStringView(const FrameID& frameName) const {
+	TextFrame* textFrameObj = getFrame<TextFrame>(frameName); //Get the frame
+	return textFrameObj == nullptr ? StringView() : textFrameObj->contentView();
+}
+
+///@pkg ID3.h
+SeparatedStringView Tag::textStringsView(const FrameID& frameName) const {
+	TextFrame* textFrameObj = getFrame<TextFrame>(frameName); //Get the frame
+	return textFrameObj == nullptr ? SeparatedStringView() : textFrameObj->contentsView();
+}
+
 ///@pkg ID3.h
 std::vector<std::string> Tag::textStrings(const FrameID& frameName) const {
 	if(frameName.allowsMultiple()) {
@@ -426,32 +1167,32 @@ std::vector<ByteArray> Tag::binaryDatas(const FrameID& frameName) const {
 ////////////////////////////////////////////////////////////////////////////////
 
 ///@pkg ID3.h
-void Tag::text(const FrameID& frameID, const Text& text) {
+void Tag::text(const FrameID& frameID, Text text) {
 	//Get the text frame. If a UnknownFrame exists at the position, delete it.
 	TextFrame* textFrameObj = getFrame<TextFrame>(frameID, true);
 	
 	if(textFrameObj == nullptr) {
 		//If the Frame doesn't exist, create it
 		//If the FrameID shouldn't be a TextFrame, then this will be ignored.
-		addFrame(frameID, factory.create(frameID, text.text, text.description, text.language));
+		addFrame(frameID, factory.create(frameID, std::move(text.text), std::move(text.description), text.language));
 	} else {		
 		//See if it's a DescriptiveTextFrame
 		DescriptiveTextFrame* descFrameObj = getFrame<DescriptiveTextFrame>(frameID);
 		//Set the content
-		if(descFrameObj == nullptr) textFrameObj->content(text.text);
-		else                        descFrameObj->content(text.text, text.description, text.language);
+		if(descFrameObj == nullptr) textFrameObj->content(std::move(text.text));
+		else                        descFrameObj->content(std::move(text.text), std::move(text.description), text.language);
 	}
 }
 
 ///@pkg ID3.h
-void Tag::text(const FrameID& frameID, const std::string& text) {
+void Tag::text(const FrameID& frameID, std::string text) {
 	//Get the text frame. If a UnknownFrame exists at the position, delete it.
 	TextFrame* textFrameObj = getFrame<TextFrame>(frameID, true);
 	
 	//If the Frame doesn't exist, create it
 	//If the FrameID shouldn't be a TextFrame, then this will be ignored.
-	if(textFrameObj == nullptr) addFrame(frameID, factory.create(frameID, text));
-	else                        textFrameObj->content(text); //Set the content
+	if(textFrameObj == nullptr) addFrame(frameID, factory.create(frameID, std::move(text)));
+	else                        textFrameObj->content(std::move(text)); //Set the content
 }
 
 ///@pkg ID3.h
@@ -574,12 +1315,12 @@ void Tag::text(const FrameID&  frameID,
 ///@pkg ID3.h
 std::string Tag::genre(bool process) const {
 	std::string genreString = textString(Frames::FRAME_GENRE);
-	return process ? processGenre(genreString) : genreString;
+	return process ? V1::processGenre(genreString) : genreString;
 }
 ///@pkg ID3.h
 std::vector<std::string> Tag::genres(bool process) const {
 	std::vector<std::string> genreStrings = textStrings(Frames::FRAME_GENRE);
-	if(process) for(std::string& genre : genreStrings) genre = processGenre(genre);
+	if(process) for(std::string& genre : genreStrings) genre = V1::processGenre(genre);
 	return genreStrings;
 }
 ///@pkg ID3.h
@@ -696,7 +1437,7 @@ Picture Tag::picture(const std::function<bool (const std::string&, const Picture
 	return Picture(); //Return an empty picture
 }
 ///@pkg ID3.h
-void Tag::picture(const Picture& newPicture) {
+void Tag::picture(Picture newPicture) {
 	//Validate the picture size
 	if(newPicture.size() + HEADER_BYTE_SIZE > MAX_TAG_SIZE) {
 		FrameID picID = FRAME_PICTURE;
@@ -729,12 +1470,18 @@ void Tag::picture(const Picture& newPicture) {
 		}
 		//If a frame was found, update it
 		if(frame != nullptr) {
-			frame->picture(newPicture.data, newPicture.MIME, newPicture.description, newPicture.type);
+			frame->picture(std::move(newPicture.data),
+			               std::move(newPicture.MIME),
+			               std::move(newPicture.description),
+			               newPicture.type);
 			return;
 		}
 	}
 	//If no picture with the same description exists
-	addFrame(factory.createPicturePair(newPicture.data, newPicture.MIME, newPicture.description, newPicture.type));
+	addFrame(factory.createPicturePair(std::move(newPicture.data),
+	                                   std::move(newPicture.MIME),
+	                                   std::move(newPicture.description),
+	                                   newPicture.type));
 }
 
 ///@pkg ID3.h
@@ -877,6 +1624,76 @@ std::string Tag::fileName() const { return filename; }
 ///@pkg ID3.h
 ulong Tag::fileSize() const { return filesize; }
 
+///@pkg ID3.h
+uint64_t Tag::audioHash() const {
+	            //The start of the audio data in the file
+	const ulong AUDIO_START = tagsSet.v2 ? v2TagInfo.totalSize : 0,
+	            //The end of the audio data in the file
+	            AUDIO_END = filesize -
+	                        (tagsSet.v1 || tagsSet.v1_1 ? V1::BYTE_SIZE : 0) -
+	                        (tagsSet.v1Extended ? V1::EXTENDED_BYTE_SIZE : 0);
+	
+	ByteHasher hasher;
+	readFileRange(filename, filesize, AUDIO_START, AUDIO_END, [&hasher](const uint8_t* const bytes, const size_t size) {
+		hasher.update(bytes, size);
+	});
+	return hasher.digest();
+}
+
+///@pkg ID3.h
+uint64_t Tag::fingerprint() const {
+	//Hash every frame that would be written
+	std::vector<uint64_t> frameHashes;
+	frameHashes.reserve(frames.size());
+	for(const auto& framePair : frames) {
+		if(framePair.second.get() == nullptr || framePair.second->null() || framePair.second->empty() ||
+		   framePair.first == Frames::FRAME_TAGGING_TIME)
+			continue;
+		frameHashes.push_back(framePair.second->fingerprint());
+	}
+	
+	//Sort the frame hashes so that the order of the frames doesn't matter
+	std::sort(frameHashes.begin(), frameHashes.end());
+	ByteHasher hasher;
+	for(const uint64_t frameHash : frameHashes)
+		hasher.update(frameHash);
+	return hasher.digest();
+}
+
+///@pkg ID3.h
+uint64_t Tag::rawFingerprint() const {
+	if(!tagsSet.v2) return 0;
+	
+	//The version and flags are hashed, but not the tag size
+	ByteHasher hasher;
+	ByteArray header;
+	readFileRange(filename, filesize, 0, HEADER_BYTE_SIZE, [&header](const uint8_t* const bytes, const size_t size) {
+		header.insert(header.end(), bytes, bytes + size);
+	});
+	hasher.update(header.data() + 3, 3);
+	
+	//The padding is the zero bytes at the end of the tag, so zero bytes are
+	//only hashed once a byte after them shows they aren't padding. The footer
+	//is left out, as it repeats the header and holds the tag size.
+	ulong zeros = 0;
+	const uint8_t ZERO_BYTES[256] = {};
+	const ulong TAG_END = v2TagInfo.totalSize - (v2TagInfo.flagFooter ? HEADER_BYTE_SIZE : 0);
+	readFileRange(filename, filesize, HEADER_BYTE_SIZE, TAG_END,
+	              [&](const uint8_t* const bytes, const size_t size) {
+		size_t end = size;
+		while(end > 0 && bytes[end - 1] == '\0') end--;
+		if(end == 0) {
+			zeros += size;
+			return;
+		}
+		for(; zeros > 0; zeros -= std::min<ulong>(zeros, sizeof(ZERO_BYTES)))
+			hasher.update(ZERO_BYTES, std::min<ulong>(zeros, sizeof(ZERO_BYTES)));
+		hasher.update(bytes, end);
+		zeros = size - end;
+	});
+	return hasher.digest();
+}
+
 ///@pkg ID3.h
 void Tag::print(std::ostream& out) const {
 	out << "\n......................\n";
@@ -1013,13 +1830,15 @@ Text Tag::getTextStruct(const Frame* const frame) const {
 }
 
 ///@pkg ID3.h
-void Tag::readFile(std::istream& file, const bool readFrames) {
-	if(file) {
-		file.seekg(0, std::ifstream::end);
-		filesize = file.tellg(); //Get the filesize
-		readFileV2(file, readFrames);
-		readFileV1(file, readFrames);
-	}
+ErrorCode Tag::readFile(std::istream& file, const bool readFrames) {
+	if(!file) return ErrorCode::NONE;
+	
+	file.seekg(0, std::ifstream::end);
+	filesize = file.tellg(); //Get the filesize
+	const ErrorCode error = readFileV2(file, readFrames);
+	if(error != ErrorCode::NONE) return error;
+	readFileV1(file, readFrames);
+	return ErrorCode::NONE;
 }
 
 ///@pkg ID3.h
@@ -1031,40 +1850,55 @@ void Tag::readFileV1(std::istream& file, const bool readFrames) {
 		V1::ExtendedTag extTags;
 		bool extTagsSet = false;
 		
-		file.seekg(-V1::BYTE_SIZE, std::ifstream::end);
+		//Read the end of the file once, with room for both ID3v1 tag types
+		const ulong TAIL_SIZE = filesize > V1::BYTE_SIZE + V1::EXTENDED_BYTE_SIZE ?
+		                        V1::BYTE_SIZE + V1::EXTENDED_BYTE_SIZE : V1::BYTE_SIZE;
+		ByteArray tail(TAIL_SIZE);
+		
+		file.clear();
+		file.seekg(-static_cast<long>(TAIL_SIZE), std::ifstream::end);
 		if(file.fail()) return;
 		
-		file.read(reinterpret_cast<char*>(&tags), V1::BYTE_SIZE);
+		file.read(reinterpret_cast<char*>(tail.data()), TAIL_SIZE);
+		if(file.fail()) return;
 		
+		memcpy(&tags, tail.data() + TAIL_SIZE - V1::BYTE_SIZE, V1::BYTE_SIZE);
 		if(memcmp(tags.header, "TAG", 3) != 0) return;
 		
 		//Get the bytes for the extended tags
-		if(filesize > V1::BYTE_SIZE + V1::EXTENDED_BYTE_SIZE) {
-			file.seekg(-V1::BYTE_SIZE-V1::EXTENDED_BYTE_SIZE, std::ifstream::end);
-			extTagsSet = static_cast<bool>(file); //extTagsSet will be true only if the file is valid
-			if(extTagsSet) {
-				file.read(reinterpret_cast<char*>(&extTags), V1::EXTENDED_BYTE_SIZE);
-				extTagsSet = memcmp(extTags.header, "TAG+", 4) == 0;
-			}
+		if(TAIL_SIZE > V1::BYTE_SIZE) {
+			memcpy(&extTags, tail.data(), V1::EXTENDED_BYTE_SIZE);
+			extTagsSet = memcmp(extTags.header, "TAG+", 4) == 0;
 		}
 		
-		if(!readFrames) return;
+		//Only record which ID3v1 tags are on the file if the frames aren't read,
+		//so that version() is right and write() still removes them
+		if(!readFrames) {
+			if(tags.comment[28] == '\0' && tags.comment[29] != '\0')
+				tagsSet.v1_1 = true;
+			else
+				tagsSet.v1 = true;
+			tagsSet.v1Extended = extTagsSet;
+			return;
+		}
 		if(extTagsSet) setTags(extTags);
 		setTags(tags);
 	} catch(const std::exception& e) {}
 }
 
 ///@pkg ID3.h
-void Tag::readFileV2(std::istream& file, const bool readFrames) {
+ErrorCode Tag::readFileV2(std::istream& file, const bool readFrames) {
 	Header tagsHeader;
 	
-	if(filesize < HEADER_BYTE_SIZE) return;
+	if(filesize < HEADER_BYTE_SIZE) return ErrorCode::NONE;
 	
-	file.seekg(0, std::ifstream::beg);
-	if(!file) return;
+	//Read the start of the file once, which usually holds the whole tag
+	ByteArray head;
+	if(!readHead(file, head, std::min(filesize, HEAD_READ_SIZE)) || head.size() < HEADER_BYTE_SIZE)
+		return ErrorCode::NONE;
 	
-	file.read(reinterpret_cast<char*>(&tagsHeader), HEADER_BYTE_SIZE);
-	if(memcmp(tagsHeader.header, "ID3", 3) != 0) return;
+	memcpy(&tagsHeader, head.data(), HEADER_BYTE_SIZE);
+	if(memcmp(tagsHeader.header, "ID3", 3) != 0) return ErrorCode::NONE;
 	
 	//Get the tag flags
 	if((tagsHeader.flags & FLAG_UNSYNCHRONISATION) == FLAG_UNSYNCHRONISATION)
@@ -1085,34 +1919,57 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 	//The position to start reading from the file
 	ulong frameStartPos = HEADER_BYTE_SIZE;
 	
-	//Make sure the ID3v2 version is supported and that unsynchronisation
-	//isn't set on ID3v2.3 and below.
-	//In ID3v2.4, it is handled on a per-frame basis.
+	//Make sure the ID3v2 version is supported
 	if(v2TagInfo.majorVer < MIN_SUPPORTED_VERSION ||
 		v2TagInfo.majorVer > MAX_SUPPORTED_VERSION ||
-		v2TagInfo.minorVer != SUPPORTED_MINOR_VERSION ||
-		(v2TagInfo.flagUnsynchronisation && v2TagInfo.majorVer <= 3))
-		return;
+		v2TagInfo.minorVer != SUPPORTED_MINOR_VERSION)
+		return ErrorCode::NONE;
 	
-	//Make sure that the size is valid, or throw a FormatExcetion
+	//Make sure that the size is valid
 	if(v2TagInfo.totalSize > filesize)
-		throw FileFormatException("Tag size format error on file \"" + filename + "\" when reading tags: tags are bigger than the file size!");
+		return ErrorCode::FILE_FORMAT;
+	
+	//In ID3v2.3 and below unsynchronisation applies to the whole tag, so the
+	//tag is decoded in memory before the frames are read. In ID3v2.4, it is
+	//handled on a per-frame basis. Tags over the read limit are cut short
+	//rather than decoded.
+	const bool WHOLE_TAG_UNSYNC = v2TagInfo.flagUnsynchronisation && v2TagInfo.majorVer <= 3;
+	const ulong TAG_READ_SIZE = WHOLE_TAG_UNSYNC ? std::min(v2TagInfo.totalSize, frameLimits.totalSize) :
+	                                               v2TagInfo.totalSize;
+	
+	//Read the rest of the tag with one more read if the head didn't hold it
+	//all. If the frames aren't needed or the tag is over the read limit, the
+	//frames are read from the file instead.
+	if(head.size() < TAG_READ_SIZE && readFrames && TAG_READ_SIZE <= frameLimits.totalSize) {
+		if(!readHead(file, head, TAG_READ_SIZE) || head.size() < TAG_READ_SIZE)
+			return ErrorCode::NONE;
+	}
+	
+	std::unique_ptr<TagStream> tagStream;
+	if(head.size() >= TAG_READ_SIZE) {
+		head.resize(TAG_READ_SIZE);
+		//The tag header is never unsynchronised
+		if(WHOLE_TAG_UNSYNC) resynchronise(head, HEADER_BYTE_SIZE);
+		tagStream.reset(new TagStream(std::move(head)));
+	}
+	std::istream& tagFile = tagStream ? *tagStream : file;
+	const ulong tagEnd = tagStream ? tagStream->size() : v2TagInfo.totalSize;
 	
 	//Skip over the extended header
 	if(v2TagInfo.flagExtHeader) {
 		//Seek to the position to read the extended header
-		file.seekg(frameStartPos, std::ifstream::beg);
-		if(!file) return;
+		tagFile.seekg(frameStartPos, std::ifstream::beg);
+		if(!tagFile) return ErrorCode::NONE;
 		
 		//The extended header is different from ID3v2.4, and ID3v2.3, and ID3v2.2.
 		if(v2TagInfo.majorVer >= 4) {
 			V4ExtHeader extHeader;
 			
 			//Verify that there's enough space
-			if(frameStartPos + sizeof(V4ExtHeader) > filesize) return;
+			if(frameStartPos + sizeof(V4ExtHeader) > tagEnd) return ErrorCode::NONE;
 			
 			//Get the extended header
-			file.read(reinterpret_cast<char*>(&extHeader), sizeof(V4ExtHeader));
+			tagFile.read(reinterpret_cast<char*>(&extHeader), sizeof(V4ExtHeader));
 			
 			//Increment the start position. The extended header size is synchsafe in ID3v2.4
 			ulong extHeaderSize = byteIntVal(extHeader.size, 4, true);
@@ -1121,10 +1978,10 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 			V3ExtHeader extHeader;
 			
 			//Verify that there's enough space
-			if(frameStartPos + sizeof(V3ExtHeader) > filesize) return;
+			if(frameStartPos + sizeof(V3ExtHeader) > tagEnd) return ErrorCode::NONE;
 			
 			//Get the extended header
-			file.read(reinterpret_cast<char*>(&extHeader), sizeof(V3ExtHeader));
+			tagFile.read(reinterpret_cast<char*>(&extHeader), sizeof(V3ExtHeader));
 			
 			//Increment the start position. The extended header size is not synchsafe in ID3v2.3
 			ulong extHeaderSize = byteIntVal(extHeader.size, 4, false);
@@ -1133,7 +1990,7 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 			//In ID3v2.2, the extended header flag bit is used for a compression flag
 			//instead. Since there is no standard compression format used in ID3v2.2,
 			//it is not supported.
-			return;
+			return ErrorCode::NONE;
 		}
 	}
 	
@@ -1141,21 +1998,38 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 	tagsSet.v2 = true;
 	
 	//Initialize the Tag's FrameFactory properly
-	factory = FrameFactory(file, v2TagInfo.majorVer, v2TagInfo.totalSize);
+	factory = FrameFactory(tagFile, v2TagInfo.majorVer, tagEnd, frameLimits);
 	
-	if(!readFrames) return; //If readFrames is false, stop now
+	if(!readFrames) return ErrorCode::NONE; //If readFrames is false, stop now
+	
+	//The number of frames and bytes read so far, which are kept within the
+	//ReadLimits. The decoded ID3v2.3 tag counts towards the bytes.
+	ulong framesRead = 0;
+	ulong bytesRead = WHOLE_TAG_UNSYNC ? tagEnd : 0;
+	
+	//An unsynchronised ID3v2.3 tag that was cut short loses its last frames
+	if(WHOLE_TAG_UNSYNC && tagEnd < v2TagInfo.totalSize) framesSkipped = true;
 	
 	//Loop over the ID3 tags, and stop once all ID3 frames have been
-	//reached or a frame is null. Add every frame to the frames map.
-	while(frameStartPos + HEADER_BYTE_SIZE < v2TagInfo.totalSize) {
-		//Create a new Frame at this position
-		FramePtr frame = factory.create(frameStartPos);
-		//Add the Frame to the map if it's not null
-		if(!frame->null()) addFrame(frame->frame(), frame);
+	//reached, a frame is null, or too many frames have been read. Add every
+	//frame to the frames map.
+	while(frameStartPos + HEADER_BYTE_SIZE < tagEnd && framesRead < frameLimits.frames) {
+		//Create a new Frame at this position. Frames bigger than what's left of
+		//the read limit are skipped.
+		FramePtr frame = factory.create(frameStartPos, frameLimits.totalSize - std::min(bytesRead, frameLimits.totalSize));
+		framesRead++;
+		//Add the Frame to the map if it's not null. A frame that has a read
+		//size but wasn't read from file was skipped for being over the limits.
+		if(!frame->null() && addFrame(frame->frame(), frame))
+			bytesRead += frame->size(true);
+		else if(!frame->createdFromFile() && frame->readSize > HEADER_BYTE_SIZE)
+			framesSkipped = true;
 		//If the frame content is a valid size (bigger than an ID3v2 header)
 		//then continue on to the next frame. If not, then stop the loop.
-		if(frame->size(true) > HEADER_BYTE_SIZE && !frame->frame().unknown()) {
-			frameStartPos += frame->size(true);
+		//The size the frame took up in the tag is used rather than its current
+		//size, as undoing unsynchronisation may have shrunk it.
+		if(frame->readSize > HEADER_BYTE_SIZE && !frame->frame().unknown()) {
+			frameStartPos += frame->readSize;
 			
 			//Account for 4 bytes added when reading ID3v2.2 frames from the
 			//ID3::FrameFactory class
@@ -1167,6 +2041,17 @@ void Tag::readFileV2(std::istream& file, const bool readFrames) {
 			break;
 		}
 	}
+	
+	//If the frame limit stopped the loop, the rest of the tag is padding
+	//unless another frame starts there
+	if(framesRead >= frameLimits.frames && frameStartPos + HEADER_BYTE_SIZE < tagEnd) {
+		v2TagInfo.paddingStart = frameStartPos;
+		tagFile.clear();
+		tagFile.seekg(frameStartPos, std::ifstream::beg);
+		if(tagFile.peek() != '\0') framesSkipped = true;
+	}
+	
+	return ErrorCode::NONE;
 }
 
 ///@pkg ID3.h
@@ -0,0 +1,715 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <istream>    //For std::istream
+#include <cstring>    //For memcmp() and memcpy()
+#include <cerrno>     //For errno
+#include <algorithm>  //For std::min and std::max
+#include <fcntl.h>    //For open()
+#include <unistd.h>   //For pread(), pwrite(), ftruncate(), fdatasync(), and close()
+#include <stdio.h>    //For rename()
+#include <libgen.h>   //For dirname()
+#include <sys/mman.h> //For mmap() and munmap()
+#include <sys/stat.h> //For stat() and fstat()
+
+#include "ID3TagCache.hpp"          //For the class definition
+#include "Frames/ID3TextFrame.hpp"  //For TextFrame and DescriptiveTextFrame
+#include "ID3Functions.hpp"         //For byteIntVal()
+#include "ID3Constants.hpp"         //For HEADER_BYTE_SIZE and V1::BYTE_SIZE
+#include "ID3Exception.hpp"         //For exceptions
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The bytes at the start of a cache file: a magic string, the format
+	 * version, and a number to check the byte order with.
+	 */
+	const char CACHE_MAGIC[8] = {'I', 'D', '3', 'C', 'A', 'C', 'H', 'E'};
+	const uint32_t CACHE_VERSION = 1;
+	const uint32_t CACHE_BYTE_ORDER = 0x01020304;
+	const ulong CACHE_HEADER_SIZE = sizeof(CACHE_MAGIC) + 2 * sizeof(uint32_t);
+	
+	/**
+	 * Each entry's record starts with the size of its payload and a checksum
+	 * of the payload.
+	 */
+	const ulong RECORD_HEADER_SIZE = 2 * sizeof(uint32_t);
+	
+	/**
+	 * The number of bytes at the start of a payload that hold the FileKey.
+	 */
+	const ulong KEY_SIZE = 4 * sizeof(uint64_t);
+	
+	/**
+	 * How many bytes are read from the start of a file at once, which usually
+	 * holds the whole ID3v2 tag.
+	 */
+	const ulong HEAD_READ_SIZE = 64 * 1024;
+	
+	/**
+	 * The number of bytes kept from the start of a file without an ID3v2 tag,
+	 * so that its content can be checked with ID3::FileCheck::CONTENT.
+	 */
+	const ulong MIN_HEAD_SIZE = 16;
+	
+	/**
+	 * The FNV-1a hash of some bytes, used as the checksum of records.
+	 */
+	static uint32_t checksum(const uint8_t* bytes, const ulong size) {
+		uint32_t hash = 2166136261u;
+		for(ulong i = 0; i < size; i++) {
+			hash ^= bytes[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+	
+	/**
+	 * Append a number to a ByteArray, in the machine's byte order.
+	 */
+	template<typename Number>
+	static void putNumber(ByteArray& bytes, const Number number) {
+		const uint8_t* const start = reinterpret_cast<const uint8_t*>(&number);
+		bytes.insert(bytes.end(), start, start + sizeof(Number));
+	}
+	
+	/**
+	 * Append a string or ByteArray to a ByteArray, after its size.
+	 */
+	template<typename Container>
+	static void putBytes(ByteArray& bytes, const Container& value) {
+		putNumber<uint32_t>(bytes, value.size());
+		const uint8_t* const start = reinterpret_cast<const uint8_t*>(value.data());
+		bytes.insert(bytes.end(), start, start + value.size());
+	}
+	
+	/**
+	 * Reads the values written with putNumber() and putBytes() back from a
+	 * record. Once a read runs past the end of the record, every read fails.
+	 */
+	class RecordReader {
+		public:
+			RecordReader(const uint8_t* const start, const ulong size) : pos(start), end(start + size) {}
+			
+			template<typename Number>
+			bool number(Number& number) {
+				if(static_cast<ulong>(end - pos) < sizeof(Number)) return fail();
+				memcpy(&number, pos, sizeof(Number));
+				pos += sizeof(Number);
+				return true;
+			}
+			
+			template<typename Container>
+			bool bytes(Container& value) {
+				uint32_t size;
+				if(!number(size) || static_cast<ulong>(end - pos) < size) return fail();
+				value.assign(reinterpret_cast<const typename Container::value_type*>(pos),
+				             reinterpret_cast<const typename Container::value_type*>(pos + size));
+				pos += size;
+				return true;
+			}
+		
+		private:
+			bool fail() {
+				pos = end;
+				return false;
+			}
+			
+			const uint8_t* pos;
+			const uint8_t* end;
+	};
+	
+	/**
+	 * Write all of a ByteArray to a file descriptor.
+	 * 
+	 * @return false if it couldn't all be written, true otherwise.
+	 */
+	static bool writeAll(const int fd, const uint8_t* bytes, ulong size, ulong offset) {
+		while(size > 0) {
+			const ssize_t written = pwrite(fd, bytes, size, offset);
+			if(written < 0 && errno == EINTR) continue;
+			if(written <= 0) return false;
+			bytes += written, offset += written, size -= written;
+		}
+		return true;
+	}
+	
+	/**
+	 * Get where the ID3v2 tag at the start of a file ends.
+	 * 
+	 * @param head     The start of the file.
+	 * @param fileSize The size of the file.
+	 * @return The end of the tag, or 0 if the file has no ID3v2 tag.
+	 */
+	static ulong tagEnd(const ByteArray& head, const ulong fileSize) {
+		if(head.size() < HEADER_BYTE_SIZE || memcmp(head.data(), "ID3", 3) != 0) return 0;
+		Header header;
+		memcpy(&header, head.data(), HEADER_BYTE_SIZE);
+		const ulong TAG_SIZE = HEADER_BYTE_SIZE + byteIntVal(header.size, 4, true) +
+		                       ((header.flags & FLAG_FOOTER) == FLAG_FOOTER ? HEADER_BYTE_SIZE : 0);
+		return std::min(TAG_SIZE, fileSize);
+	}
+	
+	/**
+	 * A file that is known from its cached head and tail. Reading anywhere
+	 * between the two reads zeros, like padding, except for the part of an
+	 * ID3v2 tag that was over the ReadLimits when it was cached, which can't
+	 * be read. ID3::Tag reads the file's tags from it as if it were the file.
+	 */
+	class CachedFileStream : public std::istream {
+		public:
+			/**
+			 * @param head     The start of the file.
+			 * @param tail     The end of the file.
+			 * @param fileSize The size of the file.
+			 */
+			CachedFileStream(ByteArray head, ByteArray tail, const ulong fileSize) : std::istream(nullptr),
+			                                                                         buffer(std::move(head),
+			                                                                                std::move(tail),
+			                                                                                fileSize) {
+				rdbuf(&buffer);
+			}
+			
+			/**
+			 * @return true if a read reached the part of the tag that isn't
+			 *         cached, false otherwise.
+			 */
+			bool cutShort() const { return buffer.readUncached(); }
+		
+		private:
+			/**
+			 * A read-only, seekable stream buffer over the head and tail.
+			 */
+			class CachedFileBuffer : public std::streambuf {
+				public:
+					CachedFileBuffer(ByteArray headBytes, ByteArray tailBytes, const ulong size) : head(std::move(headBytes)),
+					                                                                              tail(std::move(tailBytes)),
+					                                                                              fileSize(size),
+					                                                                              tailStart(size - std::min<ulong>(size, tail.size())),
+					                                                                              uncachedEnd(std::max(head.size(), tagEnd(head, size))),
+					                                                                              segmentStart(0),
+					                                                                              uncachedRead(false) {
+						setg(zeros, zeros, zeros);
+					}
+					
+					bool readUncached() const { return uncachedRead; }
+				
+				protected:
+					int_type underflow() override {
+						const ulong POS = segmentStart + (egptr() - eback());
+						if(POS >= fileSize) return traits_type::eof();
+						
+						if(POS < head.size()) {
+							segmentStart = 0;
+							char* const start = reinterpret_cast<char*>(head.data());
+							setg(start, start + POS, start + std::min<ulong>(head.size(), fileSize));
+						} else if(POS >= tailStart) {
+							segmentStart = tailStart;
+							char* const start = reinterpret_cast<char*>(tail.data()) + (tail.size() - (fileSize - tailStart));
+							setg(start, start + (POS - tailStart), start + (fileSize - tailStart));
+						} else if(POS < uncachedEnd) {
+							//The rest of the tag was over the ReadLimits, so it isn't known
+							uncachedRead = true;
+							return traits_type::eof();
+						} else {
+							segmentStart = POS;
+							setg(zeros, zeros, zeros + std::min<ulong>(sizeof(zeros), tailStart - POS));
+						}
+						return traits_type::to_int_type(*gptr());
+					}
+					
+					pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+						const off_type CURRENT = segmentStart + (gptr() - eback());
+						const off_type POS = dir == std::ios_base::beg ? off :
+						                     dir == std::ios_base::cur ? CURRENT + off : fileSize + off;
+						if((which & std::ios_base::in) == 0 || POS < 0 || POS > static_cast<off_type>(fileSize))
+							return pos_type(off_type(-1));
+						
+						//The next read finds the right segment
+						segmentStart = POS;
+						setg(zeros, zeros, zeros);
+						return pos_type(POS);
+					}
+					
+					pos_type seekpos(pos_type pos, std::ios_base::openmode which) override {
+						return seekoff(off_type(pos), std::ios_base::beg, which);
+					}
+				
+				private:
+					ByteArray head;
+					ByteArray tail;
+					ulong fileSize;
+					ulong tailStart;
+					ulong uncachedEnd;
+					ulong segmentStart;
+					bool uncachedRead;
+					char zeros[4096] = {};
+			};
+			
+			/**
+			 * The stream buffer reading from the head and tail.
+			 */
+			CachedFileBuffer buffer;
+	};
+	
+	/**
+	 * Read the start and end of a file, enough to read its tags.
+	 * 
+	 * @param file     The file.
+	 * @param fileSize The size of the file.
+	 * @param limits   The limits on how much of the ID3v2 tag is read.
+	 * @param head     Where to put the start of the file.
+	 * @param tail     Where to put the end of the file.
+	 * @return false if the file can't be read, true otherwise.
+	 */
+	static bool readTagBytes(std::istream&     file,
+	                         const ulong       fileSize,
+	                         const ReadLimits& limits,
+	                         ByteArray&        head,
+	                         ByteArray&        tail) {
+		//Read the start of the file, which usually holds the whole tag
+		file.seekg(0, std::ios::beg);
+		head.resize(std::min(fileSize, HEAD_READ_SIZE));
+		file.read(reinterpret_cast<char*>(head.data()), head.size());
+		if(static_cast<ulong>(file.gcount()) != head.size()) return false;
+		
+		//Find the size of the ID3v2 tag, if any
+		const ulong tagSize = std::min(tagEnd(head, fileSize), limits.totalSize);
+		
+		//Read the rest of the tag, or only keep the tag
+		const ulong HEAD_SIZE = std::max(tagSize, std::min(fileSize, MIN_HEAD_SIZE));
+		if(HEAD_SIZE > head.size()) {
+			const ulong START = head.size();
+			head.resize(HEAD_SIZE);
+			file.read(reinterpret_cast<char*>(head.data() + START), HEAD_SIZE - START);
+			if(static_cast<ulong>(file.gcount()) != HEAD_SIZE - START) return false;
+		} else {
+			head.resize(HEAD_SIZE);
+			head.shrink_to_fit();
+		}
+		
+		//Read the end of the file, with room for both ID3v1 tag types
+		tail.resize(std::min<ulong>(fileSize, V1::BYTE_SIZE + V1::EXTENDED_BYTE_SIZE));
+		file.clear();
+		file.seekg(-static_cast<long>(tail.size()), std::ios::end);
+		file.read(reinterpret_cast<char*>(tail.data()), tail.size());
+		return static_cast<ulong>(file.gcount()) == tail.size();
+	}
+}
+
+///@pkg ID3TagCache.h
+TagCache::TagCache(const std::string& cacheLoc, const bool storeTags) : cacheFile(cacheLoc),
+                                                                        storeTagBytes(storeTags),
+                                                                        fd(-1),
+                                                                        mapping(nullptr),
+                                                                        mappedSize(0),
+                                                                        fileEnd(0),
+                                                                        cacheWritable(true),
+                                                                        appendFailed(false) {
+	load();
+}
+
+///@pkg ID3TagCache.h
+TagCache::~TagCache() {
+	sync();
+	close();
+}
+
+///@pkg ID3TagCache.h
+bool TagCache::find(const std::string& fileLoc, Entry& entry) const {
+	FileKey key;
+	if(!statFile(fileLoc, key)) return false;
+	
+	const Location* const location = locate(key);
+	if(location == nullptr) return false;
+	
+	Entry cached;
+	if(!read(*location, nullptr, &cached)) return false;
+	entry = std::move(cached);
+	return true;
+}
+
+///@pkg ID3TagCache.h
+ErrorCode TagCache::update(const std::string& fileLoc) {
+	FileKey key;
+	const Location* const location = statFile(fileLoc, key) ? locate(key) : nullptr;
+	if(location != nullptr) {
+		//A file that was moved or renamed keeps its entry, under its new path
+		std::string cachedLoc;
+		Entry entry;
+		if(read(*location, &cachedLoc, nullptr) && cachedLoc == fileLoc) return ErrorCode::NONE;
+		if(read(*location, nullptr, &entry)) {
+			try {
+				append(key, fileLoc, entry);
+			} catch(const WriteException&) {
+				return ErrorCode::WRITE;
+			}
+			return ErrorCode::NONE;
+		}
+	}
+	
+	//Tag treats a cache that can't be written to as a miss, so check that
+	//the entry was added
+	Tag tag;
+	appendFailed = false;
+	const ErrorCode error = tag.load(fileLoc, true, this);
+	return error == ErrorCode::NONE && appendFailed ? ErrorCode::WRITE : error;
+}
+
+///@pkg ID3TagCache.h
+void TagCache::compact() {
+	const std::string compactFile = cacheFile + ".compact";
+	const int newFD = ::open(compactFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(newFD < 0)
+		throw WriteException("Cannot compact the tag cache \"" + cacheFile + "\", unable to create \"" + compactFile + "\".");
+	
+	//Copy the newest entry of every file that is unchanged
+	ByteArray output;
+	output.insert(output.end(), CACHE_MAGIC, CACHE_MAGIC + sizeof(CACHE_MAGIC));
+	putNumber(output, CACHE_VERSION);
+	putNumber(output, CACHE_BYTE_ORDER);
+	ulong written = 0;
+	bool success = true;
+	for(const auto& indexPair : index) {
+		const Location& location = indexPair.second;
+		std::string fileLoc;
+		FileKey key;
+		if(!read(location, &fileLoc, nullptr) || !statFile(fileLoc, key) || locate(key) != &location)
+			continue;
+		output.insert(output.end(), mapping + location.offset, mapping + location.offset + location.length);
+		
+		//Write in large chunks
+		if(output.size() >= 1024 * 1024) {
+			success = writeAll(newFD, output.data(), output.size(), written);
+			if(!success) break;
+			written += output.size();
+			output.clear();
+		}
+	}
+	success = success && writeAll(newFD, output.data(), output.size(), written) && fsync(newFD) == 0;
+	::close(newFD);
+	
+	if(!success || rename(compactFile.c_str(), cacheFile.c_str()) != 0) {
+		unlink(compactFile.c_str());
+		throw WriteException("Cannot compact the tag cache \"" + cacheFile + "\", error writing \"" + compactFile + "\".");
+	}
+	
+	//Sync the directory so the rename survives a crash. If it doesn't, the
+	//old cache file is back after the crash, which is still a valid cache.
+	std::string directory = cacheFile;
+	const int dirFD = ::open(dirname(&directory[0]), O_RDONLY | O_DIRECTORY);
+	if(dirFD >= 0) {
+		fsync(dirFD);
+		::close(dirFD);
+	}
+	
+	//Open the compacted cache file
+	close();
+	load();
+}
+
+///@pkg ID3TagCache.h
+void TagCache::sync() {
+	if(fd >= 0) fdatasync(fd);
+}
+
+///@pkg ID3TagCache.h
+size_t TagCache::size() const { return index.size(); }
+
+///@pkg ID3TagCache.h
+bool TagCache::storesTags() const { return storeTagBytes; }
+
+///@pkg ID3TagCache.h
+bool TagCache::writable() const { return cacheWritable; }
+
+///@pkg ID3TagCache.h
+bool TagCache::statFile(const std::string& fileLoc, FileKey& key) {
+	struct stat info;
+	if(stat(fileLoc.c_str(), &info) != 0 || !S_ISREG(info.st_mode)) return false;
+	key.device   = info.st_dev;
+	key.inode    = info.st_ino;
+	key.size     = info.st_size;
+	key.modified = static_cast<uint64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+	return true;
+}
+
+///@pkg ID3TagCache.h
+std::unique_ptr<std::istream> TagCache::stream(const std::string& fileLoc,
+                                               Pending&           pending,
+                                               const ReadLimits&  limits,
+                                               const ReadMode     mode) {
+	FileKey key;
+	if(!statFile(fileLoc, key)) return nullptr;
+	
+	//Use the cached entry if it has the tag bytes. Entries without them are
+	//kept, and the file is read directly.
+	const Location* const location = locate(key);
+	if(location != nullptr) {
+		Entry entry;
+		if(read(*location, nullptr, &entry)) {
+			if(entry.head.empty() && key.size > 0) return nullptr;
+			//A tag that was cut short by lower ReadLimits is read again
+			if(entry.head.size() >= tagEnd(entry.head, key.size) || entry.head.size() >= limits.totalSize)
+				return std::unique_ptr<std::istream>(new CachedFileStream(std::move(entry.head),
+				                                                          std::move(entry.tail),
+				                                                          key.size));
+		}
+	}
+	
+	//Read the file, and let the Tag read from the bytes that will be cached
+	Entry entry;
+	entry.fileSize = key.size;
+	std::unique_ptr<std::istream> tagFile = Tag::openFile(fileLoc, mode);
+	if(!*tagFile || !readTagBytes(*tagFile, key.size, limits, entry.head, entry.tail)) return nullptr;
+	std::unique_ptr<std::istream> file(new CachedFileStream(entry.head, entry.tail, key.size));
+	
+	pending.valid = true;
+	pending.key = key;
+	pending.fileLoc = fileLoc;
+	pending.entry = std::move(entry);
+	return file;
+}
+
+///@pkg ID3TagCache.h
+bool TagCache::cutShort(const std::istream& stream) {
+	const CachedFileStream* const cachedFile = dynamic_cast<const CachedFileStream*>(&stream);
+	return cachedFile != nullptr && cachedFile->cutShort();
+}
+
+///@pkg ID3TagCache.h
+void TagCache::insert(Pending& pending, const Tag& tag) {
+	if(!pending.valid) return;
+	pending.valid = false;
+	
+	Entry& entry = pending.entry;
+	for(const auto& framePair : tag.frames) {
+		const TextFrame* const textFrame = dynamic_cast<const TextFrame*>(framePair.second.get());
+		if(textFrame == nullptr) continue;
+		const DescriptiveTextFrame* const descFrame = dynamic_cast<const DescriptiveTextFrame*>(textFrame);
+		entry.fields.emplace_back(framePair.first,
+		                          descFrame == nullptr ? Text(textFrame->content()) :
+		                                                 Text(descFrame->TextFrame::content(),
+		                                                      descFrame->description(),
+		                                                      descFrame->language()));
+	}
+	
+	if(!storeTagBytes) {
+		entry.head.clear();
+		entry.tail.clear();
+	}
+	append(pending.key, pending.fileLoc, entry);
+}
+
+///@pkg ID3TagCache.h
+void TagCache::append(const FileKey& key, const std::string& fileLoc, const Entry& entry) {
+	if(!cacheWritable) {
+		appendFailed = true;
+		throw WriteException("Cannot write to the tag cache \"" + cacheFile + "\", as a failed write to it couldn't be undone.");
+	}
+	
+	//Build the record, leaving room for its header
+	ByteArray record(RECORD_HEADER_SIZE);
+	putNumber(record, key.device);
+	putNumber(record, key.inode);
+	putNumber(record, key.size);
+	putNumber(record, key.modified);
+	putBytes(record, fileLoc);
+	putNumber<uint32_t>(record, entry.fields.size());
+	for(const auto& field : entry.fields) {
+		putBytes(record, std::string(field.first));
+		putBytes(record, field.second.text);
+		putBytes(record, field.second.description);
+		putBytes(record, field.second.language);
+	}
+	putBytes(record, entry.head);
+	putBytes(record, entry.tail);
+	
+	const uint32_t PAYLOAD_SIZE = record.size() - RECORD_HEADER_SIZE;
+	const uint32_t CHECKSUM = checksum(record.data() + RECORD_HEADER_SIZE, PAYLOAD_SIZE);
+	memcpy(record.data(), &PAYLOAD_SIZE, sizeof(uint32_t));
+	memcpy(record.data() + sizeof(uint32_t), &CHECKSUM, sizeof(uint32_t));
+	
+	//Write the whole record at the end. If that fails, cut off whatever part
+	//of it was written, and stop writing to the cache if that fails too.
+	if(!writeAll(fd, record.data(), record.size(), fileEnd)) {
+		if(ftruncate(fd, fileEnd) != 0) cacheWritable = false;
+		appendFailed = true;
+		throw WriteException("Cannot write to the tag cache \"" + cacheFile + "\".");
+	}
+	
+	index[std::make_pair(key.device, key.inode)] = Location{key, fileEnd, record.size(), true};
+	fileEnd += record.size();
+}
+
+///@pkg ID3TagCache.h
+void TagCache::load() {
+	cacheWritable = true;
+	fd = ::open(cacheFile.c_str(), O_RDWR | O_CREAT, 0644);
+	if(fd < 0)
+		throw FileNotFoundException("Tag cache \"" + cacheFile + "\" cannot be opened!\n");
+	
+	struct stat info;
+	if(fstat(fd, &info) != 0) {
+		close();
+		throw FileNotFoundException("Tag cache \"" + cacheFile + "\" cannot be opened!\n");
+	}
+	
+	//Start a new cache file
+	if(info.st_size == 0) {
+		ByteArray header(CACHE_MAGIC, CACHE_MAGIC + sizeof(CACHE_MAGIC));
+		putNumber(header, CACHE_VERSION);
+		putNumber(header, CACHE_BYTE_ORDER);
+		if(!writeAll(fd, header.data(), header.size(), 0)) {
+			close();
+			throw FileNotFoundException("Tag cache \"" + cacheFile + "\" cannot be written to!\n");
+		}
+		fileEnd = header.size();
+		map();
+		return;
+	}
+	
+	//Check the cache file header
+	fileEnd = info.st_size;
+	map();
+	uint32_t version = 0, byteOrder = 0;
+	if(mapping != nullptr && mappedSize >= CACHE_HEADER_SIZE) {
+		memcpy(&version, mapping + sizeof(CACHE_MAGIC), sizeof(uint32_t));
+		memcpy(&byteOrder, mapping + sizeof(CACHE_MAGIC) + sizeof(uint32_t), sizeof(uint32_t));
+	}
+	if(mapping == nullptr ||
+	   mappedSize < CACHE_HEADER_SIZE ||
+	   memcmp(mapping, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+	   version != CACHE_VERSION ||
+	   byteOrder != CACHE_BYTE_ORDER) {
+		close();
+		throw FileFormatException("File \"" + cacheFile + "\" is not a tag cache written by this machine!");
+	}
+	
+	//Index every entry by following the record sizes, with later entries of
+	//a file replacing earlier ones. The checksums are checked when an entry
+	//is read, so that opening the cache doesn't read all of it. Damaged
+	//entries are skipped over, and only the last entry is checked now, as a
+	//crash while appending it may have cut it short.
+	ulong pos = CACHE_HEADER_SIZE;
+	while(pos + RECORD_HEADER_SIZE <= mappedSize) {
+		uint32_t payloadSize, recordChecksum;
+		memcpy(&payloadSize, mapping + pos, sizeof(uint32_t));
+		memcpy(&recordChecksum, mapping + pos + sizeof(uint32_t), sizeof(uint32_t));
+		const uint8_t* const payload = mapping + pos + RECORD_HEADER_SIZE;
+		if(payloadSize > mappedSize - pos - RECORD_HEADER_SIZE) break;
+		const bool LAST = pos + RECORD_HEADER_SIZE + payloadSize == mappedSize;
+		if(LAST && checksum(payload, payloadSize) != recordChecksum) break;
+		
+		if(payloadSize >= KEY_SIZE) {
+			Location location;
+			RecordReader reader(payload, payloadSize);
+			reader.number(location.key.device);
+			reader.number(location.key.inode);
+			reader.number(location.key.size);
+			reader.number(location.key.modified);
+			location.offset = pos;
+			location.length = RECORD_HEADER_SIZE + payloadSize;
+			location.verified = LAST;
+			index[std::make_pair(location.key.device, location.key.inode)] = location;
+		}
+		pos += RECORD_HEADER_SIZE + payloadSize;
+	}
+	
+	//Drop the last entry if it was cut short, so new entries follow on from
+	//the one before it. If it can't be dropped, the cache can only be read.
+	if(pos < fileEnd) {
+		fileEnd = pos;
+		if(ftruncate(fd, fileEnd) != 0) cacheWritable = false;
+		map();
+	}
+}
+
+///@pkg ID3TagCache.h
+void TagCache::map() const {
+	if(mapping != nullptr) munmap(const_cast<uint8_t*>(mapping), mappedSize);
+	mapping = nullptr;
+	mappedSize = 0;
+	if(fd < 0 || fileEnd == 0) return;
+	
+	void* const memory = mmap(nullptr, fileEnd, PROT_READ, MAP_SHARED, fd, 0);
+	if(memory == MAP_FAILED) return;
+	mapping = static_cast<const uint8_t*>(memory);
+	mappedSize = fileEnd;
+}
+
+///@pkg ID3TagCache.h
+void TagCache::close() {
+	if(mapping != nullptr) munmap(const_cast<uint8_t*>(mapping), mappedSize);
+	mapping = nullptr;
+	mappedSize = 0;
+	if(fd >= 0) ::close(fd);
+	fd = -1;
+	fileEnd = 0;
+	index.clear();
+}
+
+///@pkg ID3TagCache.h
+const TagCache::Location* TagCache::locate(const FileKey& key) const {
+	const auto found = index.find(std::make_pair(key.device, key.inode));
+	if(found == index.end() ||
+	   found->second.key.size != key.size ||
+	   found->second.key.modified != key.modified)
+		return nullptr;
+	return &found->second;
+}
+
+///@pkg ID3TagCache.h
+bool TagCache::read(const Location& location, std::string* fileLoc, Entry* entry) const {
+	//Map the entries appended since the cache file was mapped
+	if(location.offset + location.length > mappedSize) map();
+	if(location.offset + location.length > mappedSize) return false;
+	
+	//Check the record the first time it's read
+	const uint8_t* const payload = mapping + location.offset + RECORD_HEADER_SIZE;
+	const ulong PAYLOAD_SIZE = location.length - RECORD_HEADER_SIZE;
+	if(!location.verified) {
+		uint32_t recordChecksum;
+		memcpy(&recordChecksum, mapping + location.offset + sizeof(uint32_t), sizeof(uint32_t));
+		if(checksum(payload, PAYLOAD_SIZE) != recordChecksum) return false;
+		location.verified = true;
+	}
+	
+	RecordReader reader(payload, PAYLOAD_SIZE);
+	FileKey key;
+	std::string path;
+	if(!reader.number(key.device) ||
+	   !reader.number(key.inode) ||
+	   !reader.number(key.size) ||
+	   !reader.number(key.modified) ||
+	   !reader.bytes(path))
+		return false;
+	if(fileLoc != nullptr) *fileLoc = std::move(path);
+	if(entry == nullptr) return true;
+	
+	uint32_t fieldCount;
+	if(!reader.number(fieldCount)) return false;
+	entry->fileSize = key.size;
+	entry->fields.clear();
+	for(uint32_t i = 0; i < fieldCount; i++) {
+		std::string id;
+		Text text;
+		if(!reader.bytes(id) ||
+		   !reader.bytes(text.text) ||
+		   !reader.bytes(text.description) ||
+		   !reader.bytes(text.language))
+			return false;
+		entry->fields.emplace_back(FrameID(id), std::move(text));
+	}
+	return reader.bytes(entry->head) && reader.bytes(entry->tail);
+}
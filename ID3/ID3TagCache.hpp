@@ -0,0 +1,366 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_TAG_CACHE_HPP
+#define ID3_TAG_CACHE_HPP
+
+#include <string>        //For std::string
+#include <vector>        //For std::vector
+#include <unordered_map> //For std::unordered_map
+#include <utility>       //For std::pair
+#include <memory>        //For std::unique_ptr
+#include <istream>       //For std::istream
+#include <cstdint>       //For uint64_t
+
+#include "ID3.hpp" //For Tag, Text, FrameID, and ByteArray
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * TagCache is an on-disk cache of the tags of many files, so that files
+	 * that haven't changed don't have to be read again when a music library is
+	 * scanned. Each file is identified by its device, inode, size, and
+	 * modification time, so a file that is changed in any way is read again.
+	 * 
+	 * For every file the cache holds the text of its text frames, which can be
+	 * looked up with find() without creating a Tag. It can also hold the bytes
+	 * of the file's tags, in which case constructing a Tag with the cache reads
+	 * the tags from the cache instead of the file.
+	 * 
+	 * The cache is a single file that is memory-mapped for reading. Entries
+	 * are only ever appended to it, and each one has a checksum that is
+	 * checked when the entry is first read. An entry at the end of the cache
+	 * that was cut short by a crash is dropped the next time the cache is
+	 * opened, and a damaged entry elsewhere is treated as a miss. Replaced
+	 * and damaged entries and entries for files that no longer exist take up
+	 * space until compact() is called.
+	 * 
+	 * NOTE: The cache file is stored in the byte order of the machine, and
+	 *       should only be used on the machine that wrote it. A TagCache must
+	 *       not be used by more than one thread or process at once.
+	 * 
+	 * @see ID3::Tag::Tag(std::string&, TagCache&, FileCheck, ReadLimits&, ReadMode)
+	 */
+	class TagCache {
+		friend class Tag;
+		
+		public:
+			/**
+			 * The cached information about a file.
+			 */
+			struct Entry {
+				/**
+				 * The size of the file in bytes.
+				 */
+				ulong fileSize = 0;
+				
+				/**
+				 * The text frames of the file, with their descriptions and
+				 * languages. ID3v1 tags are included as the frames they are read as.
+				 */
+				std::vector<std::pair<FrameID, Text>> fields;
+				
+				/**
+				 * The start of the file, up to the end of its ID3v2 tag or the
+				 * ReadLimits::totalSize it was read with. Empty if the cache doesn't
+				 * store tag bytes.
+				 */
+				ByteArray head;
+				
+				/**
+				 * The end of the file, holding any ID3v1 tags. Empty if the cache
+				 * doesn't store tag bytes.
+				 */
+				ByteArray tail;
+			};
+			
+			/**
+			 * Open a cache file, creating it if it doesn't exist.
+			 * 
+			 * @param cacheLoc  The location of the cache file.
+			 * @param storeTags Whether to store the bytes of each file's tags, so
+			 *                  that Tag objects can be created from the cache
+			 *                  (optional, defaults to true).
+			 * @throws ID3::FileNotFoundException if the cache file can't be opened
+			 *                                    or created.
+			 * @throws ID3::FileFormatException if the file isn't a tag cache.
+			 */
+			explicit TagCache(const std::string& cacheLoc, const bool storeTags=true);
+			
+			/**
+			 * The destructor, which syncs and closes the cache file.
+			 */
+			~TagCache();
+			
+			TagCache(const TagCache&) = delete;
+			TagCache& operator=(const TagCache&) = delete;
+			
+			/**
+			 * Look up a file in the cache. The file is checked to not have
+			 * changed since it was cached, but it isn't read.
+			 * 
+			 * @param fileLoc The file location.
+			 * @param entry   The Entry to fill in. It is only changed if found.
+			 * @return true if the file is in the cache and hasn't changed, false
+			 *         otherwise.
+			 */
+			bool find(const std::string& fileLoc, Entry& entry) const;
+			
+			/**
+			 * Read a file's tags into the cache if it isn't already in the cache
+			 * or if it has changed.
+			 * 
+			 * NOTE: A file that was moved or renamed on the same file system
+			 *       without being changed isn't read again. Its entry is kept,
+			 *       under the new file location.
+			 * 
+			 * @param fileLoc The file location.
+			 * @return ErrorCode::NONE if the file is in the cache,
+			 *         ErrorCode::WRITE if it was read but couldn't be added to
+			 *         the cache, or the ErrorCode from reading the file.
+			 * @see ID3::Tag::open()
+			 */
+			ErrorCode update(const std::string& fileLoc);
+			
+			/**
+			 * Rewrite the cache file with only the newest entry of each file,
+			 * dropping files that have changed or no longer exist. The new cache
+			 * file replaces the old one atomically, and its directory is synced
+			 * so that the replacement survives a crash.
+			 * 
+			 * @throws ID3::WriteException if the new cache file can't be written.
+			 */
+			void compact();
+			
+			/**
+			 * Flush the appended entries to disk.
+			 */
+			void sync();
+			
+			/**
+			 * @return The number of files in the cache.
+			 */
+			size_t size() const;
+			
+			/**
+			 * @return true if the cache stores the bytes of each file's tags.
+			 */
+			bool storesTags() const;
+			
+			/**
+			 * Check if entries can be added to the cache. A failed write that
+			 * can't be cut off the end of the cache file makes the cache
+			 * read-only until it's compacted or opened again.
+			 * 
+			 * @return true if the cache can be written to, false otherwise.
+			 */
+			bool writable() const;
+		
+		private:
+			/**
+			 * What identifies a file, and whether it has changed.
+			 */
+			struct FileKey {
+				uint64_t device;
+				uint64_t inode;
+				uint64_t size;
+				uint64_t modified; //In nanoseconds
+			};
+			
+			/**
+			 * Where the newest entry of a file is in the cache file.
+			 */
+			struct Location {
+				FileKey key;
+				ulong offset;          //The start of the entry's record
+				ulong length;          //The length of the entry's record
+				mutable bool verified; //Whether the record's checksum was checked
+			};
+			
+			/**
+			 * A file read by Tag through the cache, whose entry hasn't been
+			 * added to the cache yet.
+			 */
+			struct Pending {
+				bool valid = false;
+				FileKey key;
+				std::string fileLoc;
+				Entry entry;
+			};
+			
+			/**
+			 * Get the key of a file from stat().
+			 * 
+			 * @param fileLoc The file location.
+			 * @param key     The FileKey to fill in.
+			 * @return false if the file doesn't exist or isn't a regular file,
+			 *         true otherwise.
+			 */
+			static bool statFile(const std::string& fileLoc, FileKey& key);
+			
+			/**
+			 * Get the stream Tag reads a file's tags from.
+			 * 
+			 * NOTE: If the file wasn't in the cache, it is read into pending,
+			 *       which must be given to insert() after the Tag has read it.
+			 * 
+			 * @param fileLoc The file location.
+			 * @param pending Where to put the bytes of a file that isn't cached.
+			 * @param limits  The limits on how much of the ID3v2 tag is read.
+			 * @param mode    How the file is read if it isn't cached.
+			 * @return A stream holding the start and end of the file, or nullptr
+			 *         if the file has to be read directly.
+			 */
+			std::unique_ptr<std::istream> stream(const std::string& fileLoc,
+			                                     Pending&           pending,
+			                                     const ReadLimits&  limits,
+			                                     const ReadMode     mode);
+			
+			/**
+			 * Check if a Tag reading from a stream from stream() reached the part
+			 * of the file's ID3v2 tag that isn't cached, because the tag was over
+			 * the ReadLimits it was cached with. Those reads fail, so the Tag
+			 * is missing the frames there.
+			 * 
+			 * @param stream The stream from stream().
+			 * @return true if the read was cut short, false otherwise.
+			 */
+			static bool cutShort(const std::istream& stream);
+			
+			/**
+			 * Add a file read through stream() to the cache.
+			 * 
+			 * @param pending The Pending filled by stream().
+			 * @param tag     The Tag that read it.
+			 * @throws ID3::WriteException if the entry can't be written.
+			 */
+			void insert(Pending& pending, const Tag& tag);
+			
+			/**
+			 * Append an entry to the cache file.
+			 * 
+			 * @param key     The file key.
+			 * @param fileLoc The file location.
+			 * @param entry   The entry.
+			 * @throws ID3::WriteException if the entry can't be written, or if
+			 *         the cache isn't writable.
+			 */
+			void append(const FileKey& key, const std::string& fileLoc, const Entry& entry);
+			
+			/**
+			 * Open and map the cache file, and index the entries in it without
+			 * checking their checksums. A last entry that was cut short is cut
+			 * off.
+			 * 
+			 * @throws ID3::FileNotFoundException if the cache file can't be opened.
+			 * @throws ID3::FileFormatException if the file isn't a tag cache.
+			 */
+			void load();
+			
+			/**
+			 * Map the cache file into memory, up to its current end.
+			 */
+			void map() const;
+			
+			/**
+			 * Unmap and close the cache file.
+			 */
+			void close();
+			
+			/**
+			 * Find the newest entry of a file, if it hasn't changed.
+			 * 
+			 * @param key The file key from stat().
+			 * @return The entry's Location, or nullptr if not found.
+			 */
+			const Location* locate(const FileKey& key) const;
+			
+			/**
+			 * Read an entry's record from the mapped cache file.
+			 * 
+			 * @param location The entry's Location.
+			 * @param fileLoc  Where to put the cached file location (optional).
+			 * @param entry    Where to put the entry (optional).
+			 * @return false if the record is damaged, true otherwise.
+			 */
+			bool read(const Location& location, std::string* fileLoc, Entry* entry) const;
+			
+			/**
+			 * Hash the device and inode of a FileKey.
+			 */
+			struct FileHash {
+				size_t operator()(const std::pair<uint64_t, uint64_t>& id) const noexcept {
+					return std::hash<uint64_t>()(id.first * 0x9E3779B97F4A7C15ULL ^ id.second);
+				}
+			};
+			
+			/**
+			 * The location of the cache file.
+			 */
+			std::string cacheFile;
+			
+			/**
+			 * Whether to store the bytes of each file's tags.
+			 */
+			bool storeTagBytes;
+			
+			/**
+			 * The cache file descriptor, or -1 if closed.
+			 */
+			int fd;
+			
+			/**
+			 * The memory-mapped cache file, or nullptr if not mapped.
+			 */
+			mutable const uint8_t* mapping;
+			
+			/**
+			 * How many bytes of the cache file are mapped.
+			 */
+			mutable ulong mappedSize;
+			
+			/**
+			 * The end of the last entry in the cache file, where the next entry is
+			 * appended.
+			 */
+			ulong fileEnd;
+			
+			/**
+			 * Whether entries can be appended to the cache file.
+			 * 
+			 * @see ID3::TagCache::writable()
+			 */
+			bool cacheWritable;
+			
+			/**
+			 * Whether the last entry that was appended failed to be written, so
+			 * that update() can report it.
+			 */
+			bool appendFailed;
+			
+			/**
+			 * The newest entry of each file, by device and inode.
+			 */
+			std::unordered_map<std::pair<uint64_t, uint64_t>, Location, FileHash> index;
+	};
+}
+
+#endif
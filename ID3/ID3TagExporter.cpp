@@ -0,0 +1,273 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <utility> //For std::pair
+
+#include "ID3TagExporter.hpp"             //For the class definition
+#include "ID3Functions.hpp"               //For hashBytes()
+#include "Frames/ID3TextFrame.hpp"        //For TextFrame and DescriptiveTextFrame
+#include "Frames/ID3PictureFrame.hpp"     //For PictureFrame
+#include "Frames/ID3PlayCountFrame.hpp"   //For PlayCountFrame and PopularimeterFrame
+#include "Frames/ID3EventTimingFrame.hpp" //For EventTimingFrame
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	const char HEX_DIGITS[] = "0123456789abcdef";
+	
+	const char BASE64_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	
+	/**
+	 * Check if a byte has to be escaped in a JSON string.
+	 */
+	inline bool needsEscape(const unsigned char byte) { return byte < 0x20 || byte == '"' || byte == '\\'; }
+}
+
+///@pkg ID3TagExporter.h
+TagExporter::TagExporter(std::ostream&        out,
+                         const ExportOptions& options,
+                         const size_t         flushSize) : output(out),
+                                                           binary(options.binary),
+                                                           frameIDs(options.frames.begin(), options.frames.end()),
+                                                           bufferLimit(flushSize),
+                                                           lines(0) {
+	buffer.reserve(bufferLimit + 64 * 1024);
+}
+
+///@pkg ID3TagExporter.h
+TagExporter::~TagExporter() { flush(); }
+
+///@pkg ID3TagExporter.h
+void TagExporter::add(const Tag& tag) { add(tag.filename, tag); }
+
+///@pkg ID3TagExporter.h
+void TagExporter::add(const std::string& fileLoc, const Tag& tag) {
+	appendRaw("{\"path\":");
+	appendString(fileLoc);
+	appendRaw(",\"frames\":{");
+	
+	//Frames with the same ID are next to each other in the map, and are
+	//grouped into one array if the frame allows more than one
+	const FrameID* previousID = nullptr;
+	bool inArray = false;
+	for(const auto& framePair : tag.frames) {
+		const Frame* const frame = framePair.second.get();
+		if(frame == nullptr || frame->null() || frame->empty()) continue;
+		if(!frameIDs.empty() && frameIDs.count(framePair.first) == 0) continue;
+		
+		if(previousID != nullptr && *previousID == framePair.first) {
+			//Only the first of several frames that don't allow more than one is kept
+			if(!inArray) continue;
+			buffer.push_back(',');
+		} else {
+			if(inArray) buffer.push_back(']');
+			if(previousID != nullptr) buffer.push_back(',');
+			appendString(static_cast<const std::string&>(framePair.first));
+			buffer.push_back(':');
+			inArray = framePair.first.allowsMultiple();
+			if(inArray) buffer.push_back('[');
+			previousID = &framePair.first;
+		}
+		appendFrame(*frame);
+	}
+	if(inArray) buffer.push_back(']');
+	appendRaw("}}\n");
+	endLine();
+}
+
+///@pkg ID3TagExporter.h
+void TagExporter::add(const std::string& fileLoc, const ErrorCode error) {
+	appendRaw("{\"path\":");
+	appendString(fileLoc);
+	appendRaw(",\"error\":");
+	const char* const ERROR_STRING = errorString(error);
+	appendString(ERROR_STRING, std::char_traits<char>::length(ERROR_STRING));
+	appendRaw("}\n");
+	endLine();
+}
+
+///@pkg ID3TagExporter.h
+void TagExporter::flush() {
+	output.write(buffer.data(), buffer.size());
+	output.flush();
+	buffer.clear();
+}
+
+///@pkg ID3TagExporter.h
+size_t TagExporter::size() const { return lines; }
+
+///@pkg ID3TagExporter.h
+void TagExporter::endLine() {
+	lines++;
+	if(buffer.size() >= bufferLimit) {
+		output.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+}
+
+///@pkg ID3TagExporter.h
+void TagExporter::appendFrame(const Frame& frame) {
+	buffer.push_back('{');
+	switch(frame.type()) {
+		case FrameClass::CLASS_DESCRIPTIVE: {
+			const DescriptiveTextFrame& textFrame = dynamic_cast<const DescriptiveTextFrame&>(frame);
+			appendRaw("\"description\":");
+			appendString(textFrame.descriptionView());
+			if(textFrame.languageView().size() > 0) {
+				appendRaw(",\"language\":");
+				appendString(textFrame.languageView());
+			}
+			appendRaw(",\"text\":");
+			appendString(textFrame.contentView());
+			break;
+		}
+		case FrameClass::CLASS_TEXT:
+		case FrameClass::CLASS_NUMERICAL:
+		case FrameClass::CLASS_URL: {
+			appendRaw("\"text\":");
+			appendString(dynamic_cast<const TextFrame&>(frame).contentView());
+			break;
+		}
+		case FrameClass::CLASS_PICTURE: {
+			const PictureFrame& pictureFrame = dynamic_cast<const PictureFrame&>(frame);
+			appendRaw("\"mime\":");
+			appendString(pictureFrame.mimeTypeView());
+			appendRaw(",\"type\":");
+			appendNumber(static_cast<uint64_t>(pictureFrame.pictureType()));
+			appendRaw(",\"description\":");
+			appendString(pictureFrame.descriptionView());
+			const PictureData picture = pictureFrame.picture();
+			buffer.push_back(',');
+			if(!appendBinary(picture.bytes().data(), picture.bytes().size(), picture.hash()))
+				buffer.pop_back();
+			break;
+		}
+		case FrameClass::CLASS_POPULARIMETER: {
+			const PopularimeterFrame& popularimeterFrame = dynamic_cast<const PopularimeterFrame&>(frame);
+			appendRaw("\"email\":");
+			appendString(popularimeterFrame.emailView());
+			appendRaw(",\"rating\":");
+			appendNumber(popularimeterFrame.rating());
+			appendRaw(",\"count\":");
+			appendNumber(popularimeterFrame.playCount());
+			break;
+		}
+		case FrameClass::CLASS_PLAY_COUNT: {
+			appendRaw("\"count\":");
+			appendNumber(dynamic_cast<const PlayCountFrame&>(frame).playCount());
+			break;
+		}
+		case FrameClass::CLASS_EVENT_TIMING: {
+			const EventTimingFrame& timingFrame = dynamic_cast<const EventTimingFrame&>(frame);
+			appendRaw("\"format\":");
+			appendNumber(static_cast<uint64_t>(timingFrame.format()));
+			appendRaw(",\"codes\":[");
+			bool firstCode = true;
+			for(const std::pair<TimingCodes, ulong>& event : timingFrame.events()) {
+				if(!firstCode) buffer.push_back(',');
+				buffer.push_back('[');
+				appendNumber(static_cast<uint64_t>(event.first));
+				buffer.push_back(',');
+				appendNumber(event.second);
+				buffer.push_back(']');
+				firstCode = false;
+			}
+			buffer.push_back(']');
+			break;
+		}
+		case FrameClass::CLASS_UNKNOWN:
+		default: {
+			if(binary == BinaryExport::OMIT) break;
+			const UnknownFrame* const unknownFrame = dynamic_cast<const UnknownFrame*>(&frame);
+			if(unknownFrame == nullptr) break;
+			//Read the body in place, as the frame bytes would be a copy
+			const uint8_t* const body = unknownFrame->bodyData();
+			const size_t BODY_SIZE = unknownFrame->bodySize();
+			appendBinary(body, BODY_SIZE, binary == BinaryExport::HASH ? hashBytes(body, BODY_SIZE) : 0);
+		}
+	}
+	buffer.push_back('}');
+}
+
+///@pkg ID3TagExporter.h
+bool TagExporter::appendBinary(const uint8_t* const bytes, const size_t size, const uint64_t hash) {
+	if(binary == BinaryExport::HASH) {
+		appendRaw("\"hash\":\"");
+		for(int shift = 60; shift >= 0; shift -= 4)
+			buffer.push_back(HEX_DIGITS[(hash >> shift) & 0xF]);
+		buffer.push_back('"');
+		return true;
+	}
+	if(binary != BinaryExport::BASE64) return false;
+	
+	appendRaw("\"data\":\"");
+	const size_t START = buffer.size();
+	buffer.resize(START + (size + 2) / 3 * 4);
+	char* out = &buffer[START];
+	size_t pos = 0;
+	for(; pos + 3 <= size; pos += 3) {
+		const uint32_t GROUP = bytes[pos] << 16 | bytes[pos + 1] << 8 | bytes[pos + 2];
+		*out++ = BASE64_DIGITS[GROUP >> 18];
+		*out++ = BASE64_DIGITS[(GROUP >> 12) & 0x3F];
+		*out++ = BASE64_DIGITS[(GROUP >> 6) & 0x3F];
+		*out++ = BASE64_DIGITS[GROUP & 0x3F];
+	}
+	if(pos < size) {
+		const uint32_t GROUP = bytes[pos] << 16 | (pos + 1 < size ? bytes[pos + 1] << 8 : 0);
+		*out++ = BASE64_DIGITS[GROUP >> 18];
+		*out++ = BASE64_DIGITS[(GROUP >> 12) & 0x3F];
+		*out++ = pos + 1 < size ? BASE64_DIGITS[(GROUP >> 6) & 0x3F] : '=';
+		*out++ = '=';
+	}
+	buffer.push_back('"');
+	return true;
+}
+
+///@pkg ID3TagExporter.h
+void TagExporter::appendString(const char* const text, const size_t size) {
+	buffer.push_back('"');
+	size_t runStart = 0;
+	for(size_t i = 0; i < size; i++) {
+		const unsigned char BYTE = text[i];
+		if(!needsEscape(BYTE)) continue;
+		
+		//Copy the run of characters that don't need escaping at once
+		buffer.append(text + runStart, i - runStart);
+		runStart = i + 1;
+		buffer.push_back('\\');
+		switch(BYTE) {
+			case '"':  buffer.push_back('"');  break;
+			case '\\': buffer.push_back('\\'); break;
+			case '\n': buffer.push_back('n');  break;
+			case '\r': buffer.push_back('r');  break;
+			case '\t': buffer.push_back('t');  break;
+			default:
+				appendRaw("u00");
+				buffer.push_back(HEX_DIGITS[BYTE >> 4]);
+				buffer.push_back(HEX_DIGITS[BYTE & 0xF]);
+		}
+	}
+	buffer.append(text + runStart, size - runStart);
+	buffer.push_back('"');
+}
+
+///@pkg ID3TagExporter.h
+void TagExporter::appendNumber(uint64_t number) {
+	char digits[20];
+	char* start = digits + sizeof(digits);
+	do {
+		*--start = '0' + number % 10;
+		number /= 10;
+	} while(number > 0);
+	buffer.append(start, digits + sizeof(digits) - start);
+}
@@ -0,0 +1,226 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_TAG_EXPORTER_HPP
+#define ID3_TAG_EXPORTER_HPP
+
+#include <string>        //For std::string
+#include <vector>        //For std::vector
+#include <unordered_set> //For std::unordered_set
+#include <ostream>       //For std::ostream
+#include <cstdint>       //For uint8_t and uint64_t
+
+#include "ID3.hpp"          //For Tag
+#include "ID3Exception.hpp" //For ErrorCode
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * An enum of the ways a TagExporter writes binary data, which is the
+	 * image of picture frames and the body of unknown frames.
+	 */
+	enum class BinaryExport : uint8_t {
+		OMIT,   //Binary data is left out
+		BASE64, //Binary data is written in base64
+		HASH    //Only the XXH64 hash of binary data is written, in hexadecimal,
+		        //so that artwork can be matched without exporting it (the default)
+	};
+	
+	/**
+	 * ExportOptions chooses what a TagExporter writes.
+	 * 
+	 * @see ID3::TagExporter
+	 */
+	struct ExportOptions {
+		/**
+		 * The frames to export. If it's empty, every frame is exported.
+		 */
+		std::vector<FrameID> frames;
+		
+		/**
+		 * How binary data is written.
+		 */
+		BinaryExport binary = BinaryExport::HASH;
+	};
+	
+	/**
+	 * TagExporter writes tags to a stream as NDJSON, one JSON object per file
+	 * per line, for exporting the tags of a whole library. The JSON is written
+	 * straight from the frames into one output buffer that is reused for
+	 * every file, and the buffer is written to the stream once it's full.
+	 * 
+	 * Each line has the file's "path", and either its "frames" or, for a file
+	 * that couldn't be read, its "error". The frames are an object keyed by
+	 * frame ID. Frames that the ID3v2 standard allows more than one of, such
+	 * as TXXX, COMM, and APIC, are arrays of objects, and the rest are
+	 * objects. The fields of a frame object depend on the frame class:
+	 * 
+	 *     Text and URL frames:   "text"
+	 *     Descriptive frames:    "description", "language", and "text"
+	 *     Picture frames:        "mime", "type", "description", and "hash"
+	 *                            or "data"
+	 *     Play count frames:     "count"
+	 *     Popularimeter frames:  "email", "rating", and "count"
+	 *     Event timing frames:   "format" and "codes", an array of
+	 *                            [code, value] pairs
+	 *     Unknown frames:        "hash" or "data"
+	 * 
+	 * For example:
+	 * 
+	 *     {"path":"a.mp3","frames":{"TIT2":{"text":"Title"},"APIC":[{"mime":"image/jpeg","type":3,"description":"","hash":"9f2e..."}]}}
+	 * 
+	 * NOTE: The frames are written in the order they are kept in the Tag,
+	 *       which isn't sorted.
+	 */
+	class TagExporter {
+		public:
+			/**
+			 * Create an exporter.
+			 * 
+			 * @param out       The stream to write to.
+			 * @param options   What to export (optional).
+			 * @param flushSize How big the buffer gets before it's written to the
+			 *                  stream, in bytes (optional, defaults to 1 MiB).
+			 */
+			explicit TagExporter(std::ostream&        out,
+			                     const ExportOptions& options=ExportOptions(),
+			                     const size_t         flushSize=1024 * 1024);
+			
+			/**
+			 * The destructor, which writes what's left in the buffer.
+			 */
+			~TagExporter();
+			
+			TagExporter(const TagExporter&) = delete;
+			TagExporter& operator=(const TagExporter&) = delete;
+			
+			/**
+			 * Export a file's tags, with the Tag's file name as the path.
+			 * 
+			 * @param tag The Tag.
+			 * @see ID3::Tag::fileName()
+			 */
+			void add(const Tag& tag);
+			
+			/**
+			 * Export a file's tags.
+			 * 
+			 * @param fileLoc The path of the file.
+			 * @param tag     The Tag.
+			 */
+			void add(const std::string& fileLoc, const Tag& tag);
+			
+			/**
+			 * Export a file that couldn't be read, such as a failed
+			 * ID3::Tag::open() while scanning.
+			 * 
+			 * @param fileLoc The path of the file.
+			 * @param error   The ErrorCode of the file.
+			 */
+			void add(const std::string& fileLoc, const ErrorCode error);
+			
+			/**
+			 * Write the buffer to the stream, and flush the stream.
+			 */
+			void flush();
+			
+			/**
+			 * @return The number of lines exported.
+			 */
+			size_t size() const;
+		
+		private:
+			/**
+			 * Write the buffer to the stream if it's full.
+			 */
+			void endLine();
+			
+			/**
+			 * Append a frame as a JSON object.
+			 * 
+			 * @param frame The frame.
+			 */
+			void appendFrame(const Frame& frame);
+			
+			/**
+			 * Append binary data as a "hash" or "data" field, or nothing if
+			 * binary data is omitted.
+			 * 
+			 * @param bytes The bytes.
+			 * @param size  The number of bytes.
+			 * @param hash  The hash of the bytes.
+			 * @return true if a field was appended, false otherwise.
+			 */
+			bool appendBinary(const uint8_t* bytes, const size_t size, const uint64_t hash);
+			
+			/**
+			 * Append a string as a quoted JSON string.
+			 * 
+			 * @param text The UTF-8 string.
+			 * @param size The string size in bytes.
+			 */
+			void appendString(const char* text, const size_t size);
+			inline void appendString(const StringView& text) { appendString(text.data(), text.size()); }
+			inline void appendString(const std::string& text) { appendString(text.data(), text.size()); }
+			
+			/**
+			 * Append a number in decimal.
+			 * 
+			 * @param number The number.
+			 */
+			void appendNumber(uint64_t number);
+			
+			/**
+			 * Append characters that don't need escaping.
+			 * 
+			 * @param text The characters, which must be a string literal.
+			 */
+			template<size_t N> inline void appendRaw(const char (&text)[N]) { buffer.append(text, N - 1); }
+			
+			/**
+			 * The stream to write to.
+			 */
+			std::ostream& output;
+			
+			/**
+			 * How binary data is written.
+			 */
+			BinaryExport binary;
+			
+			/**
+			 * The frames to export, or empty to export every frame.
+			 */
+			std::unordered_set<FrameID> frameIDs;
+			
+			/**
+			 * The output buffer, and how big it gets before it's written.
+			 */
+			std::string buffer;
+			size_t bufferLimit;
+			
+			/**
+			 * The number of lines exported.
+			 */
+			size_t lines;
+	};
+}
+
+#endif
@@ -0,0 +1,390 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm> //For std::sort, std::lower_bound, std::inplace_merge, std::set_intersection, and std::remove_if
+#include <iterator>  //For std::back_inserter
+#include <utility>   //For std::move and std::make_pair
+#include <cstdint>   //For UINT32_MAX
+
+#include "ID3TagIndex.hpp"  //For the class definition
+#include "ID3Functions.hpp" //For V1::processGenre()
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * The rows returned when no rows match.
+	 */
+	const TagIndex::Rows NO_ROWS;
+	
+	/**
+	 * The string ID of strings that compact() drops.
+	 */
+	const uint32_t UNUSED_STRING = UINT32_MAX;
+	
+	/**
+	 * Add a row to a list of ascending rows, if it isn't in it already.
+	 */
+	void insertRow(TagIndex::Rows& rows, const TagIndex::Row row) {
+		const auto found = std::lower_bound(rows.begin(), rows.end(), row);
+		if(found == rows.end() || *found != row) rows.insert(found, row);
+	}
+	
+	/**
+	 * Remove a row from the list of ascending rows of a key, and remove the
+	 * key once it has no rows left.
+	 */
+	template<typename Key>
+	void eraseRow(std::unordered_map<Key, TagIndex::Rows>& rowMap, const Key key, const TagIndex::Row row) {
+		const auto rows = rowMap.find(key);
+		if(rows == rowMap.end()) return;
+		const auto found = std::lower_bound(rows->second.begin(), rows->second.end(), row);
+		if(found != rows->second.end() && *found == row) rows->second.erase(found);
+		if(rows->second.empty()) rowMap.erase(rows);
+	}
+	
+	/**
+	 * Move the lists of rows of a map to the new string IDs of their keys.
+	 */
+	template<typename Key, typename NewKey>
+	std::unordered_map<Key, TagIndex::Rows> remapRows(std::unordered_map<Key, TagIndex::Rows>& rowMap, NewKey newKey) {
+		std::unordered_map<Key, TagIndex::Rows> remapped;
+		remapped.reserve(rowMap.size());
+		for(auto& rows : rowMap)
+			remapped.emplace(newKey(rows.first), std::move(rows.second));
+		return remapped;
+	}
+}
+
+///@pkg ID3TagIndex.h
+TagIndex::Row TagIndex::add(const Tag& tag) { return add(tag.fileName(), tag); }
+
+///@pkg ID3TagIndex.h
+TagIndex::Row TagIndex::add(const std::string& fileLoc, const Tag& tag) {
+	Record record;
+	record.fields[static_cast<size_t>(IndexField::TITLE)]        = intern(tag.title());
+	record.fields[static_cast<size_t>(IndexField::ARTIST)]       = intern(tag.artist());
+	record.fields[static_cast<size_t>(IndexField::ALBUM_ARTIST)] = intern(tag.albumArtist());
+	record.fields[static_cast<size_t>(IndexField::ALBUM)]        = intern(tag.album());
+	record.fields[static_cast<size_t>(IndexField::GENRE)]        = intern(tag.genre());
+	record.fields[static_cast<size_t>(IndexField::YEAR)]         = intern(tag.year());
+	for(const Text& userText : tag.texts(FRAME_USER_DEFINED_TEXT))
+		record.userTexts.emplace_back(intern(userText.description), intern(userText.text));
+	return insert(fileLoc, record);
+}
+
+///@pkg ID3TagIndex.h
+TagIndex::Row TagIndex::add(const std::string& fileLoc, const TagCache::Entry& entry) {
+	//Take the first frame of each field, like the Tag getters do
+	static const FrameID FIELD_FRAMES[FIELDS] = {FRAME_TITLE, FRAME_ARTIST, FRAME_ALBUM_ARTIST,
+	                                             FRAME_ALBUM, FRAME_GENRE,  FRAME_YEAR};
+	const std::string* texts[FIELDS] = {};
+	const std::string* recordingTime = nullptr;
+	Record record;
+	for(const auto& field : entry.fields) {
+		if(field.first == FRAME_USER_DEFINED_TEXT) {
+			record.userTexts.emplace_back(intern(field.second.description), intern(field.second.text));
+		} else if(field.first == FRAME_RECORDING_TIME) {
+			if(recordingTime == nullptr) recordingTime = &field.second.text;
+		} else {
+			for(size_t i = 0; i < FIELDS; i++)
+				if(field.first == FIELD_FRAMES[i] && texts[i] == nullptr) texts[i] = &field.second.text;
+		}
+	}
+	
+	static const std::string EMPTY;
+	for(size_t i = 0; i < FIELDS; i++) {
+		const std::string& text = texts[i] == nullptr ? EMPTY : *texts[i];
+		if(i == static_cast<size_t>(IndexField::GENRE))
+			record.fields[i] = intern(V1::processGenre(text));
+		else if(i == static_cast<size_t>(IndexField::YEAR) && recordingTime != nullptr)
+			record.fields[i] = intern(recordingTime->substr(0, 4));
+		else
+			record.fields[i] = intern(text);
+	}
+	return insert(fileLoc, record);
+}
+
+///@pkg ID3TagIndex.h
+bool TagIndex::remove(const std::string& fileLoc) {
+	uint32_t pathID;
+	if(!lookup(fileLoc, pathID)) return false;
+	const auto found = paths.find(pathID);
+	if(found == paths.end()) return false;
+	
+	const Row row = found->second;
+	Record& record = records[row];
+	for(size_t i = 0; i < FIELDS; i++)
+		eraseRow(fieldRows[i], record.fields[i], row);
+	for(const auto& userText : record.userTexts) {
+		eraseRow(userTextRows, userTextKey(userText.first, userText.second), row);
+		eraseRow(userDescriptionRows, userText.first, row);
+	}
+	record.live = false;
+	record.userTexts.clear();
+	record.userTexts.shrink_to_fit();
+	paths.erase(found);
+	freeRows.push_back(row);
+	return true;
+}
+
+///@pkg ID3TagIndex.h
+bool TagIndex::find(const std::string& fileLoc, Row& row) const {
+	uint32_t pathID;
+	if(!lookup(fileLoc, pathID)) return false;
+	const auto found = paths.find(pathID);
+	if(found == paths.end()) return false;
+	row = found->second;
+	return true;
+}
+
+///@pkg ID3TagIndex.h
+size_t TagIndex::size() const { return paths.size(); }
+
+///@pkg ID3TagIndex.h
+TagIndex::Rows TagIndex::all() const {
+	Rows rows;
+	rows.reserve(paths.size());
+	for(Row row = 0; row < records.size(); row++)
+		if(records[row].live) rows.push_back(row);
+	return rows;
+}
+
+///@pkg ID3TagIndex.h
+StringView TagIndex::path(const Row row) const { return *strings[records[row].path]; }
+
+///@pkg ID3TagIndex.h
+StringView TagIndex::text(const IndexField field, const Row row) const {
+	return *strings[records[row].fields[static_cast<size_t>(field)]];
+}
+
+///@pkg ID3TagIndex.h
+StringView TagIndex::userText(const std::string& description, const Row row) const {
+	uint32_t descriptionID;
+	if(lookup(description, descriptionID))
+		for(const auto& userText : records[row].userTexts)
+			if(userText.first == descriptionID) return *strings[userText.second];
+	return StringView();
+}
+
+///@pkg ID3TagIndex.h
+const TagIndex::Rows& TagIndex::match(const IndexField field, const std::string& value) const {
+	uint32_t valueID;
+	if(!lookup(value, valueID)) return NO_ROWS;
+	const auto& rowMap = fieldRows[static_cast<size_t>(field)];
+	const auto found = rowMap.find(valueID);
+	return found == rowMap.end() ? NO_ROWS : found->second;
+}
+
+///@pkg ID3TagIndex.h
+TagIndex::Rows TagIndex::matchPrefix(const IndexField field, const std::string& prefix) const {
+	sortStrings();
+	const auto& rowMap = fieldRows[static_cast<size_t>(field)];
+	Rows rows;
+	
+	//The strings that start with the prefix are together in the sorted list
+	auto id = std::lower_bound(sortedStrings.begin(), sortedStrings.end(), prefix,
+	                           [this](const uint32_t stringID, const std::string& text) { return *strings[stringID] < text; });
+	for(; id != sortedStrings.end() && strings[*id]->compare(0, prefix.size(), prefix) == 0; id++) {
+		const auto found = rowMap.find(*id);
+		if(found != rowMap.end())
+			rows.insert(rows.end(), found->second.begin(), found->second.end());
+	}
+	
+	//Each row has one value per field, so the rows are only out of order
+	std::sort(rows.begin(), rows.end());
+	return rows;
+}
+
+///@pkg ID3TagIndex.h
+const TagIndex::Rows& TagIndex::matchUserText(const std::string& description, const std::string& value) const {
+	uint32_t descriptionID, valueID;
+	if(!lookup(description, descriptionID) || !lookup(value, valueID)) return NO_ROWS;
+	const auto found = userTextRows.find(userTextKey(descriptionID, valueID));
+	return found == userTextRows.end() ? NO_ROWS : found->second;
+}
+
+///@pkg ID3TagIndex.h
+const TagIndex::Rows& TagIndex::matchUserText(const std::string& description) const {
+	uint32_t descriptionID;
+	if(!lookup(description, descriptionID)) return NO_ROWS;
+	const auto found = userDescriptionRows.find(descriptionID);
+	return found == userDescriptionRows.end() ? NO_ROWS : found->second;
+}
+
+///@pkg ID3TagIndex.h
+void TagIndex::sort(Rows& rows, const IndexField field, const bool ascending) const {
+	sortStrings();
+	
+	//Sort by the rank of each row's value, kept next to the row
+	const size_t FIELD = static_cast<size_t>(field);
+	std::vector<std::pair<uint32_t, Row>> ranked;
+	ranked.reserve(rows.size());
+	for(const Row row : rows)
+		ranked.emplace_back(stringRanks[records[row].fields[FIELD]], row);
+	if(ascending)
+		std::stable_sort(ranked.begin(), ranked.end(), [](const std::pair<uint32_t, Row>& a, const std::pair<uint32_t, Row>& b) { return a.first < b.first; });
+	else
+		std::stable_sort(ranked.begin(), ranked.end(), [](const std::pair<uint32_t, Row>& a, const std::pair<uint32_t, Row>& b) { return a.first > b.first; });
+	for(size_t i = 0; i < rows.size(); i++)
+		rows[i] = ranked[i].second;
+}
+
+///@pkg ID3TagIndex.h
+std::vector<std::pair<StringView, size_t>> TagIndex::facet(const IndexField field, const Rows& rows) const {
+	sortStrings();
+	
+	const size_t FIELD = static_cast<size_t>(field);
+	std::unordered_map<uint32_t, size_t> counts;
+	for(const Row row : rows)
+		counts[records[row].fields[FIELD]]++;
+	std::vector<std::pair<uint32_t, uint32_t>> ranked; //Rank and string ID
+	ranked.reserve(counts.size());
+	for(const auto& count : counts)
+		ranked.emplace_back(stringRanks[count.first], count.first);
+	std::sort(ranked.begin(), ranked.end());
+	
+	std::vector<std::pair<StringView, size_t>> values;
+	values.reserve(ranked.size());
+	for(const auto& value : ranked)
+		values.emplace_back(*strings[value.second], counts[value.second]);
+	return values;
+}
+
+///@pkg ID3TagIndex.h
+void TagIndex::compact() {
+	//Find the strings the files still use, and give them new IDs in the
+	//same order as the old ones
+	std::vector<uint32_t> newIDs(strings.size(), UNUSED_STRING);
+	for(const Record& record : records) {
+		if(!record.live) continue;
+		newIDs[record.path] = 0;
+		for(size_t i = 0; i < FIELDS; i++)
+			newIDs[record.fields[i]] = 0;
+		for(const auto& userText : record.userTexts)
+			newIDs[userText.first] = newIDs[userText.second] = 0;
+	}
+	std::unordered_map<std::string, uint32_t> newStringIDs;
+	std::vector<const std::string*> newStrings;
+	for(uint32_t id = 0; id < strings.size(); id++) {
+		if(newIDs[id] == UNUSED_STRING) continue;
+		newIDs[id] = newStrings.size();
+		newStrings.push_back(&newStringIDs.emplace(*strings[id], newIDs[id]).first->first);
+	}
+	
+	//Move every ID over to the new ones
+	for(Record& record : records) {
+		if(!record.live) continue;
+		record.path = newIDs[record.path];
+		for(size_t i = 0; i < FIELDS; i++)
+			record.fields[i] = newIDs[record.fields[i]];
+		for(auto& userText : record.userTexts)
+			userText = std::make_pair(newIDs[userText.first], newIDs[userText.second]);
+	}
+	std::unordered_map<uint32_t, Row> newPaths;
+	newPaths.reserve(paths.size());
+	for(const auto& path : paths)
+		newPaths.emplace(newIDs[path.first], path.second);
+	paths.swap(newPaths);
+	const auto newID = [&newIDs](const uint32_t id) { return newIDs[id]; };
+	for(size_t i = 0; i < FIELDS; i++)
+		fieldRows[i] = remapRows(fieldRows[i], newID);
+	userDescriptionRows = remapRows(userDescriptionRows, newID);
+	userTextRows = remapRows(userTextRows, [&newIDs](const uint64_t key) {
+		return userTextKey(newIDs[key >> 32], newIDs[key & UINT32_MAX]);
+	});
+	
+	stringIDs.swap(newStringIDs);
+	strings.swap(newStrings);
+	sortedStrings.clear();
+	stringRanks.clear();
+	
+	//Drop the free rows at the end
+	while(!records.empty() && !records.back().live) records.pop_back();
+	freeRows.erase(std::remove_if(freeRows.begin(), freeRows.end(), [this](const Row row) { return row >= records.size(); }),
+	               freeRows.end());
+	records.shrink_to_fit();
+}
+
+///@pkg ID3TagIndex.h
+size_t TagIndex::stringCount() const { return strings.size(); }
+
+///@pkg ID3TagIndex.h
+TagIndex::Rows TagIndex::intersect(const Rows& first, const Rows& second) {
+	Rows rows;
+	std::set_intersection(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(rows));
+	return rows;
+}
+
+///@pkg ID3TagIndex.h
+uint32_t TagIndex::intern(const std::string& text) {
+	const auto inserted = stringIDs.emplace(text, strings.size());
+	if(inserted.second)
+		strings.push_back(&inserted.first->first);
+	return inserted.first->second;
+}
+
+///@pkg ID3TagIndex.h
+bool TagIndex::lookup(const std::string& text, uint32_t& id) const {
+	const auto found = stringIDs.find(text);
+	if(found == stringIDs.end()) return false;
+	id = found->second;
+	return true;
+}
+
+///@pkg ID3TagIndex.h
+TagIndex::Row TagIndex::insert(const std::string& fileLoc, Record& record) {
+	remove(fileLoc);
+	
+	//A file can have the same user-defined text frame more than once
+	std::sort(record.userTexts.begin(), record.userTexts.end());
+	record.userTexts.erase(std::unique(record.userTexts.begin(), record.userTexts.end()), record.userTexts.end());
+	
+	//Reuse the row of a removed file if there is one. The lists of rows are
+	//kept in order, which for a new row only means adding it to the end.
+	Row row;
+	if(freeRows.empty()) {
+		row = records.size();
+		records.emplace_back();
+	} else {
+		row = freeRows.back();
+		freeRows.pop_back();
+	}
+	record.path = intern(fileLoc);
+	for(size_t i = 0; i < FIELDS; i++)
+		insertRow(fieldRows[i][record.fields[i]], row);
+	for(const auto& userText : record.userTexts) {
+		insertRow(userTextRows[userTextKey(userText.first, userText.second)], row);
+		insertRow(userDescriptionRows[userText.first], row);
+	}
+	paths[record.path] = row;
+	records[row] = std::move(record);
+	return row;
+}
+
+///@pkg ID3TagIndex.h
+void TagIndex::sortStrings() const {
+	const size_t SORTED = sortedStrings.size();
+	if(SORTED == strings.size()) return;
+	
+	//Sort the new strings, and merge them into the sorted ones
+	const auto byText = [this](const uint32_t a, const uint32_t b) { return *strings[a] < *strings[b]; };
+	for(uint32_t id = SORTED; id < strings.size(); id++)
+		sortedStrings.push_back(id);
+	std::sort(sortedStrings.begin() + SORTED, sortedStrings.end(), byText);
+	std::inplace_merge(sortedStrings.begin(), sortedStrings.begin() + SORTED, sortedStrings.end(), byText);
+	
+	stringRanks.resize(strings.size());
+	for(uint32_t rank = 0; rank < sortedStrings.size(); rank++)
+		stringRanks[sortedStrings[rank]] = rank;
+}
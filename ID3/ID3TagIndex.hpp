@@ -0,0 +1,345 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_TAG_INDEX_HPP
+#define ID3_TAG_INDEX_HPP
+
+#include <string>        //For std::string
+#include <vector>        //For std::vector
+#include <unordered_map> //For std::unordered_map
+#include <utility>       //For std::pair
+#include <cstdint>       //For uint32_t and uint64_t
+
+#include "ID3.hpp"           //For Tag
+#include "ID3TagCache.hpp"   //For TagCache::Entry
+#include "ID3StringView.hpp" //For StringView
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * The fields a TagIndex indexes.
+	 * 
+	 * @see ID3::TagIndex
+	 */
+	enum class IndexField : uint8_t {
+		TITLE,
+		ARTIST,
+		ALBUM_ARTIST,
+		ALBUM,
+		GENRE,
+		YEAR
+	};
+	
+	/**
+	 * TagIndex holds the common fields of many files' tags, and indexes them
+	 * so that the files can be filtered, sorted, and counted by their fields
+	 * without looking at every file. User-defined text (TXXX) frames are
+	 * indexed by their descriptions.
+	 * 
+	 * Each file is a row, numbered in the order the files were added. A row's
+	 * number doesn't change until the file is removed, after which it can be
+	 * reused by a file that is added. Queries return rows in ascending order,
+	 * so that the results of two queries can be combined with intersect().
+	 * 
+	 * Every string is stored only once no matter how many files or fields
+	 * have it, and strings are returned as views into the index, which are
+	 * valid until compact() is called or the TagIndex is destroyed. The
+	 * strings of removed and replaced files are kept until compact().
+	 * 
+	 * NOTE: Sorting and prefix queries keep a sorted list of the strings,
+	 *       which is brought up to date after strings are added. A TagIndex
+	 *       must not be used by more than one thread at once.
+	 */
+	class TagIndex {
+		public:
+			/**
+			 * A row number.
+			 */
+			typedef uint32_t Row;
+			
+			/**
+			 * A list of rows.
+			 */
+			typedef std::vector<Row> Rows;
+			
+			/**
+			 * Add a file to the index, with the Tag's file name as the path. If a
+			 * file with the same path is already in the index, it is replaced.
+			 * 
+			 * @param tag The Tag.
+			 * @return The file's row.
+			 * @see ID3::Tag::fileName()
+			 */
+			Row add(const Tag& tag);
+			
+			/**
+			 * Add a file to the index. If a file with the same path is already in
+			 * the index, it is replaced.
+			 * 
+			 * @param fileLoc The path of the file.
+			 * @param tag     The Tag.
+			 * @return The file's row.
+			 */
+			Row add(const std::string& fileLoc, const Tag& tag);
+			
+			/**
+			 * Add a file to the index from its TagCache entry, without reading
+			 * the file. If a file with the same path is already in the index, it
+			 * is replaced.
+			 * 
+			 * @param fileLoc The path of the file.
+			 * @param entry   The file's entry from ID3::TagCache::find().
+			 * @return The file's row.
+			 */
+			Row add(const std::string& fileLoc, const TagCache::Entry& entry);
+			
+			/**
+			 * Remove a file from the index.
+			 * 
+			 * @param fileLoc The path of the file.
+			 * @return true if the file was in the index, false otherwise.
+			 */
+			bool remove(const std::string& fileLoc);
+			
+			/**
+			 * Find the row of a file.
+			 * 
+			 * @param fileLoc The path of the file.
+			 * @param row     Where to put the row. It is only changed if found.
+			 * @return true if the file is in the index, false otherwise.
+			 */
+			bool find(const std::string& fileLoc, Row& row) const;
+			
+			/**
+			 * @return The number of files in the index.
+			 */
+			size_t size() const;
+			
+			/**
+			 * @return Every row in the index.
+			 */
+			Rows all() const;
+			
+			/**
+			 * @param row A row.
+			 * @return The file path of the row.
+			 */
+			StringView path(const Row row) const;
+			
+			/**
+			 * @param field The field.
+			 * @param row   A row.
+			 * @return The field's text in the row, or an empty view if it isn't set.
+			 */
+			StringView text(const IndexField field, const Row row) const;
+			
+			/**
+			 * @param description The description of the user-defined text frame.
+			 * @param row         A row.
+			 * @return The text of the row's user-defined text frame with the
+			 *         description, or an empty view if there is none.
+			 */
+			StringView userText(const std::string& description, const Row row) const;
+			
+			/**
+			 * Get the rows where a field is a value. The rows are kept by the
+			 * index, so this doesn't copy them.
+			 * 
+			 * @param field The field.
+			 * @param value The value. An empty string matches rows without the field.
+			 * @return The rows.
+			 */
+			const Rows& match(const IndexField field, const std::string& value) const;
+			
+			/**
+			 * Get the rows where a field starts with some text.
+			 * 
+			 * @param field  The field.
+			 * @param prefix The start of the value.
+			 * @return The rows.
+			 */
+			Rows matchPrefix(const IndexField field, const std::string& prefix) const;
+			
+			/**
+			 * Get the rows that have a user-defined text frame with a description
+			 * and value.
+			 * 
+			 * @param description The user-defined text frame's description.
+			 * @param value       The user-defined text frame's text.
+			 * @return The rows.
+			 */
+			const Rows& matchUserText(const std::string& description, const std::string& value) const;
+			
+			/**
+			 * Get the rows that have a user-defined text frame with a description.
+			 * 
+			 * @param description The user-defined text frame's description.
+			 * @return The rows.
+			 */
+			const Rows& matchUserText(const std::string& description) const;
+			
+			/**
+			 * Sort rows by a field. Rows with the same value keep their order.
+			 * 
+			 * @param rows      The rows to sort.
+			 * @param field     The field to sort by.
+			 * @param ascending Whether to sort in ascending order (optional,
+			 *                  defaults to true).
+			 */
+			void sort(Rows& rows, const IndexField field, const bool ascending=true) const;
+			
+			/**
+			 * Count how many of some rows have each value of a field.
+			 * 
+			 * @param field The field.
+			 * @param rows  The rows to count.
+			 * @return Each value of the field and its count, sorted by value.
+			 */
+			std::vector<std::pair<StringView, size_t>> facet(const IndexField field, const Rows& rows) const;
+			
+			/**
+			 * Drop the strings that no file uses anymore. Removing and replacing
+			 * files doesn't drop the strings they used, so an index that is kept
+			 * up to date for a long time, such as by a LibraryWatcher, should be
+			 * compacted once stringCount() has grown well past what it was after
+			 * the files were first added.
+			 * 
+			 * NOTE: Every StringView returned by the index is invalidated. Rows
+			 *       don't change.
+			 */
+			void compact();
+			
+			/**
+			 * @return The number of strings stored, including those compact()
+			 *         would drop.
+			 */
+			size_t stringCount() const;
+			
+			/**
+			 * Get the rows that are in both of two lists of ascending rows.
+			 * 
+			 * @param first  The first rows.
+			 * @param second The second rows.
+			 * @return The rows in both.
+			 */
+			static Rows intersect(const Rows& first, const Rows& second);
+		
+		private:
+			/**
+			 * The number of indexed fields.
+			 */
+			static const size_t FIELDS = static_cast<size_t>(IndexField::YEAR) + 1;
+			
+			/**
+			 * The string IDs of a file's fields.
+			 */
+			struct Record {
+				bool live = true;
+				uint32_t path;
+				uint32_t fields[FIELDS];
+				std::vector<std::pair<uint32_t, uint32_t>> userTexts; //Description and text
+			};
+			
+			/**
+			 * Get the ID of a string, adding it if it's new.
+			 * 
+			 * @param text The string.
+			 * @return The string's ID.
+			 */
+			uint32_t intern(const std::string& text);
+			
+			/**
+			 * Get the ID of a string that's already in the index.
+			 * 
+			 * @param text The string.
+			 * @param id   Where to put the ID. It is only changed if found.
+			 * @return true if the string is in the index, false otherwise.
+			 */
+			bool lookup(const std::string& text, uint32_t& id) const;
+			
+			/**
+			 * Replace the file with a path with a new record, and index it.
+			 * 
+			 * @param fileLoc The path of the file.
+			 * @param record  The new record, without its path.
+			 * @return The file's row.
+			 */
+			Row insert(const std::string& fileLoc, Record& record);
+			
+			/**
+			 * Bring the sorted list of strings and their ranks up to date.
+			 */
+			void sortStrings() const;
+			
+			/**
+			 * Get the key of a user-defined text frame in userTextRows.
+			 */
+			static inline uint64_t userTextKey(const uint32_t description, const uint32_t text) {
+				return static_cast<uint64_t>(description) << 32 | text;
+			}
+			
+			/**
+			 * The ID of each string.
+			 */
+			std::unordered_map<std::string, uint32_t> stringIDs;
+			
+			/**
+			 * Every string, by ID. They point to the keys of stringIDs.
+			 */
+			std::vector<const std::string*> strings;
+			
+			/**
+			 * The string IDs sorted by their strings, and the rank of each string
+			 * ID in that order.
+			 */
+			mutable std::vector<uint32_t> sortedStrings;
+			mutable std::vector<uint32_t> stringRanks;
+			
+			/**
+			 * Every file, by row.
+			 */
+			std::vector<Record> records;
+			
+			/**
+			 * The rows of removed files, which are reused by files that are added.
+			 */
+			std::vector<Row> freeRows;
+			
+			/**
+			 * The row of each file, by path string ID.
+			 */
+			std::unordered_map<uint32_t, Row> paths;
+			
+			/**
+			 * The rows of each field value, by field and value string ID.
+			 */
+			std::unordered_map<uint32_t, Rows> fieldRows[FIELDS];
+			
+			/**
+			 * The rows of each user-defined text frame, by description and text,
+			 * and by description alone.
+			 */
+			std::unordered_map<uint64_t, Rows> userTextRows;
+			std::unordered_map<uint32_t, Rows> userDescriptionRows;
+	};
+}
+
+#endif
@@ -0,0 +1,171 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#include <algorithm>  //For std::min
+#include <fcntl.h>    //For open() and sync_file_range()
+#include <sys/stat.h> //For stat()
+#include <unistd.h>   //For fdatasync(), syncfs(), and close()
+
+#include "ID3WriteSession.hpp" //For the class definition
+
+using namespace ID3;
+
+//Private namespace
+namespace {
+	/**
+	 * How many files are kept open at once while they're synced.
+	 */
+	const size_t SYNC_BATCH_SIZE = 256;
+	
+	/**
+	 * fdatasync() a file.
+	 * 
+	 * @param fileLoc The file path.
+	 * @return ErrorCode::NONE if the file was synced, ErrorCode::FILE_NOT_FOUND
+	 *         if it couldn't be opened, or ErrorCode::WRITE if the sync failed.
+	 */
+	ErrorCode syncFile(const std::string& fileLoc) {
+		const int fd = ::open(fileLoc.c_str(), O_RDONLY | O_CLOEXEC);
+		if(fd < 0) return ErrorCode::FILE_NOT_FOUND;
+		const ErrorCode error = fdatasync(fd) == 0 ? ErrorCode::NONE : ErrorCode::WRITE;
+		::close(fd);
+		return error;
+	}
+}
+
+///@pkg ID3WriteSession.h
+WriteSession::WriteSession(const SyncMethod method) : syncMethod(method) {}
+
+///@pkg ID3WriteSession.h
+WriteSession::~WriteSession() {
+	try {
+		commit();
+	} catch(...) {}
+}
+
+///@pkg ID3WriteSession.h
+ErrorCode WriteSession::write(Tag&               tag,
+                              const std::string& fileLoc,
+                              const float        paddingFactor,
+                              const bool         discardNonCoverPictures,
+                              const bool         discardUnknown,
+                              const bool         addTaggingTime) {
+	ErrorCode error = tag.tryWrite(fileLoc, paddingFactor, true, discardNonCoverPictures, discardUnknown, addTaggingTime);
+	
+	//A rewritten file is truncated before its tags and audio are written back,
+	//so a crash before its data is on disk can lose the audio. It's synced
+	//now instead of waiting for commit().
+	if(error == ErrorCode::NONE && tag.rewritten())
+		error = syncFile(fileLoc);
+	record(fileLoc, error);
+	return error;
+}
+
+///@pkg ID3WriteSession.h
+void WriteSession::add(const std::string& fileLoc) { record(fileLoc, ErrorCode::NONE); }
+
+///@pkg ID3WriteSession.h
+std::vector<SyncResult> WriteSession::commit() {
+	//Take the files, so that more can be written while these are synced
+	std::vector<SyncResult> results;
+	{
+		std::lock_guard<std::mutex> lock(filesMutex);
+		results.swap(files);
+		fileIndex.clear();
+	}
+	
+	if(syncMethod == SyncMethod::SYNCFS)
+		syncFileSystems(results);
+	else
+		syncFiles(results);
+	return results;
+}
+
+///@pkg ID3WriteSession.h
+size_t WriteSession::pending() const {
+	std::lock_guard<std::mutex> lock(filesMutex);
+	return files.size();
+}
+
+///@pkg ID3WriteSession.h
+void WriteSession::record(const std::string& fileLoc, const ErrorCode error) {
+	std::lock_guard<std::mutex> lock(filesMutex);
+	const auto inserted = fileIndex.emplace(fileLoc, files.size());
+	if(inserted.second) {
+		files.emplace_back();
+		files.back().path = fileLoc;
+	}
+	files[inserted.first->second].error = error;
+}
+
+///@pkg ID3WriteSession.h
+void WriteSession::syncFiles(std::vector<SyncResult>& results) {
+	std::vector<int> fds;
+	for(size_t start = 0; start < results.size(); start += SYNC_BATCH_SIZE) {
+		const size_t END = std::min(start + SYNC_BATCH_SIZE, results.size());
+		fds.assign(END - start, -1);
+		
+		//Start writing every file to disk, so the disk has all of them
+		//queued at once instead of one at a time
+		for(size_t i = start; i < END; i++) {
+			if(results[i].error != ErrorCode::NONE) continue;
+			const int fd = ::open(results[i].path.c_str(), O_RDONLY | O_CLOEXEC);
+			if(fd < 0) {
+				results[i].error = ErrorCode::FILE_NOT_FOUND;
+				continue;
+			}
+			sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+			fds[i - start] = fd;
+		}
+		
+		//Then wait for each file, which is mostly written by the time it's
+		//reached. fdatasync() also writes the metadata needed to read the
+		//data back, such as the size of a rewritten file.
+		for(size_t i = start; i < END; i++) {
+			const int fd = fds[i - start];
+			if(fd < 0) continue;
+			if(fdatasync(fd) == 0) results[i].durable = true;
+			else                   results[i].error = ErrorCode::WRITE;
+			::close(fd);
+		}
+	}
+}
+
+///@pkg ID3WriteSession.h
+void WriteSession::syncFileSystems(std::vector<SyncResult>& results) {
+	//Group the files by the file system they're on
+	std::unordered_map<dev_t, std::vector<size_t>> fileSystems;
+	for(size_t i = 0; i < results.size(); i++) {
+		if(results[i].error != ErrorCode::NONE) continue;
+		struct stat info;
+		if(stat(results[i].path.c_str(), &info) != 0)
+			results[i].error = ErrorCode::FILE_NOT_FOUND;
+		else
+			fileSystems[info.st_dev].push_back(i);
+	}
+	
+	for(const auto& fileSystem : fileSystems) {
+		//Any file on the file system can be used to sync it
+		bool synced = false;
+		for(const size_t i : fileSystem.second) {
+			const int fd = ::open(results[i].path.c_str(), O_RDONLY | O_CLOEXEC);
+			if(fd < 0) continue;
+			synced = syncfs(fd) == 0;
+			::close(fd);
+			break;
+		}
+		for(const size_t i : fileSystem.second) {
+			if(synced) results[i].durable = true;
+			else       results[i].error = ErrorCode::WRITE;
+		}
+	}
+}
@@ -0,0 +1,197 @@
+/***********************************************************************
+ * ID3-Tagging-Library Copyright (C) 2016 Gerard Godone-Maresca        *
+ * This library comes with ABSOLUTELY NO WARRANTY; for details open    *
+ * the document 'README.txt' found enclosed.                           *
+ * This is free software, and you are welcome to redistribute it under *
+ * certain conditions.                                                 *
+ *                                                                     *
+ * @author Gerard Godone-Maresca                                       *
+ * @copyright Gerard Godone-Maresca, 2016, GNU Public License v3       *
+ * @link https://github.com/ggodone-maresca/ID3-Tagging-Library        *
+ **********************************************************************/
+
+#ifndef ID3_WRITE_SESSION_HPP
+#define ID3_WRITE_SESSION_HPP
+
+#include <string>        //For std::string
+#include <vector>        //For std::vector
+#include <unordered_map> //For std::unordered_map
+#include <mutex>         //For std::mutex
+#include <cstdint>       //For uint8_t
+
+#include "ID3.hpp"          //For Tag
+#include "ID3Exception.hpp" //For ErrorCode
+
+/**
+ * The ID3 namespace defines everything related to reading and writing
+ * ID3 tags. The only supported versions for reading are ID3v1, ID3v1.1,
+ * ID3v1 Extended, ID3v2.3.0, and ID3v2.4.0.
+ * 
+ * ID3v2.3.0 standard: http://id3.org/id3v2.3.0
+ * ID3v2.4.0 standard: http://id3.org/id3v2.4.0-structure
+ * 
+ * @see ID3.h
+ */
+namespace ID3 {
+	/**
+	 * An enum of the ways a WriteSession makes its files durable.
+	 */
+	enum class SyncMethod : uint8_t {
+		FDATASYNC, //Start writing every file to disk, then fdatasync() each
+		           //one, so the waits overlap (the default)
+		SYNCFS     //syncfs() each file system the files are on once, which
+		           //also writes out every other file changed on them
+	};
+	
+	/**
+	 * Whether a file written in a WriteSession is durable.
+	 */
+	struct SyncResult {
+		/**
+		 * The file path.
+		 */
+		std::string path;
+		
+		/**
+		 * ErrorCode::NONE if the file is durable, or why it isn't: the error
+		 * of a write that failed, ErrorCode::FILE_NOT_FOUND if the file
+		 * couldn't be opened to sync it, or ErrorCode::WRITE if the sync
+		 * failed.
+		 */
+		ErrorCode error = ErrorCode::NONE;
+		
+		/**
+		 * Whether the file's new tags are on disk and survive a power failure.
+		 */
+		bool durable = false;
+	};
+	
+	/**
+	 * WriteSession writes the tags of many files without syncing each one,
+	 * and then makes them durable together with commit(). Syncing each file
+	 * as it's written waits for the disk once per file, and not syncing at
+	 * all can lose a whole batch of files on a power failure. A session
+	 * gets close to the speed of not syncing, and commit() is the point after
+	 * which every file it reports as durable is safe.
+	 * 
+	 * Files can be written on several threads at once into the same session,
+	 * and a file that is written more than once is only synced once.
+	 * 
+	 * NOTE: WriteSession uses sync_file_range() and syncfs(), so it's only
+	 *       available on Linux. A crash before commit() can leave a file
+	 *       whose tags were written over in place with its old tags, its new
+	 *       tags, or a damaged mix of the two, but its audio is untouched.
+	 *       A file whose tags didn't fit has to be rewritten whole, and is
+	 *       truncated first, which puts its audio at risk until it's synced,
+	 *       so write() syncs each such file as soon as it's written instead
+	 *       of waiting for commit(). The files keep their place in their
+	 *       directories, so the directories don't need to be synced.
+	 * 
+	 * @see ID3::BatchOptions::session
+	 */
+	class WriteSession {
+		public:
+			/**
+			 * Start a session.
+			 * 
+			 * @param method How commit() makes the files durable (optional,
+			 *               defaults to SyncMethod::FDATASYNC).
+			 */
+			explicit WriteSession(const SyncMethod method=SyncMethod::FDATASYNC);
+			
+			/**
+			 * The destructor, which commits the files that haven't been
+			 * committed.
+			 */
+			~WriteSession();
+			
+			WriteSession(const WriteSession&) = delete;
+			WriteSession& operator=(const WriteSession&) = delete;
+			
+			/**
+			 * Write a Tag to a file without syncing it, and add the file to the
+			 * session. A file whose write failed is reported by commit() as not
+			 * durable.
+			 * 
+			 * NOTE: A file that has to be rewritten whole is synced before this
+			 *       returns (see ID3::Tag::rewritten()).
+			 * 
+			 * @return The ErrorCode of the write.
+			 * @see ID3::Tag::tryWrite(std::string&, float, bool, bool, bool, bool)
+			 */
+			ErrorCode write(Tag&               tag,
+			                const std::string& fileLoc,
+			                const float        paddingFactor=0.1,
+			                const bool         discardNonCoverPictures=false,
+			                const bool         discardUnknown=false,
+			                const bool         addTaggingTime=true);
+			
+			/** @see ID3::WriteSession::write(Tag&, std::string&, float, bool, bool, bool) */
+			inline ErrorCode write(Tag& tag) { return write(tag, tag.fileName()); }
+			
+			/**
+			 * Add a file that was written some other way to the session.
+			 * 
+			 * NOTE: The file is only synced at commit(), so a file that was
+			 *       rewritten whole should be synced before it's added.
+			 * 
+			 * @param fileLoc The file path.
+			 */
+			void add(const std::string& fileLoc);
+			
+			/**
+			 * Make every file written since the last commit durable.
+			 * 
+			 * NOTE: With SyncMethod::SYNCFS, a file system that fails to write
+			 *       out any file makes every file on it not durable, and Linux
+			 *       kernels older than 5.8 don't report syncfs() errors.
+			 * 
+			 * @return Whether each file is durable, in the order they were added.
+			 */
+			std::vector<SyncResult> commit();
+			
+			/**
+			 * @return The number of files waiting to be committed.
+			 */
+			size_t pending() const;
+		
+		private:
+			/**
+			 * Add a file to the session, or update the ErrorCode of a file
+			 * that's already in it with the file's latest write.
+			 * 
+			 * @param fileLoc The file path.
+			 * @param error   The ErrorCode of the file's write.
+			 */
+			void record(const std::string& fileLoc, const ErrorCode error);
+			
+			/**
+			 * Sync the files with SyncMethod::FDATASYNC.
+			 * 
+			 * @param results The files, whose results are set.
+			 */
+			static void syncFiles(std::vector<SyncResult>& results);
+			
+			/**
+			 * Sync the files with SyncMethod::SYNCFS.
+			 * 
+			 * @param results The files, whose results are set.
+			 */
+			static void syncFileSystems(std::vector<SyncResult>& results);
+			
+			/**
+			 * How commit() makes the files durable.
+			 */
+			SyncMethod syncMethod;
+			
+			/**
+			 * The files waiting to be committed, the index of each file path in
+			 * it, and the lock for them.
+			 */
+			std::vector<SyncResult> files;
+			std::unordered_map<std::string, size_t> fileIndex;
+			mutable std::mutex filesMutex;
+	};
+}
+
+#endif